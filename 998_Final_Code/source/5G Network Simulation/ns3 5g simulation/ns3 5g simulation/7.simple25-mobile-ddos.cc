@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <set>
 #include "ns3/netanim-module.h"
+#include "nr_beam_throttle.h"
 
 using namespace ns3;
 
@@ -37,8 +38,20 @@ main(int argc, char* argv[])
     Time packetInterval = Seconds(0.01); // 100 packets/sec
     Time AttackpacketInterval = Seconds(0.0001);
 
+    // Beamforming update policy (see nr_beam_throttle.h)
+    std::string bfPolicy = "always";
+    Time bfPeriod = MilliSeconds(500);
+    double bfMinDisplacement = 1.0;
+    double bfMinAngle = 2.0;
+    uint32_t bfAudit = 0;
+
     CommandLine cmd;
     cmd.AddValue("simTime", "Simulation time", simTime);
+    cmd.AddValue("bfPolicy", "Beamforming update policy: always|period|displacement|angle", bfPolicy);
+    cmd.AddValue("bfPeriod", "Minimum time between beamforming updates (period)", bfPeriod);
+    cmd.AddValue("bfMinDisplacement", "UE movement in metres that triggers an update (displacement)", bfMinDisplacement);
+    cmd.AddValue("bfMinAngle", "Direction change in degrees that triggers an update (angle)", bfMinAngle);
+    cmd.AddValue("bfAudit", "Recompute every Nth skipped update and report beam correlation", bfAudit);
     cmd.Parse(argc, argv);
 
     // Create nodes
@@ -100,7 +113,12 @@ ueMob.Install(ueNodes);
 
     // Global NR attributes
     Config::SetDefault("ns3::NrRlcUm::MaxTxBufferSize", UintegerValue(999999999));
-    beamHelper->SetAttribute("BeamformingMethod", TypeIdValue(DirectPathBeamforming::GetTypeId()));
+    NS_ABORT_MSG_IF(!BeamUpdatePolicy::Get().Configure(bfPolicy, bfPeriod, bfMinDisplacement, bfMinAngle, bfAudit),
+                    "Unknown bfPolicy " << bfPolicy);
+    if (bfPolicy == "always")
+        beamHelper->SetAttribute("BeamformingMethod", TypeIdValue(DirectPathBeamforming::GetTypeId()));
+    else
+        beamHelper->SetAttribute("BeamformingMethod", TypeIdValue(ThrottledDirectPathBeamforming::GetTypeId()));
     nrEpcHelper->SetAttribute("S1uLinkDelay", TimeValue(MilliSeconds(0)));
 
     // Antennas
@@ -363,6 +381,15 @@ ueMob.Install(ueNodes);
 	std::cout << "Mean Delay: " << meanDelayMs << " ms" << std::endl;
 	std::cout << "Mean Jitter: " << meanJitterMs << " ms" << std::endl;
 	std::cout << "Simulation Duration: " << flowDuration << " seconds" << std::endl;
+	if (bfPolicy != "always")
+	{
+	    const BeamUpdatePolicy::Stats &bf = BeamUpdatePolicy::Get().GetStats();
+	    std::cout << "Beamforming Updates Skipped: " << bf.skipped << " of " << bf.calls << std::endl;
+	    std::cout << "Beamforming Time Saved: " << BeamUpdatePolicy::Get().GetSavedSeconds() << " s" << std::endl;
+	    if (bf.audits > 0)
+	        std::cout << "Beam Correlation (mean/min): " << bf.correlationSum / bf.audits << " / "
+	                  << bf.correlationMin << std::endl;
+	}
 	std::cout << "==================================" << std::endl;
 
     Simulator::Destroy();
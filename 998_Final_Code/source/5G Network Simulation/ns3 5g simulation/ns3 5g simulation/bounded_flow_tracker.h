@@ -0,0 +1,371 @@
+// bounded_flow_tracker.h - Fixed-capacity flow tracker for spoofed-source floods
+// FlowMonitor keeps one entry per 5-tuple forever, which is unbounded once attackers
+// randomise source addresses. This tracker hooks Ipv4L3Protocol SendOutgoing/LocalDeliver
+// directly, keeps at most MaxFlows live flows in an open-addressing table, evicts flows
+// idle for longer than IdleTimeout, and folds traffic that does not fit into per-/24
+// aggregate rows (src_ip = a.b.c.0, src_port = 0) for the window it arrived in.
+// Rows come out in FlowKey order, like FlowWindowSampler's. Losses are not tracked (only
+// send and local delivery are hooked), so WindowRow::lostPkts is always 0 here and the
+// generators leave the lost_pkts column out when this tracker is in use.
+
+#ifndef BOUNDED_FLOW_TRACKER_H
+#define BOUNDED_FLOW_TRACKER_H
+
+#include "flow_window_sampler.h"
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <vector>
+
+namespace ns3
+{
+
+// Transmit timestamp carried as a byte tag so the receiver side can compute delay
+class TrackerTimestampTag : public Tag
+{
+  public:
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::TrackerTimestampTag")
+                                .SetParent<Tag>()
+                                .SetGroupName("FlowMonitor")
+                                .AddConstructor<TrackerTimestampTag>();
+        return tid;
+    }
+
+    TypeId GetInstanceTypeId() const override { return GetTypeId(); }
+    uint32_t GetSerializedSize() const override { return 8; }
+    void Serialize(TagBuffer i) const override { i.WriteU64(static_cast<uint64_t>(m_txNs)); }
+    void Deserialize(TagBuffer i) override { m_txNs = static_cast<int64_t>(i.ReadU64()); }
+    void Print(std::ostream &os) const override { os << "txNs=" << m_txNs; }
+
+    int64_t m_txNs = 0;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(TrackerTimestampTag);
+
+class BoundedFlowTracker
+{
+  public:
+    struct Stats
+    {
+        uint64_t liveFlows = 0;
+        uint64_t peakFlows = 0;
+        uint64_t inserted = 0;
+        uint64_t evicted = 0;
+        uint64_t overflowPackets = 0;
+        uint64_t aggregateRows = 0;
+        uint64_t peakAggregates = 0;
+        uint64_t windows = 0;
+        double totalWindowNs = 0.0;
+        double maxWindowNs = 0.0;
+        uint64_t tableBytes = 0;
+    };
+
+    static constexpr uint32_t kMaxFlows = 1u << 30; // keeps the slot count (2x, power of two) within uint32_t
+
+    void Setup(uint32_t maxFlows, Time idleTimeout)
+    {
+        NS_ABORT_MSG_IF(maxFlows > kMaxFlows, "BoundedFlowTracker: maxFlows is at most " << kMaxFlows);
+        uint64_t slots = 16;
+        while (slots < 2 * static_cast<uint64_t>(maxFlows)) slots <<= 1; // load factor <= 0.5
+        m_table.assign(slots, Entry{});
+        m_mask = static_cast<uint32_t>(slots - 1);
+        m_maxFlows = maxFlows;
+        m_idleTimeout = idleTimeout.GetSeconds();
+        m_stats.tableBytes = slots * sizeof(Entry);
+    }
+
+    void Install(NodeContainer nodes)
+    {
+        for (uint32_t i = 0; i < nodes.GetN(); ++i)
+        {
+            Ptr<Ipv4L3Protocol> ipv4 = nodes.Get(i)->GetObject<Ipv4L3Protocol>();
+            ipv4->TraceConnectWithoutContext("SendOutgoing", MakeCallback(&BoundedFlowTracker::OnSend, this));
+            ipv4->TraceConnectWithoutContext("LocalDeliver", MakeCallback(&BoundedFlowTracker::OnDeliver, this));
+        }
+    }
+
+    const Stats &GetStats() const { return m_stats; }
+
+    // Bytes currently held by the table plus this window's aggregates (approximate)
+    uint64_t GetMemoryBytes() const
+    {
+        return m_stats.tableBytes + m_stats.peakAggregates * (sizeof(FlowKey) + sizeof(Entry) + 32);
+    }
+
+    // Emit one row per live flow (fwd + reverse) and one per overflow aggregate in FlowKey
+    // order, then reset window counters and evict idle flows
+    template <typename Fn>
+    void Sample(double windowSize, Fn &&fn)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        double now = Simulator::Now().GetSeconds();
+
+        static const Entry empty;
+        TRACE_LAPS(laps, "sort", "delta", "format", "evict");
+        TRACE_LAP(laps, 0);
+        m_order.clear();
+        for (uint32_t i = 0; i < m_table.size(); ++i)
+        {
+            if (m_table[i].used) m_order.push_back(i);
+        }
+        std::sort(m_order.begin(), m_order.end(),
+                  [this](uint32_t a, uint32_t b) { return m_table[a].key < m_table[b].key; });
+
+        // Merge the sorted live slots with the (already ordered) aggregates
+        auto agg = m_aggregates.begin();
+        auto emitAggregates = [&](const FlowKey *upTo) {
+            for (; agg != m_aggregates.end() && (!upTo || agg->first < *upTo); ++agg)
+            {
+                TRACE_LAP(laps, 1);
+                WindowRow row = MakeRow(agg->second, empty, windowSize);
+                TRACE_LAP(laps, 2);
+                fn(row);
+            }
+        };
+        for (uint32_t i : m_order)
+        {
+            const Entry &e = m_table[i];
+            emitAggregates(&e.key);
+            TRACE_LAP(laps, 1);
+            int64_t rev = Find(Reverse(e.key), Hash(Reverse(e.key)));
+            WindowRow row = MakeRow(e, rev >= 0 ? m_table[rev] : empty, windowSize);
+            TRACE_LAP(laps, 2);
+            fn(row);
+        }
+        emitAggregates(nullptr);
+        TRACE_LAP(laps, 3);
+        m_stats.aggregateRows += m_aggregates.size();
+        m_aggregates.clear();
+
+        m_idle.clear();
+        for (Entry &e : m_table)
+        {
+            if (!e.used) continue;
+            if (now - e.lastSeen > m_idleTimeout) m_idle.push_back(e.key);
+            e.Reset();
+        }
+        for (const FlowKey &k : m_idle)
+        {
+            Erase(static_cast<uint32_t>(Find(k, Hash(k))));
+            m_stats.evicted++;
+        }
+        TRACE_LAPS_END(laps);
+
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        m_stats.windows++;
+        m_stats.totalWindowNs += ns;
+        m_stats.maxWindowNs = std::max(m_stats.maxWindowNs, ns);
+    }
+
+  private:
+    struct Entry
+    {
+        bool used = false;
+        uint32_t id = 0;
+        uint64_t hash = 0;
+        FlowKey key{};
+        double lastSeen = 0.0;
+        uint64_t txPkts = 0;
+        uint64_t txBytes = 0;
+        uint64_t rxPkts = 0;
+        uint64_t rxBytes = 0;
+        double delaySum = 0.0; // seconds, this window
+        double jitterSum = 0.0;
+        double lastDelay = -1.0; // kept across windows for jitter
+
+        void Reset()
+        {
+            txPkts = txBytes = rxPkts = rxBytes = 0;
+            delaySum = jitterSum = 0.0;
+        }
+    };
+
+    static FlowKey Reverse(const FlowKey &k) { return FlowKey{k.dst, k.src, k.dstPort, k.srcPort, k.protocol}; }
+
+    static bool SameKey(const FlowKey &a, const FlowKey &b)
+    {
+        return a.src == b.src && a.dst == b.dst && a.srcPort == b.srcPort && a.dstPort == b.dstPort &&
+               a.protocol == b.protocol;
+    }
+
+    static uint64_t Hash(const FlowKey &k)
+    {
+        uint64_t h = (static_cast<uint64_t>(k.src.Get()) << 32) | k.dst.Get();
+        h ^= (static_cast<uint64_t>(k.srcPort) << 24) ^ (static_cast<uint64_t>(k.dstPort) << 8) ^ k.protocol;
+        h ^= h >> 33; // murmur3 finaliser
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // Slot index of key, or -1 if absent
+    int64_t Find(const FlowKey &k, uint64_t h) const
+    {
+        for (uint32_t i = h & m_mask;; i = (i + 1) & m_mask)
+        {
+            if (!m_table[i].used) return -1;
+            if (m_table[i].hash == h && SameKey(m_table[i].key, k)) return i;
+        }
+    }
+
+    // Backward-shift deletion keeps linear probing chains intact without tombstones
+    void Erase(uint32_t i)
+    {
+        m_table[i].used = false;
+        for (uint32_t j = (i + 1) & m_mask; m_table[j].used; j = (j + 1) & m_mask)
+        {
+            uint32_t home = m_table[j].hash & m_mask;
+            bool stays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+            if (stays) continue;
+            m_table[i] = m_table[j];
+            m_table[j].used = false;
+            i = j;
+        }
+        m_stats.liveFlows--;
+    }
+
+    // Entry for key: live table slot, a new slot, or the /24 aggregate when the table is full
+    Entry &Lookup(const FlowKey &k)
+    {
+        uint64_t h = Hash(k);
+        uint32_t i = h & m_mask;
+        for (; m_table[i].used; i = (i + 1) & m_mask)
+        {
+            if (m_table[i].hash == h && SameKey(m_table[i].key, k)) return m_table[i];
+        }
+        if (m_stats.liveFlows < m_maxFlows)
+        {
+            Entry &e = m_table[i];
+            e = Entry{};
+            e.used = true;
+            e.id = ++m_nextId;
+            e.hash = h;
+            e.key = k;
+            m_stats.inserted++;
+            m_stats.liveFlows++;
+            m_stats.peakFlows = std::max(m_stats.peakFlows, m_stats.liveFlows);
+            return e;
+        }
+
+        m_stats.overflowPackets++;
+        FlowKey agg{Ipv4Address(k.src.Get() & 0xFFFFFF00), k.dst, 0, k.dstPort, k.protocol};
+        Entry &e = m_aggregates[agg];
+        e.key = agg;
+        m_stats.peakAggregates = std::max<uint64_t>(m_stats.peakAggregates, m_aggregates.size());
+        return e;
+    }
+
+    static bool KeyOf(const Ipv4Header &h, Ptr<const Packet> p, FlowKey &k)
+    {
+        if (h.GetFragmentOffset() != 0) return false;
+        k = FlowKey{h.GetSource(), h.GetDestination(), 0, 0, h.GetProtocol()};
+        if (k.protocol == 17 && p->GetSize() >= 8)
+        {
+            UdpHeader udp;
+            p->PeekHeader(udp);
+            k.srcPort = udp.GetSourcePort();
+            k.dstPort = udp.GetDestinationPort();
+        }
+        else if (k.protocol == 6 && p->GetSize() >= 20)
+        {
+            TcpHeader tcp;
+            p->PeekHeader(tcp);
+            k.srcPort = tcp.GetSourcePort();
+            k.dstPort = tcp.GetDestinationPort();
+        }
+        return true;
+    }
+
+    void OnSend(const Ipv4Header &h, Ptr<const Packet> p, uint32_t)
+    {
+        FlowKey k;
+        if (!KeyOf(h, p, k)) return;
+        Entry &e = Lookup(k);
+        e.txPkts++;
+        e.txBytes += p->GetSize() + h.GetSerializedSize();
+        e.lastSeen = Simulator::Now().GetSeconds();
+
+        TrackerTimestampTag tag;
+        tag.m_txNs = Simulator::Now().GetNanoSeconds();
+        p->AddByteTag(tag);
+    }
+
+    void OnDeliver(const Ipv4Header &h, Ptr<const Packet> p, uint32_t)
+    {
+        FlowKey k;
+        if (!KeyOf(h, p, k)) return;
+        Entry &e = Lookup(k);
+        e.rxPkts++;
+        e.rxBytes += p->GetSize() + h.GetSerializedSize();
+        e.lastSeen = Simulator::Now().GetSeconds();
+
+        TrackerTimestampTag tag;
+        if (p->FindFirstMatchingByteTag(tag))
+        {
+            double delay = (Simulator::Now().GetNanoSeconds() - tag.m_txNs) * 1e-9;
+            e.delaySum += delay;
+            if (e.lastDelay >= 0.0) e.jitterSum += std::abs(delay - e.lastDelay);
+            e.lastDelay = delay;
+        }
+    }
+
+    // Same field semantics as FlowWindowSampler: fwd/bwd are tx + rx within the window
+    static WindowRow MakeRow(const Entry &f, const Entry &b, double windowSize)
+    {
+        WindowRow row;
+        row.id = f.id;
+        row.key = f.key;
+        row.duration = windowSize;
+        row.totalPktsFwd = f.txPkts + f.rxPkts;
+        row.totalPktsBwd = b.txPkts + b.rxPkts;
+        row.totalBytesFwd = f.txBytes + f.rxBytes;
+        row.totalBytesBwd = b.txBytes + b.rxBytes;
+        row.pktsPerSec = (row.totalPktsFwd + row.totalPktsBwd) / windowSize;
+        row.bytesPerSec = (row.totalBytesFwd + row.totalBytesBwd) / windowSize;
+        row.flowPktsPerSec = row.totalPktsFwd / windowSize;
+        row.flowBytesPerSec = row.totalBytesFwd / windowSize;
+        row.lostPkts = 0; // not tracked; see the header comment
+
+        row.avgDelayMs = 0.0;
+        row.avgJitterMs = 0.0;
+        uint64_t rxAll = f.rxPkts + b.rxPkts;
+        row.rxPkts = rxAll;
+        if (rxAll > 0)
+        {
+            row.avgDelayMs = 1000.0 * (f.delaySum + b.delaySum) / static_cast<double>(rxAll);
+            row.avgJitterMs = 1000.0 * (f.jitterSum + b.jitterSum) / static_cast<double>(rxAll);
+        }
+
+        row.avgPktSize = 0.0;
+        uint64_t pktsAll = row.totalPktsFwd + row.totalPktsBwd;
+        if (pktsAll > 0)
+        {
+            row.avgPktSize = static_cast<double>(row.totalBytesFwd + row.totalBytesBwd) / static_cast<double>(pktsAll);
+        }
+        return row;
+    }
+
+    std::vector<Entry> m_table; // open addressing, linear probing
+    uint32_t m_mask = 0;
+    uint32_t m_maxFlows = 0;
+    uint32_t m_nextId = 0;
+    double m_idleTimeout = 2.0; // seconds
+    std::map<FlowKey, Entry> m_aggregates; // per-/24 overflow rows, cleared every window
+    std::vector<uint32_t> m_order; // live slot indices sorted by key, rebuilt every window
+    std::vector<FlowKey> m_idle;
+    Stats m_stats;
+};
+
+} // namespace ns3
+
+#endif // BOUNDED_FLOW_TRACKER_H
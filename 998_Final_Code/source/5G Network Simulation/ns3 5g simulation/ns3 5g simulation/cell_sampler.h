@@ -0,0 +1,165 @@
+// cell_sampler.h - Per-cell partitioning of FlowWindowSampler output for multi-gNB NR runs
+// Each flow is owned by the serving cell of its source UE (or of its destination UE if the
+// source is not a UE). Every cell keeps its own key-sorted flow list and row counters, so a
+// window tick walks cell by cell and only re-buckets flows whose UE changed cell through a
+// handover. With a single cell the row order is the same as FlowWindowSampler::Sample.
+
+#ifndef CELL_SAMPLER_H
+#define CELL_SAMPLER_H
+
+#include "flow_window_sampler.h"
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/nr-module.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace ns3
+{
+
+class CellSampler
+{
+  public:
+    struct CellStats
+    {
+        uint16_t cellId = 0;
+        uint64_t rows = 0;
+        uint64_t handoversIn = 0; // flows moved into this cell by a serving-cell change
+        uint32_t peakFlows = 0;
+    };
+
+    void Setup(FlowWindowSampler *sampler, const NetDeviceContainer &gnbDevs, const NetDeviceContainer &ueDevs,
+               const Ipv4InterfaceContainer &ueIfaces)
+    {
+        m_sampler = sampler;
+        m_ueDevs = ueDevs;
+        m_ueCell.assign(ueDevs.GetN(), 0);
+        for (uint32_t i = 0; i < ueDevs.GetN(); ++i)
+        {
+            m_ueByAddr[ueIfaces.GetAddress(i).Get()] = i;
+        }
+        // Slot 0 collects flows with no UE endpoint or a UE that is not attached yet
+        m_cells.assign(gnbDevs.GetN() + 1, Cell{});
+        m_slotByCell[0] = 0;
+        for (uint32_t g = 0; g < gnbDevs.GetN(); ++g)
+        {
+            uint16_t cellId = DynamicCast<NrGnbNetDevice>(gnbDevs.Get(g))->GetCellId();
+            m_cells[g + 1].stats.cellId = cellId;
+            m_slotByCell[cellId] = g + 1;
+        }
+    }
+
+    // Poll once, then call fn(const WindowRow &, uint16_t cellId) cell by cell
+    template <typename Fn>
+    void Sample(double windowSize, Fn &&fn)
+    {
+        m_sampler->Poll();
+        Rebucket();
+
+        TRACE_LAPS(laps, "delta", "format");
+        for (Cell &cell : m_cells)
+        {
+            if (cell.dirty)
+            {
+                std::sort(cell.flows.begin(), cell.flows.end(), [this](FlowId a, FlowId b) {
+                    return m_sampler->GetKey(a) < m_sampler->GetKey(b);
+                });
+                cell.dirty = false;
+            }
+            for (FlowId id : cell.flows)
+            {
+                TRACE_LAP(laps, 0);
+                WindowRow row = m_sampler->MakeRow(id, windowSize);
+                TRACE_LAP(laps, 1);
+                fn(row, cell.stats.cellId);
+            }
+            cell.stats.rows += cell.flows.size();
+            cell.stats.peakFlows = std::max(cell.stats.peakFlows, static_cast<uint32_t>(cell.flows.size()));
+        }
+        TRACE_LAPS_END(laps);
+
+        m_sampler->Commit();
+    }
+
+    // Per-cell totals; slot 0 (cellId 0) holds flows without a serving cell
+    std::vector<CellStats> GetStats() const
+    {
+        std::vector<CellStats> out;
+        for (const Cell &cell : m_cells) out.push_back(cell.stats);
+        return out;
+    }
+
+  private:
+    struct Cell
+    {
+        std::vector<FlowId> flows; // key-sorted unless dirty
+        bool dirty = false;
+        CellStats stats;
+    };
+
+    void Rebucket()
+    {
+        // Serving cells are read once per UE per window, not once per flow
+        bool moved = false;
+        for (uint32_t i = 0; i < m_ueDevs.GetN(); ++i)
+        {
+            uint16_t cellId = DynamicCast<NrUeNetDevice>(m_ueDevs.Get(i))->GetCellId();
+            if (cellId != m_ueCell[i])
+            {
+                m_ueCell[i] = cellId;
+                moved = true;
+            }
+        }
+
+        // The sampler re-sorts its order when flows appear, so new flows are not at the tail;
+        // rescan only in windows where flows appeared or a UE changed cell
+        const std::vector<FlowId> &order = m_sampler->GetOrder();
+        if (!moved && order.size() == m_assigned) return;
+        m_assigned = order.size();
+
+        for (FlowId id : order)
+        {
+            if (id >= m_flowSlot.size()) m_flowSlot.resize(id + 1, kUnassigned);
+            uint32_t slot = SlotOf(m_sampler->GetKey(id));
+            uint32_t old = m_flowSlot[id];
+            if (old == slot) continue;
+            if (old != kUnassigned)
+            {
+                std::vector<FlowId> &v = m_cells[old].flows;
+                v.erase(std::find(v.begin(), v.end(), id));
+                if (old != 0) m_cells[slot].stats.handoversIn++;
+            }
+            m_cells[slot].flows.push_back(id);
+            m_cells[slot].dirty = true;
+            m_flowSlot[id] = slot;
+        }
+    }
+
+    uint32_t SlotOf(const FlowKey &key) const
+    {
+        auto ue = m_ueByAddr.find(key.src.Get());
+        if (ue == m_ueByAddr.end()) ue = m_ueByAddr.find(key.dst.Get());
+        if (ue == m_ueByAddr.end()) return 0;
+        auto slot = m_slotByCell.find(m_ueCell[ue->second]);
+        return slot == m_slotByCell.end() ? 0 : slot->second;
+    }
+
+    static constexpr uint32_t kUnassigned = 0xFFFFFFFF;
+
+    FlowWindowSampler *m_sampler = nullptr;
+    NetDeviceContainer m_ueDevs;
+    std::vector<uint16_t> m_ueCell;         // last seen serving cell per UE
+    std::map<uint32_t, uint32_t> m_ueByAddr; // UE IPv4 -> UE index
+    std::map<uint16_t, uint32_t> m_slotByCell;
+    std::vector<Cell> m_cells;
+    std::vector<uint32_t> m_flowSlot; // indexed by FlowId
+    size_t m_assigned = 0; // flows bucketed as of the last rescan
+};
+
+} // namespace ns3
+
+#endif // CELL_SAMPLER_H
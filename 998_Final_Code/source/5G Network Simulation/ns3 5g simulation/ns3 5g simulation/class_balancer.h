@@ -0,0 +1,171 @@
+// class_balancer.h - Per-class row budgets applied before a row is formatted
+// High-intensity DDoS runs emit far more attack rows than benign ones, and benign runs are
+// mostly idle flows, so training used to downsample after everything was simulated, formatted
+// and stored. WriteRow() asks Offer() once it knows a row's label. Only rows that are kept
+// are formatted, and each carries a weight column so sums and means over the CSV stay unbiased
+// (Horvitz-Thompson: weight = 1 / inclusion probability).
+//
+//   rate       each class keeps a row with a fixed probability p and writes it at once,
+//              weight 1/p
+//   reservoir  each class keeps a uniform sample of at most Budget rows over the whole run
+//              (Li's Algorithm L, one random draw per accepted row rather than per row seen).
+//              Kept rows are held unformatted until Drain() at run end, in arrival order,
+//              weight seen/kept
+//
+// The generator's own state that a row needs at format time (queue or radio columns) goes in
+// Item, filled in by the caller when Offer() hands out a slot.
+
+#ifndef CLASS_BALANCER_H
+#define CLASS_BALANCER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+template <typename Item>
+class ClassBalancer
+{
+  public:
+    enum Mode
+    {
+        OFF,
+        RATE,
+        RESERVOIR
+    };
+
+    enum Decision
+    {
+        SKIP,  // drop the row: do not format it
+        WRITE, // format it now with the returned weight
+        HOLD   // fill the returned slot; Drain() formats it at run end
+    };
+
+    struct ClassStats
+    {
+        uint64_t seen = 0;
+        uint64_t kept = 0;
+    };
+
+    // Returns false for an unknown mode or an out-of-range budget or rate
+    bool Configure(const std::string &mode, uint64_t budget, double keepAttack, double keepBenign, uint64_t seed)
+    {
+        if (mode == "off") m_mode = OFF;
+        else if (mode == "rate") m_mode = RATE;
+        else if (mode == "reservoir") m_mode = RESERVOIR;
+        else return false;
+        if (m_mode == RESERVOIR && budget == 0) return false;
+        if (m_mode == RATE && (keepAttack <= 0 || keepAttack > 1 || keepBenign <= 0 || keepBenign > 1)) return false;
+        m_budget = budget;
+        m_keep[0] = keepBenign;
+        m_keep[1] = keepAttack;
+        m_rng.seed(seed ^ 0x636c617373ull); // own stream, so ns-3's RNG draws are unchanged
+        return true;
+    }
+
+    bool IsEnabled() const { return m_mode != OFF; }
+    Mode GetMode() const { return m_mode; }
+    const ClassStats &GetStats(bool attack) const { return m_class[attack].stats; }
+
+    // Bytes held by the reservoirs, for the run summary
+    uint64_t GetMemoryBytes() const
+    {
+        return (m_class[0].items.capacity() + m_class[1].items.capacity()) * (sizeof(Item) + sizeof(uint64_t));
+    }
+
+    Decision Offer(bool attack, Item *&slot, double &weight)
+    {
+        Class &c = m_class[attack];
+        uint64_t i = c.stats.seen++;
+        uint64_t seq = m_seq++;
+        if (m_mode == RATE)
+        {
+            if (m_keep[attack] < 1.0 && Uniform() >= m_keep[attack]) return SKIP;
+            c.stats.kept++;
+            weight = 1.0 / m_keep[attack];
+            return WRITE;
+        }
+
+        // Reservoir: fill, then accept only at the skip positions of Algorithm L
+        if (i < m_budget)
+        {
+            c.items.emplace_back();
+            c.seqs.push_back(seq);
+            c.stats.kept++;
+            slot = &c.items.back();
+            if (i + 1 == m_budget)
+            {
+                c.w = std::exp(std::log(Uniform()) / m_budget);
+                c.next = i + Skip(c.w) + 1;
+            }
+            return HOLD;
+        }
+        if (i != c.next) return SKIP;
+        size_t j = static_cast<size_t>(Uniform() * m_budget);
+        c.items[j] = Item();
+        c.seqs[j] = seq;
+        slot = &c.items[j];
+        c.w *= std::exp(std::log(Uniform()) / m_budget);
+        c.next = i + Skip(c.w) + 1;
+        return HOLD;
+    }
+
+    // Calls fn(const Item &, double weight) for every held row, in the order they were offered
+    template <typename Fn>
+    void Drain(Fn &&fn)
+    {
+        std::vector<std::pair<uint64_t, const Item *>> order;
+        double weight[2];
+        for (int k = 0; k < 2; ++k)
+        {
+            const Class &c = m_class[k];
+            weight[k] = c.items.empty() ? 1.0 : double(c.stats.seen) / c.items.size();
+            for (size_t j = 0; j < c.items.size(); ++j) order.push_back({c.seqs[j] * 2 + k, &c.items[j]});
+        }
+        std::sort(order.begin(), order.end(),
+                  [](const std::pair<uint64_t, const Item *> &a, const std::pair<uint64_t, const Item *> &b) {
+                      return a.first < b.first;
+                  });
+        for (const auto &e : order) fn(*e.second, weight[e.first & 1]);
+        for (Class &c : m_class)
+        {
+            c.items.clear();
+            c.seqs.clear();
+        }
+    }
+
+  private:
+    struct Class
+    {
+        ClassStats stats;
+        std::vector<Item> items;
+        std::vector<uint64_t> seqs; // arrival order of each held item
+        double w = 0.0;
+        uint64_t next = 0; // index (within the class) of the next row to accept
+    };
+
+    // Uniform in (0, 1), never 0 so log() is finite
+    double Uniform() { return (double(m_rng() >> 11) + 0.5) * (1.0 / 9007199254740992.0); }
+
+    uint64_t Skip(double w)
+    {
+        double skip = std::floor(std::log(Uniform()) / std::log1p(-w));
+        return skip < 1e18 ? static_cast<uint64_t>(skip) : uint64_t(1e18); // w underflows to 0 on very long runs
+    }
+
+    Mode m_mode = OFF;
+    uint64_t m_budget = 0;
+    double m_keep[2] = {1.0, 1.0}; // benign, attack
+    std::mt19937_64 m_rng;
+    Class m_class[2]; // benign, attack
+    uint64_t m_seq = 0;
+};
+
+} // namespace ns3
+
+#endif // CLASS_BALANCER_H
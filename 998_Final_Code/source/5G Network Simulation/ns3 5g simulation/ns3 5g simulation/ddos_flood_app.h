@@ -0,0 +1,317 @@
+// ddos_flood_app.h - Burst-scheduled DDoS flood application for the dataset generators
+// Sends N packets per scheduled event, copied from a prebuilt template packet, so a
+// high-rate attacker costs one simulator event per burst instead of one per packet.
+// Pulse covers shrew-style attacks (sub-second peak bursts); GapJitter with a low
+// DataRate and BurstSize 1 gives low-and-slow floods. With SpoofSources > 0 (UDP only)
+// every packet gets a random source address from SpoofBase/SpoofSources and a random
+// source port, and is handed straight to Ipv4::Send instead of a socket. SpoofSources is
+// capped at 2^20 so the range fits the /12 the generators' labels match spoofed sources on.
+// Header-only: copy next to the generator .cc files in the ns-3 scratch directory.
+
+#ifndef DDOS_FLOOD_APP_H
+#define DDOS_FLOOD_APP_H
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace ns3
+{
+
+class DdosFloodApplication : public Application
+{
+  public:
+    // Shape of the offered load over time; the rate is always DataRate * factor(t)
+    enum Profile
+    {
+        PROFILE_CONSTANT, // factor 1
+        PROFILE_RAMP,     // linear 0 -> 1 over RampTime, then 1
+        PROFILE_PULSE,    // 1 for PulseDuty * PulsePeriod at the start of every period, else 0
+        PROFILE_ONOFF,    // 1 for OnTime, 0 for OffTime, repeating
+    };
+
+    static constexpr uint32_t kMaxSpoofSources = 1u << 20; // one /12
+
+    static TypeId GetTypeId()
+    {
+        static TypeId tid =
+            TypeId("ns3::DdosFloodApplication")
+                .SetParent<Application>()
+                .SetGroupName("Applications")
+                .AddConstructor<DdosFloodApplication>()
+                .AddAttribute("Remote",
+                              "Destination address of the flood",
+                              AddressValue(),
+                              MakeAddressAccessor(&DdosFloodApplication::m_peer),
+                              MakeAddressChecker())
+                .AddAttribute("Protocol",
+                              "Socket factory used to send (UDP or TCP)",
+                              TypeIdValue(UdpSocketFactory::GetTypeId()),
+                              MakeTypeIdAccessor(&DdosFloodApplication::m_tid),
+                              MakeTypeIdChecker())
+                .AddAttribute("PacketSize",
+                              "Size of each packet handed to the socket (bytes)",
+                              UintegerValue(1024),
+                              MakeUintegerAccessor(&DdosFloodApplication::m_pktSize),
+                              MakeUintegerChecker<uint32_t>(12))
+                .AddAttribute("DataRate",
+                              "Peak offered load",
+                              DataRateValue(DataRate("40Mbps")),
+                              MakeDataRateAccessor(&DdosFloodApplication::m_rate),
+                              MakeDataRateChecker())
+                .AddAttribute("BurstSize",
+                              "Packets sent per scheduled event",
+                              UintegerValue(10),
+                              MakeUintegerAccessor(&DdosFloodApplication::m_burst),
+                              MakeUintegerChecker<uint32_t>(1))
+                .AddAttribute("Profile",
+                              "Rate profile over time",
+                              EnumValue(PROFILE_CONSTANT),
+                              MakeEnumAccessor<Profile>(&DdosFloodApplication::m_profile),
+                              MakeEnumChecker(PROFILE_CONSTANT, "constant",
+                                              PROFILE_RAMP, "ramp",
+                                              PROFILE_PULSE, "pulse",
+                                              PROFILE_ONOFF, "onoff"))
+                .AddAttribute("RampTime",
+                              "Time to reach the peak rate (ramp profile)",
+                              TimeValue(Seconds(5.0)),
+                              MakeTimeAccessor(&DdosFloodApplication::m_rampTime),
+                              MakeTimeChecker())
+                .AddAttribute("PulsePeriod",
+                              "Pulse repetition period (pulse profile)",
+                              TimeValue(Seconds(1.0)),
+                              MakeTimeAccessor(&DdosFloodApplication::m_pulsePeriod),
+                              MakeTimeChecker())
+                .AddAttribute("PulseDuty",
+                              "Fraction of each pulse period spent at peak rate",
+                              DoubleValue(0.2),
+                              MakeDoubleAccessor(&DdosFloodApplication::m_pulseDuty),
+                              MakeDoubleChecker<double>(0.0, 1.0))
+                .AddAttribute("OnTime",
+                              "Length of each on phase (onoff profile)",
+                              TimeValue(Seconds(1.0)),
+                              MakeTimeAccessor(&DdosFloodApplication::m_onTime),
+                              MakeTimeChecker())
+                .AddAttribute("OffTime",
+                              "Length of each off phase (onoff profile)",
+                              TimeValue(Seconds(1.0)),
+                              MakeTimeAccessor(&DdosFloodApplication::m_offTime),
+                              MakeTimeChecker())
+                .AddAttribute("GapJitter",
+                              "Relative random jitter on each inter-burst gap (0 = periodic)",
+                              DoubleValue(0.0),
+                              MakeDoubleAccessor(&DdosFloodApplication::m_gapJitter),
+                              MakeDoubleChecker<double>(0.0, 1.0))
+                .AddAttribute("SpoofSources",
+                              "Number of distinct spoofed source addresses (0 = no spoofing, UDP only, at most 2^20)",
+                              UintegerValue(0),
+                              MakeUintegerAccessor(&DdosFloodApplication::m_spoofSources),
+                              MakeUintegerChecker<uint32_t>(0, kMaxSpoofSources))
+                .AddAttribute("SpoofBase",
+                              "First spoofed source address",
+                              Ipv4AddressValue("172.16.0.0"),
+                              MakeIpv4AddressAccessor(&DdosFloodApplication::m_spoofBase),
+                              MakeIpv4AddressChecker());
+        return tid;
+    }
+
+    DdosFloodApplication() = default;
+    ~DdosFloodApplication() override = default;
+
+    uint64_t GetPacketsSent() const { return m_sent; }
+    uint64_t GetPacketsFailed() const { return m_failed; }
+    uint64_t GetBursts() const { return m_bursts; }
+
+  protected:
+    void DoDispose() override
+    {
+        m_socket = nullptr;
+        m_jitterRv = nullptr;
+        m_spoofRv = nullptr;
+        m_ipv4 = nullptr;
+        m_template = nullptr;
+        Application::DoDispose();
+    }
+
+  private:
+    void StartApplication() override
+    {
+        // SendBurst divides by the rate; RateFactor/UntilNextOn take the phase modulo these periods
+        NS_ABORT_MSG_IF(m_rate.GetBitRate() == 0, "DdosFloodApplication: DataRate must be > 0");
+        NS_ABORT_MSG_IF(m_profile == PROFILE_PULSE && !m_pulsePeriod.IsStrictlyPositive(),
+                        "DdosFloodApplication: pulse profile needs PulsePeriod > 0");
+        NS_ABORT_MSG_IF(m_profile == PROFILE_ONOFF && (m_onTime.IsStrictlyNegative() || m_offTime.IsStrictlyNegative() ||
+                                                       !(m_onTime + m_offTime).IsStrictlyPositive()),
+                        "DdosFloodApplication: onoff profile needs OnTime, OffTime >= 0 and OnTime + OffTime > 0");
+
+        if (!m_socket)
+        {
+            m_socket = Socket::CreateSocket(GetNode(), m_tid);
+            m_socket->Bind();
+            m_socket->Connect(m_peer);
+            m_socket->ShutdownRecv();
+            m_socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+        }
+
+        // Same on-wire layout as UdpClient: SeqTs header + zero payload, PacketSize in total
+        SeqTsHeader seqTs;
+        m_template = Create<Packet>(m_pktSize - seqTs.GetSerializedSize());
+        m_template->AddHeader(seqTs);
+
+        if (m_gapJitter > 0.0 && !m_jitterRv)
+        {
+            m_jitterRv = CreateObject<UniformRandomVariable>();
+        }
+
+        if (m_spoofSources > 0 && m_tid == UdpSocketFactory::GetTypeId())
+        {
+            m_ipv4 = GetNode()->GetObject<Ipv4>();
+            m_spoofRv = CreateObject<UniformRandomVariable>();
+        }
+
+        m_start = Simulator::Now();
+        m_sendEvent = Simulator::ScheduleNow(&DdosFloodApplication::SendBurst, this);
+    }
+
+    void StopApplication() override
+    {
+        Simulator::Cancel(m_sendEvent);
+        if (m_socket)
+        {
+            m_socket->Close();
+        }
+    }
+
+    // Rate multiplier at 'elapsed' since start; 0 means the application is in an off phase
+    double RateFactor(Time elapsed) const
+    {
+        switch (m_profile)
+        {
+        case PROFILE_RAMP:
+            if (m_rampTime.IsZero() || elapsed >= m_rampTime) return 1.0;
+            return std::max(elapsed.GetSeconds() / m_rampTime.GetSeconds(), 0.01);
+        case PROFILE_PULSE: {
+            double phase = std::fmod(elapsed.GetSeconds(), m_pulsePeriod.GetSeconds());
+            return phase < m_pulseDuty * m_pulsePeriod.GetSeconds() ? 1.0 : 0.0;
+        }
+        case PROFILE_ONOFF: {
+            double cycle = (m_onTime + m_offTime).GetSeconds();
+            return std::fmod(elapsed.GetSeconds(), cycle) < m_onTime.GetSeconds() ? 1.0 : 0.0;
+        }
+        default:
+            return 1.0;
+        }
+    }
+
+    // Time from 'elapsed' until the next on phase begins (only called while off)
+    Time UntilNextOn(Time elapsed) const
+    {
+        Time cycle = m_profile == PROFILE_PULSE ? m_pulsePeriod : m_onTime + m_offTime;
+        int64_t n = elapsed.GetTimeStep() / cycle.GetTimeStep();
+        return cycle * (n + 1) - elapsed;
+    }
+
+    void SendBurst()
+    {
+        Time elapsed = Simulator::Now() - m_start;
+        double factor = RateFactor(elapsed);
+        if (factor <= 0.0)
+        {
+            m_sendEvent = Simulator::Schedule(UntilNextOn(elapsed), &DdosFloodApplication::SendBurst, this);
+            return;
+        }
+
+        for (uint32_t i = 0; i < m_burst; ++i)
+        {
+            if (m_ipv4) SendSpoofed();
+            else if (m_socket->Send(m_template->Copy()) < 0) m_failed++;
+            else m_sent++;
+        }
+        m_bursts++;
+
+        // Space bursts so the average over the burst matches DataRate * factor
+        double bits = static_cast<double>(m_burst) * m_pktSize * 8.0;
+        double gapSec = bits / (static_cast<double>(m_rate.GetBitRate()) * factor);
+        if (m_jitterRv)
+        {
+            gapSec *= m_jitterRv->GetValue(1.0 - m_gapJitter, 1.0 + m_gapJitter);
+        }
+        Time gap = Seconds(gapSec);
+        m_sendEvent = Simulator::Schedule(gap, &DdosFloodApplication::SendBurst, this);
+    }
+
+    // Bypass the socket so the IP source and UDP source port can be forged per packet
+    void SendSpoofed()
+    {
+        InetSocketAddress peer = InetSocketAddress::ConvertFrom(m_peer);
+        Ipv4Address src(m_spoofBase.Get() + m_spoofRv->GetInteger(0, m_spoofSources - 1));
+
+        Ptr<Packet> p = m_template->Copy();
+        UdpHeader udp;
+        udp.SetSourcePort(static_cast<uint16_t>(m_spoofRv->GetInteger(1024, 65535)));
+        udp.SetDestinationPort(peer.GetPort());
+        p->AddHeader(udp);
+        m_ipv4->Send(p, src, peer.GetIpv4(), 17, nullptr);
+        m_sent++;
+    }
+
+    Address m_peer;
+    TypeId m_tid;
+    uint32_t m_pktSize = 1024;
+    DataRate m_rate;
+    uint32_t m_burst = 10;
+    Profile m_profile = PROFILE_CONSTANT;
+    Time m_rampTime;
+    Time m_pulsePeriod;
+    double m_pulseDuty = 0.2;
+    Time m_onTime;
+    Time m_offTime;
+    double m_gapJitter = 0.0;
+    uint32_t m_spoofSources = 0;
+    Ipv4Address m_spoofBase;
+
+    Ptr<Socket> m_socket;
+    Ptr<Packet> m_template;
+    Ptr<UniformRandomVariable> m_jitterRv;
+    Ptr<UniformRandomVariable> m_spoofRv;
+    Ptr<Ipv4> m_ipv4; // set only when spoofing
+    EventId m_sendEvent;
+    Time m_start;
+    uint64_t m_sent = 0;
+    uint64_t m_failed = 0;
+    uint64_t m_bursts = 0;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(DdosFloodApplication);
+
+class DdosFloodHelper
+{
+  public:
+    DdosFloodHelper(std::string protocol, Address remote)
+    {
+        m_factory.SetTypeId(DdosFloodApplication::GetTypeId());
+        m_factory.Set("Protocol", TypeIdValue(TypeId::LookupByName(protocol)));
+        m_factory.Set("Remote", AddressValue(remote));
+    }
+
+    void SetAttribute(std::string name, const AttributeValue &value) { m_factory.Set(name, value); }
+
+    ApplicationContainer Install(Ptr<Node> node) const
+    {
+        Ptr<Application> app = m_factory.Create<Application>();
+        node->AddApplication(app);
+        return ApplicationContainer(app);
+    }
+
+  private:
+    ObjectFactory m_factory;
+};
+
+} // namespace ns3
+
+#endif // DDOS_FLOOD_APP_H
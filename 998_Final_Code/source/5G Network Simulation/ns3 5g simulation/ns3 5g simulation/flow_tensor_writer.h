@@ -0,0 +1,219 @@
+// flow_tensor_writer.h - Per-flow [windows x features] float32 tensors for sequence models
+// The CSV has one row per flow per window, so an LSTM/TCN input needs a groupby and sort
+// over every file. With --tensors=1, SampleAndWrite() also hands each row to AddRow(), which
+// appends the row's features to that flow's own buffer. Write() lays the buffers out
+// back to back at run end, so every flow is a contiguous matrix that NumPy can memory-map
+// (5G_IDS_ML_Cap/scripts/load_tensors.py).
+//
+// File, little-endian, every section 64-byte aligned:
+//   HEADER (128 bytes)  char magic[4] "FTNS", u32 version, u32 features, u32 reserved,
+//                       u64 flows, u64 rows, f64 window_s, u64 names_offset, u64 index_offset,
+//                       u64 data_offset, u64 window_offset, u64 label_offset, char scenario_id[48]
+//   NAMES    features x char[32]   feature names, NUL-padded
+//   INDEX    flows x 32 bytes      u64 first_row, u32 src, u32 dst, u16 src_port, u16 dst_port,
+//                                  u32 windows, u32 first_window, u8 protocol, u8 any_attack, u16 pad
+//   DATA     rows x features f32   flow i is rows [first_row, first_row + windows)
+//   WINDOW   rows x u32            window index of each row (time_start = index x window_s)
+//   LABEL    rows x 2 u8           label_binary, label_intensity
+// Flows are in FlowKey order.
+
+#ifndef FLOW_TENSOR_WRITER_H
+#define FLOW_TENSOR_WRITER_H
+
+#include "flow_window_sampler.h"
+
+#include "ns3/core-module.h"
+
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class FlowTensorWriter
+{
+  public:
+    static const uint32_t kVersion = 1;
+    static const uint32_t kFeatures = 12;
+
+    // Same names as the CSV columns they come from
+    static const char *FeatureName(uint32_t i)
+    {
+        static const char *names[kFeatures] = {
+            "packet_size",  "flow_duration", "total_bytes_fwd", "total_bytes_bwd",
+            "total_pkts_fwd", "total_pkts_bwd", "pkts_per_sec",   "bytes_per_sec",
+            "flow_pkts_per_sec", "flow_bytes_per_sec", "jitter_ms", "delay_ms"};
+        return names[i];
+    }
+
+    void Enable(const std::string &scenarioId, double windowSize)
+    {
+        m_enabled = true;
+        m_scenarioId = scenarioId;
+        m_windowSize = windowSize;
+    }
+
+    bool IsEnabled() const { return m_enabled; }
+    uint64_t GetFlows() const { return m_flows.size(); }
+    uint64_t GetRows() const { return m_rows; }
+
+    void AddRow(const WindowRow &r, uint64_t windowIndex, bool attackBinary, int attackIntensity)
+    {
+        auto it = m_byKey.find(r.key);
+        if (it == m_byKey.end())
+        {
+            it = m_byKey.emplace(r.key, m_flows.size()).first;
+            m_flows.emplace_back();
+            m_flows.back().key = r.key;
+        }
+        FlowBuffer &f = m_flows[it->second];
+        const float v[kFeatures] = {
+            float(r.avgPktSize),     float(r.duration),        float(r.totalBytesFwd), float(r.totalBytesBwd),
+            float(r.totalPktsFwd),   float(r.totalPktsBwd),    float(r.pktsPerSec),    float(r.bytesPerSec),
+            float(r.flowPktsPerSec), float(r.flowBytesPerSec), float(r.avgJitterMs),   float(r.avgDelayMs)};
+        f.values.insert(f.values.end(), v, v + kFeatures);
+        f.windows.push_back(static_cast<uint32_t>(windowIndex));
+        f.labels.push_back(attackBinary ? 1 : 0);
+        f.labels.push_back(static_cast<uint8_t>(attackIntensity));
+        m_rows++;
+    }
+
+    // Bytes the file will take, for the run summary
+    uint64_t GetFileBytes() const
+    {
+        uint64_t bytes = Align(sizeof(Header)) + Align(kFeatures * 32) + Align(m_flows.size() * sizeof(IndexEntry));
+        return bytes + Align(m_rows * kFeatures * 4) + Align(m_rows * 4) + m_rows * 2;
+    }
+
+    bool Write(const std::string &path) const
+    {
+        // Flows in key order, each one's rows contiguous
+        std::vector<size_t> order;
+        order.reserve(m_byKey.size());
+        for (const auto &e : m_byKey) order.push_back(e.second);
+
+        Header h;
+        std::memset(&h, 0, sizeof(h));
+        std::memcpy(h.magic, "FTNS", 4);
+        h.version = kVersion;
+        h.features = kFeatures;
+        h.flows = m_flows.size();
+        h.rows = m_rows;
+        h.windowSize = m_windowSize;
+        h.namesOffset = Align(sizeof(Header));
+        h.indexOffset = h.namesOffset + Align(kFeatures * 32);
+        h.dataOffset = h.indexOffset + Align(m_flows.size() * sizeof(IndexEntry));
+        h.windowOffset = h.dataOffset + Align(m_rows * kFeatures * 4);
+        h.labelOffset = h.windowOffset + Align(m_rows * 4);
+        std::strncpy(h.scenarioId, m_scenarioId.c_str(), sizeof(h.scenarioId) - 1);
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+        Pad(out, sizeof(h));
+
+        char names[kFeatures][32];
+        std::memset(names, 0, sizeof(names));
+        for (uint32_t i = 0; i < kFeatures; ++i) std::strncpy(names[i], FeatureName(i), 31);
+        out.write(&names[0][0], sizeof(names));
+        Pad(out, sizeof(names));
+
+        uint64_t firstRow = 0;
+        for (size_t i : order)
+        {
+            const FlowBuffer &f = m_flows[i];
+            IndexEntry e;
+            std::memset(&e, 0, sizeof(e));
+            e.firstRow = firstRow;
+            e.src = f.key.src.Get();
+            e.dst = f.key.dst.Get();
+            e.srcPort = f.key.srcPort;
+            e.dstPort = f.key.dstPort;
+            e.windows = static_cast<uint32_t>(f.windows.size());
+            e.firstWindow = f.windows.empty() ? 0 : f.windows.front();
+            e.protocol = f.key.protocol;
+            for (size_t k = 0; k < f.labels.size(); k += 2) e.anyAttack |= f.labels[k];
+            out.write(reinterpret_cast<const char *>(&e), sizeof(e));
+            firstRow += f.windows.size();
+        }
+        Pad(out, m_flows.size() * sizeof(IndexEntry));
+
+        for (size_t i : order) Append(out, m_flows[i].values);
+        Pad(out, m_rows * kFeatures * 4);
+        for (size_t i : order) Append(out, m_flows[i].windows);
+        Pad(out, m_rows * 4);
+        for (size_t i : order) Append(out, m_flows[i].labels);
+        return static_cast<bool>(out.flush());
+    }
+
+  private:
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t features;
+        uint32_t reserved;
+        uint64_t flows;
+        uint64_t rows;
+        double windowSize;
+        uint64_t namesOffset;
+        uint64_t indexOffset;
+        uint64_t dataOffset;
+        uint64_t windowOffset;
+        uint64_t labelOffset;
+        char scenarioId[48];
+    };
+
+    struct IndexEntry
+    {
+        uint64_t firstRow;
+        uint32_t src;
+        uint32_t dst;
+        uint16_t srcPort;
+        uint16_t dstPort;
+        uint32_t windows;
+        uint32_t firstWindow;
+        uint8_t protocol;
+        uint8_t anyAttack;
+        uint16_t pad;
+    };
+
+    static_assert(sizeof(Header) == 128, "FlowTensorWriter header layout changed");
+    static_assert(sizeof(IndexEntry) == 32, "FlowTensorWriter index layout changed");
+
+    struct FlowBuffer
+    {
+        FlowKey key;
+        std::vector<float> values; // windows x kFeatures
+        std::vector<uint32_t> windows;
+        std::vector<uint8_t> labels; // windows x 2
+    };
+
+    static uint64_t Align(uint64_t n) { return (n + 63) & ~uint64_t(63); }
+
+    static void Pad(std::ofstream &out, uint64_t written)
+    {
+        static const char zeros[64] = {};
+        out.write(zeros, Align(written) - written);
+    }
+
+    template <typename T>
+    static void Append(std::ofstream &out, const std::vector<T> &v)
+    {
+        out.write(reinterpret_cast<const char *>(v.data()), v.size() * sizeof(T));
+    }
+
+    bool m_enabled = false;
+    std::string m_scenarioId;
+    double m_windowSize = 1.0;
+    std::map<FlowKey, size_t> m_byKey;
+    std::vector<FlowBuffer> m_flows; // in first-seen order; Write() reorders by key
+    uint64_t m_rows = 0;
+};
+
+} // namespace ns3
+
+#endif // FLOW_TENSOR_WRITER_H
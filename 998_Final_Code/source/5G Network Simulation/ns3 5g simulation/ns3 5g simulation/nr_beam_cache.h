@@ -0,0 +1,212 @@
+// nr_beam_cache.h - Persistent beamforming cache for static NR runs
+// CachedDirectPathBeamforming returns the same vectors as DirectPathBeamforming but looks
+// them up first in a process-wide store keyed by (gNB position, UE position, band config,
+// antenna sizes). The store is loaded from and saved to a small binary file, so
+// repetitions of a static scenario with the same geometry reuse the weights instead of
+// recomputing them. Positions are quantised to millimetres; anything that moves simply
+// misses the cache and falls back to DirectPathBeamforming.
+
+#ifndef NR_BEAM_CACHE_H
+#define NR_BEAM_CACHE_H
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/nr-module.h"
+
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <tuple>
+
+namespace ns3
+{
+
+class BeamCacheStore
+{
+  public:
+    // band hash, gNB x/y/z (mm), UE x/y/z (mm), gNB elements, UE elements
+    using Key = std::tuple<uint64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, uint32_t, uint32_t>;
+
+    static BeamCacheStore &Get()
+    {
+        static BeamCacheStore store;
+        return store;
+    }
+
+    // bandKey identifies everything besides geometry that shapes the weights (frequency,
+    // bandwidth, numerology, antenna layout); entries saved under another key are ignored
+    void Open(const std::string &path, const std::string &bandKey)
+    {
+        m_path = path;
+        // FNV-1a, so the key is stable across builds and standard libraries
+        m_band = 14695981039346656037ULL;
+        for (unsigned char c : bandKey) m_band = (m_band ^ c) * 1099511628211ULL;
+        m_entries.clear();
+        m_hits = m_misses = 0;
+
+        FILE *f = std::fopen(path.c_str(), "rb");
+        if (!f) return; // first run for this geometry
+        char magic[4];
+        uint64_t count = 0;
+        if (std::fread(magic, 1, 4, f) == 4 && std::string(magic, 4) == "BFC1" && std::fread(&count, 8, 1, f) == 1)
+        {
+            for (uint64_t n = 0; n < count; ++n)
+            {
+                Key key;
+                BeamformingVectorPair value;
+                if (!ReadKey(f, key) || !ReadVector(f, value.first) || !ReadVector(f, value.second)) break;
+                if (std::get<0>(key) == m_band) m_entries[key] = value;
+            }
+        }
+        std::fclose(f);
+        m_loaded = m_entries.size();
+    }
+
+    bool IsOpen() const { return !m_path.empty(); }
+
+    const BeamformingVectorPair *Find(const Key &key)
+    {
+        auto it = m_entries.find(key);
+        if (it == m_entries.end())
+        {
+            m_misses++;
+            return nullptr;
+        }
+        m_hits++;
+        return &it->second;
+    }
+
+    void Insert(const Key &key, const BeamformingVectorPair &value) { m_entries[key] = value; }
+
+    // Rewrite the file only if this run added entries
+    void Save() const
+    {
+        if (m_path.empty() || m_entries.size() == m_loaded) return;
+        FILE *f = std::fopen(m_path.c_str(), "wb");
+        if (!f) return;
+        uint64_t count = m_entries.size();
+        std::fwrite("BFC1", 1, 4, f);
+        std::fwrite(&count, 8, 1, f);
+        for (const auto &kv : m_entries)
+        {
+            WriteKey(f, kv.first);
+            WriteVector(f, kv.second.first);
+            WriteVector(f, kv.second.second);
+        }
+        std::fclose(f);
+    }
+
+    uint64_t GetHits() const { return m_hits; }
+    uint64_t GetMisses() const { return m_misses; }
+    uint64_t GetLoaded() const { return m_loaded; }
+    uint64_t GetBandHash() const { return m_band; }
+
+  private:
+    static void WriteKey(FILE *f, const Key &k)
+    {
+        uint64_t band = std::get<0>(k);
+        int64_t pos[6] = {std::get<1>(k), std::get<2>(k), std::get<3>(k), std::get<4>(k), std::get<5>(k), std::get<6>(k)};
+        uint32_t elems[2] = {std::get<7>(k), std::get<8>(k)};
+        std::fwrite(&band, 8, 1, f);
+        std::fwrite(pos, 8, 6, f);
+        std::fwrite(elems, 4, 2, f);
+    }
+
+    static bool ReadKey(FILE *f, Key &k)
+    {
+        uint64_t band;
+        int64_t pos[6];
+        uint32_t elems[2];
+        if (std::fread(&band, 8, 1, f) != 1 || std::fread(pos, 8, 6, f) != 6 || std::fread(elems, 4, 2, f) != 2) return false;
+        k = Key(band, pos[0], pos[1], pos[2], pos[3], pos[4], pos[5], elems[0], elems[1]);
+        return true;
+    }
+
+    static void WriteVector(FILE *f, const BeamformingVector &v)
+    {
+        uint32_t n = static_cast<uint32_t>(v.first.GetSize());
+        uint16_t sector = v.second.GetSector();
+        double elevation = v.second.GetElevation();
+        std::fwrite(&n, 4, 1, f);
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            double re = v.first[i].real();
+            double im = v.first[i].imag();
+            std::fwrite(&re, 8, 1, f);
+            std::fwrite(&im, 8, 1, f);
+        }
+        std::fwrite(&sector, 2, 1, f);
+        std::fwrite(&elevation, 8, 1, f);
+    }
+
+    static bool ReadVector(FILE *f, BeamformingVector &v)
+    {
+        uint32_t n;
+        if (std::fread(&n, 4, 1, f) != 1 || n > 4096) return false;
+        PhasedArrayModel::ComplexVector weights(n);
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            double ri[2];
+            if (std::fread(ri, 8, 2, f) != 2) return false;
+            weights[i] = std::complex<double>(ri[0], ri[1]);
+        }
+        uint16_t sector;
+        double elevation;
+        if (std::fread(&sector, 2, 1, f) != 1 || std::fread(&elevation, 8, 1, f) != 1) return false;
+        v = BeamformingVector(weights, BeamId(sector, elevation));
+        return true;
+    }
+
+    std::string m_path;
+    uint64_t m_band = 0;
+    std::map<Key, BeamformingVectorPair> m_entries;
+    uint64_t m_loaded = 0;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+};
+
+class CachedDirectPathBeamforming : public DirectPathBeamforming
+{
+  public:
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::CachedDirectPathBeamforming")
+                                .SetParent<DirectPathBeamforming>()
+                                .SetGroupName("Nr")
+                                .AddConstructor<CachedDirectPathBeamforming>();
+        return tid;
+    }
+
+    BeamformingVectorPair GetBeamformingVectors(const Ptr<NrSpectrumPhy> &gnbSpectrumPhy,
+                                                const Ptr<NrSpectrumPhy> &ueSpectrumPhy) const override
+    {
+        BeamCacheStore &store = BeamCacheStore::Get();
+        if (!store.IsOpen()) return DirectPathBeamforming::GetBeamformingVectors(gnbSpectrumPhy, ueSpectrumPhy);
+
+        Vector g = gnbSpectrumPhy->GetMobility()->GetPosition();
+        Vector u = ueSpectrumPhy->GetMobility()->GetPosition();
+        BeamCacheStore::Key key(store.GetBandHash(), Mm(g.x), Mm(g.y), Mm(g.z), Mm(u.x), Mm(u.y), Mm(u.z),
+                                 Elems(gnbSpectrumPhy), Elems(ueSpectrumPhy));
+        if (const BeamformingVectorPair *hit = store.Find(key)) return *hit;
+
+        BeamformingVectorPair computed = DirectPathBeamforming::GetBeamformingVectors(gnbSpectrumPhy, ueSpectrumPhy);
+        store.Insert(key, computed);
+        return computed;
+    }
+
+  private:
+    static int64_t Mm(double metres) { return static_cast<int64_t>(std::llround(metres * 1000.0)); }
+
+    static uint32_t Elems(const Ptr<NrSpectrumPhy> &phy)
+    {
+        Ptr<PhasedArrayModel> antenna = DynamicCast<PhasedArrayModel>(phy->GetAntenna());
+        return antenna ? static_cast<uint32_t>(antenna->GetNumElems()) : 0;
+    }
+};
+
+NS_OBJECT_ENSURE_REGISTERED(CachedDirectPathBeamforming);
+
+} // namespace ns3
+
+#endif // NR_BEAM_CACHE_H
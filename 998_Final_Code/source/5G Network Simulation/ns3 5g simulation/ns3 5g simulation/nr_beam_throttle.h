@@ -0,0 +1,200 @@
+// nr_beam_throttle.h - Update policy for beamforming in mobile NR runs
+// IdealBeamformingHelper recomputes DirectPathBeamforming for every gNB-UE pair on each
+// BeamformingPeriodicity tick, although a UE walking at 1-3 m/s barely moves between ticks.
+// ThrottledDirectPathBeamforming keeps the last vectors per pair and only recomputes when
+// the policy says so:
+//   always       - every tick (DirectPathBeamforming behaviour)
+//   period       - at most once per MinPeriod
+//   displacement - once the UE has moved MinDisplacement metres since the last update
+//   angle        - once the gNB->UE direction has turned by MinAngle degrees
+// Every AuditEvery-th skipped update also computes fresh vectors (outside the timed path)
+// and records how well the reused gNB beam still matches, so the accuracy cost is
+// reported by the same run that reports the savings.
+
+#ifndef NR_BEAM_THROTTLE_H
+#define NR_BEAM_THROTTLE_H
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/nr-module.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <map>
+#include <string>
+#include <utility>
+
+namespace ns3
+{
+
+class BeamUpdatePolicy
+{
+  public:
+    enum Mode
+    {
+        ALWAYS,
+        PERIOD,
+        DISPLACEMENT,
+        ANGLE,
+    };
+
+    struct Stats
+    {
+        uint64_t calls = 0;
+        uint64_t computed = 0;
+        uint64_t skipped = 0;
+        uint64_t computeNs = 0; // wall time spent in DirectPathBeamforming on computed updates
+        uint64_t audits = 0;
+        double correlationSum = 0.0;
+        double correlationMin = 1.0;
+    };
+
+    static BeamUpdatePolicy &Get()
+    {
+        static BeamUpdatePolicy policy;
+        return policy;
+    }
+
+    // Returns false for an unknown mode name
+    bool Configure(const std::string &mode, Time minPeriod, double minDisplacement, double minAngleDeg,
+                   uint32_t auditEvery)
+    {
+        if (mode == "always") m_mode = ALWAYS;
+        else if (mode == "period") m_mode = PERIOD;
+        else if (mode == "displacement") m_mode = DISPLACEMENT;
+        else if (mode == "angle") m_mode = ANGLE;
+        else return false;
+        m_minPeriod = minPeriod;
+        m_minDisplacement = minDisplacement;
+        m_minAngleRad = minAngleDeg * M_PI / 180.0;
+        m_auditEvery = auditEvery;
+        return true;
+    }
+
+    Mode GetMode() const { return m_mode; }
+    const Stats &GetStats() const { return m_stats; }
+
+    // Estimated wall time the skipped updates would have cost, at the measured mean
+    double GetSavedSeconds() const
+    {
+        if (m_stats.computed == 0) return 0.0;
+        return 1e-9 * m_stats.computeNs / m_stats.computed * m_stats.skipped;
+    }
+
+  private:
+    friend class ThrottledDirectPathBeamforming;
+
+    struct PairState
+    {
+        Time lastUpdate;
+        Vector gnbPos;
+        Vector uePos;
+        BeamformingVectorPair vectors;
+        uint64_t skipsSinceAudit = 0;
+    };
+
+    bool NeedsUpdate(const PairState &s, const Vector &gnb, const Vector &ue) const
+    {
+        switch (m_mode)
+        {
+        case PERIOD:
+            return Simulator::Now() - s.lastUpdate >= m_minPeriod;
+        case DISPLACEMENT:
+            return CalculateDistance(ue, s.uePos) >= m_minDisplacement;
+        case ANGLE: {
+            double before = std::atan2(s.uePos.y - s.gnbPos.y, s.uePos.x - s.gnbPos.x);
+            double now = std::atan2(ue.y - gnb.y, ue.x - gnb.x);
+            double diff = std::fabs(std::remainder(now - before, 2.0 * M_PI));
+            return diff >= m_minAngleRad;
+        }
+        default:
+            return true;
+        }
+    }
+
+    // |<a, b>|^2 / (|a|^2 |b|^2): 1 when the reused beam still points the same way
+    static double Correlation(const PhasedArrayModel::ComplexVector &a, const PhasedArrayModel::ComplexVector &b)
+    {
+        if (a.GetSize() != b.GetSize() || a.GetSize() == 0) return 0.0;
+        std::complex<double> dot = 0.0;
+        double na = 0.0;
+        double nb = 0.0;
+        for (size_t i = 0; i < a.GetSize(); ++i)
+        {
+            dot += std::conj(a[i]) * b[i];
+            na += std::norm(a[i]);
+            nb += std::norm(b[i]);
+        }
+        return na > 0.0 && nb > 0.0 ? std::norm(dot) / (na * nb) : 0.0;
+    }
+
+    Mode m_mode = ALWAYS;
+    Time m_minPeriod;
+    double m_minDisplacement = 1.0;
+    double m_minAngleRad = 0.0;
+    uint32_t m_auditEvery = 0;
+    std::map<std::pair<const NrSpectrumPhy *, const NrSpectrumPhy *>, PairState> m_pairs;
+    Stats m_stats;
+};
+
+class ThrottledDirectPathBeamforming : public DirectPathBeamforming
+{
+  public:
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::ThrottledDirectPathBeamforming")
+                                .SetParent<DirectPathBeamforming>()
+                                .SetGroupName("Nr")
+                                .AddConstructor<ThrottledDirectPathBeamforming>();
+        return tid;
+    }
+
+    BeamformingVectorPair GetBeamformingVectors(const Ptr<NrSpectrumPhy> &gnbSpectrumPhy,
+                                                const Ptr<NrSpectrumPhy> &ueSpectrumPhy) const override
+    {
+        BeamUpdatePolicy &policy = BeamUpdatePolicy::Get();
+        BeamUpdatePolicy::Stats &stats = policy.m_stats;
+        stats.calls++;
+
+        Vector gnb = gnbSpectrumPhy->GetMobility()->GetPosition();
+        Vector ue = ueSpectrumPhy->GetMobility()->GetPosition();
+        auto key = std::make_pair(PeekPointer(gnbSpectrumPhy), PeekPointer(ueSpectrumPhy));
+        auto it = policy.m_pairs.find(key);
+
+        if (it != policy.m_pairs.end() && !policy.NeedsUpdate(it->second, gnb, ue))
+        {
+            BeamUpdatePolicy::PairState &s = it->second;
+            stats.skipped++;
+            if (policy.m_auditEvery > 0 && ++s.skipsSinceAudit >= policy.m_auditEvery)
+            {
+                s.skipsSinceAudit = 0;
+                BeamformingVectorPair fresh = DirectPathBeamforming::GetBeamformingVectors(gnbSpectrumPhy, ueSpectrumPhy);
+                double c = BeamUpdatePolicy::Correlation(s.vectors.first.first, fresh.first.first);
+                stats.audits++;
+                stats.correlationSum += c;
+                stats.correlationMin = std::min(stats.correlationMin, c);
+            }
+            return s.vectors;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        BeamformingVectorPair computed = DirectPathBeamforming::GetBeamformingVectors(gnbSpectrumPhy, ueSpectrumPhy);
+        stats.computeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        stats.computed++;
+
+        BeamUpdatePolicy::PairState &s = policy.m_pairs[key];
+        s.lastUpdate = Simulator::Now();
+        s.gnbPos = gnb;
+        s.uePos = ue;
+        s.vectors = computed;
+        return computed;
+    }
+};
+
+NS_OBJECT_ENSURE_REGISTERED(ThrottledDirectPathBeamforming);
+
+} // namespace ns3
+
+#endif // NR_BEAM_THROTTLE_H
@@ -11,8 +11,25 @@
 #include "ns3/nr-module.h"
 #include "ns3/netanim-module.h"
 
+#include "cell_sampler.h"
+#include "class_balancer.h"
+#include "ddos_flood_app.h"
+#include "flow_tensor_writer.h"
+#include "flow_window_sampler.h"
+#include "nr_beam_cache.h"
+#include "nr_beam_throttle.h"
+#include "nr_radio_kpi.h"
+#include "run_manifest.h"
+#include "scoped_trace.h"
+#include "trajectory_mobility.h"
+#include "window_socket_sink.h"
+#include "window_stream.h"
+
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <fstream>
+#include <iostream>
 #include <map>
 #include <random>
 #include <set>
@@ -22,38 +39,33 @@ using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("NrDdosDataset");
 
-struct FlowKey
+static FlowWindowSampler g_sampler;
+static CellSampler g_cells; // per-serving-cell partition of g_sampler (multi-gNB only)
+static bool g_multiCell = false;
+static RunManifest g_manifest; // JSON sidecar with the run's cost
+static NrRadioKpiCollector g_radio; // per-UE SINR/MCS/PRB/HARQ/RLC, keyed by UE address
+static bool g_radioKpis = false;
+static WindowSocketSink g_sink; // live rows to a local scorer (--sinkSocket)
+static FlowTensorWriter g_tensors; // per-flow float32 matrices (--tensors)
+static WindowStreamWriter g_stream; // delta-encoded, block-compressed rows (--output=dws|both)
+static bool g_writeCsv = true; // --output=csv|both
+
+// A row the class balancer holds until run end, with the per-window state it is formatted from
+struct HeldRow
 {
-    Ipv4Address src;
-    Ipv4Address dst;
-    uint16_t srcPort;
-    uint16_t dstPort;
-    uint8_t protocol; // 6 TCP, 17 UDP
-
-    bool operator<(const FlowKey &other) const
-    {
-        if (src != other.src) return src < other.src;
-        if (dst != other.dst) return dst < other.dst;
-        if (srcPort != other.srcPort) return srcPort < other.srcPort;
-        if (dstPort != other.dstPort) return dstPort < other.dstPort;
-        return protocol < other.protocol;
-    }
+    WindowRow row;
+    double timeStart;
+    double timeEnd;
+    bool attack;
+    uint16_t cellId;
+    RadioWindow src;
+    RadioWindow dst;
 };
-
-struct FlowSnapshot
-{
-    uint64_t txPackets = 0;
-    uint64_t rxPackets = 0;
-    uint64_t txBytes = 0;
-    uint64_t rxBytes = 0;
-    uint64_t lostPackets = 0;
-    double delaySum = 0.0;  // seconds
-    double jitterSum = 0.0; // seconds
-};
-
-static std::map<FlowKey, FlowSnapshot> g_prev;
+static ClassBalancer<HeldRow> g_balancer; // per-class row budgets, weight column (--balance)
 static std::ofstream g_out;
 static double g_windowStart = 0.0;
+static uint64_t g_windowIndex = 0;
+static double g_lastFlush = 0.0;
 static double g_windowSize = 1.0; // seconds
 static std::string g_scenarioId;
 static uint32_t g_ueTotal = 0;
@@ -62,6 +74,9 @@ static bool g_labelIntensity = false;
 static std::string g_labelMode = "binary"; // binary|intensity
 static std::map<uint32_t, bool> g_isServer;
 
+static std::chrono::steady_clock::time_point g_firstSecondWall; // wall clock when sim time reaches 1 s
+static bool g_firstSecondMarked = false; // false when simTime < 1 s
+
 static Ptr<Ipv4FlowClassifier> g_classifier;
 static Ptr<FlowMonitor> g_monitor;
 
@@ -76,122 +91,218 @@ static int IntensityToLabel(const Time &attackInterval)
     return 1; // low
 }
 
+// Column names, shared by the CSV header and the window stream's schema
+static std::vector<std::string> CsvColumns()
+{
+    std::vector<std::string> columns = {
+        "time_start", "time_end", "scenario_id", "ue_total", "attackers",
+        "src_ip", "dst_ip", "src_port", "dst_port", "protocol", "packet_size",
+        "flow_duration", "total_bytes_fwd", "total_bytes_bwd", "total_pkts_fwd", "total_pkts_bwd",
+        "pkts_per_sec", "bytes_per_sec", "flow_pkts_per_sec", "flow_bytes_per_sec",
+        "jitter_ms", "delay_ms", "label_binary", "label_intensity"};
+    if (g_multiCell)
+    {
+        columns.push_back("cell_id");
+    }
+    if (g_radioKpis)
+    {
+        // Uplink side of the sender, downlink side of the receiver
+        columns.insert(columns.end(), {"src_ul_sinr_db", "src_ul_mcs", "src_ul_prbs", "src_ul_harq_retx",
+                                       "src_rlc_backlog_bytes", "src_rlc_drops"});
+        columns.insert(columns.end(), {"dst_dl_sinr_db", "dst_dl_mcs", "dst_dl_prbs", "dst_dl_harq_retx",
+                                       "dst_rlc_backlog_bytes"});
+    }
+    if (g_balancer.IsEnabled())
+    {
+        columns.push_back("weight");
+    }
+    return columns;
+}
+
 static void WriteCsvHeader()
 {
-    g_out << "time_start,time_end,scenario_id,ue_total,attackers,";
-    g_out << "src_ip,dst_ip,src_port,dst_port,protocol,packet_size,";
-    g_out << "flow_duration,total_bytes_fwd,total_bytes_bwd,total_pkts_fwd,total_pkts_bwd,";
-    g_out << "pkts_per_sec,bytes_per_sec,flow_pkts_per_sec,flow_bytes_per_sec,";
-    g_out << "jitter_ms,delay_ms,label_binary,label_intensity\n";
+    std::vector<std::string> columns = CsvColumns();
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        g_out << (i ? "," : "") << columns[i];
+    }
+    g_out << "\n";
 }
 
-static void SampleAndWrite()
+static void FormatRow(const WindowRow &r, double timeStart, double timeEnd, bool attackBinary, uint16_t cellId,
+                      const RadioWindow &s, const RadioWindow &d, double weight)
 {
-    // Poll current stats
-    g_monitor->CheckForLostPackets();
-    auto stats = g_monitor->GetFlowStats();
-
-    std::map<FlowKey, FlowSnapshot> current;
-
-    for (const auto &kv : stats)
-    {
-        FlowId id = kv.first;
-        const FlowMonitor::FlowStats &st = kv.second;
-        Ipv4FlowClassifier::FiveTuple t = g_classifier->FindFlow(id);
-
-        FlowKey key{t.sourceAddress, t.destinationAddress, t.sourcePort, t.destinationPort, t.protocol};
-        FlowSnapshot snap;
-        snap.txPackets = st.txPackets;
-        snap.rxPackets = st.rxPackets;
-        snap.txBytes = st.txBytes;
-        snap.rxBytes = st.rxBytes;
-        snap.lostPackets = st.lostPackets;
-        snap.delaySum = st.delaySum.GetSeconds();
-        snap.jitterSum = st.jitterSum.GetSeconds();
-        current[key] = snap;
-    }
-
-    // For each forward flow, find reverse to compute bwd
-    for (const auto &kv : current)
-    {
-        const FlowKey &fwdKey = kv.first;
-        const FlowSnapshot &curFwd = kv.second;
-
-        FlowKey revKey{fwdKey.dst, fwdKey.src, fwdKey.dstPort, fwdKey.srcPort, fwdKey.protocol};
-        FlowSnapshot curBwd = current.count(revKey) ? current[revKey] : FlowSnapshot{};
-
-        FlowSnapshot prevFwd = g_prev.count(fwdKey) ? g_prev[fwdKey] : FlowSnapshot{};
-        FlowSnapshot prevBwd = g_prev.count(revKey) ? g_prev[revKey] : FlowSnapshot{};
-
-        uint64_t dTxPktsF = curFwd.txPackets - prevFwd.txPackets;
-        uint64_t dRxPktsF = curFwd.rxPackets - prevFwd.rxPackets;
-        uint64_t dTxBytesF = curFwd.txBytes - prevFwd.txBytes;
-        uint64_t dRxBytesF = curFwd.rxBytes - prevFwd.rxBytes;
-
-        uint64_t dTxPktsB = curBwd.txPackets - prevBwd.txPackets;
-        uint64_t dRxPktsB = curBwd.rxPackets - prevBwd.rxPackets;
-        uint64_t dTxBytesB = curBwd.txBytes - prevBwd.txBytes;
-        uint64_t dRxBytesB = curBwd.rxBytes - prevBwd.rxBytes;
-
-        uint64_t totalPktsFwd = dTxPktsF + dRxPktsF;
-        uint64_t totalPktsBwd = dTxPktsB + dRxPktsB;
-        uint64_t totalBytesFwd = dTxBytesF + dRxBytesF;
-        uint64_t totalBytesBwd = dTxBytesB + dRxBytesB;
-
-        double duration = g_windowSize;
-        double pktsPerSec = (totalPktsFwd + totalPktsBwd) / duration;
-        double bytesPerSec = (totalBytesFwd + totalBytesBwd) / duration;
-        double flowPktsPerSec = totalPktsFwd / duration;
-        double flowBytesPerSec = totalBytesFwd / duration;
-
-        double avgDelayMs = 0.0;
-        double avgJitterMs = 0.0;
-        uint64_t dRxPktsAll = dRxPktsF + dRxPktsB;
-        double dDelay = (curFwd.delaySum + curBwd.delaySum) - (prevFwd.delaySum + prevBwd.delaySum);
-        double dJitter = (curFwd.jitterSum + curBwd.jitterSum) - (prevFwd.jitterSum + prevBwd.jitterSum);
-        if (dRxPktsAll > 0)
-        {
-            avgDelayMs = 1000.0 * dDelay / static_cast<double>(dRxPktsAll);
-            avgJitterMs = 1000.0 * dJitter / static_cast<double>(dRxPktsAll);
-        }
+    int attackIntensity = attackBinary ? 3 : 0;
+    g_out << timeStart << "," << timeEnd << "," << g_scenarioId << "," << g_ueTotal << ","
+          << g_attackers.size() << ",";
+    g_out << r.key.src << "," << r.key.dst << "," << r.key.srcPort << "," << r.key.dstPort << ","
+          << unsigned(r.key.protocol) << "," << r.avgPktSize << ",";
+    g_out << r.duration << "," << r.totalBytesFwd << "," << r.totalBytesBwd << "," << r.totalPktsFwd << ","
+          << r.totalPktsBwd << ",";
+    g_out << r.pktsPerSec << "," << r.bytesPerSec << "," << r.flowPktsPerSec << "," << r.flowBytesPerSec << ",";
+    g_out << r.avgJitterMs << "," << r.avgDelayMs << "," << (attackBinary ? 1 : 0) << "," << attackIntensity;
+    if (g_multiCell)
+    {
+        g_out << "," << cellId;
+    }
+    if (g_radioKpis)
+    {
+        g_out << "," << s.ulSinrDb << "," << s.ulMcs << "," << s.ulPrbs << "," << s.ulHarqRetx << ","
+              << s.ulRlcBacklog << "," << s.rlcDrops;
+        g_out << "," << d.dlSinrDb << "," << d.dlMcs << "," << d.dlPrbs << "," << d.dlHarqRetx << ","
+              << d.dlRlcBacklog;
+    }
+    if (g_balancer.IsEnabled())
+    {
+        g_out << "," << weight;
+    }
+    g_out << "\n";
+}
+
+// The row FormatRow() writes, as deltas against the flow's previous row (window_stream.h)
+static void EncodeRow(const WindowRow &r, double timeStart, double timeEnd, bool attackBinary, uint16_t cellId,
+                      const RadioWindow &s, const RadioWindow &d, double weight)
+{
+    g_stream.BeginRow(timeStart, timeEnd, r.key.src.Get(), r.key.dst.Get(), r.key.srcPort, r.key.dstPort,
+                      r.key.protocol);
+    g_stream.Float(r.avgPktSize);
+    g_stream.Float(r.duration);
+    g_stream.Int(r.totalBytesFwd);
+    g_stream.Int(r.totalBytesBwd);
+    g_stream.Int(r.totalPktsFwd);
+    g_stream.Int(r.totalPktsBwd);
+    g_stream.Float(r.pktsPerSec);
+    g_stream.Float(r.bytesPerSec);
+    g_stream.Float(r.flowPktsPerSec);
+    g_stream.Float(r.flowBytesPerSec);
+    g_stream.Float(r.avgJitterMs);
+    g_stream.Float(r.avgDelayMs);
+    g_stream.Int(attackBinary ? 1 : 0);
+    g_stream.Int(attackBinary ? 3 : 0);
+    if (g_multiCell)
+    {
+        g_stream.Int(cellId);
+    }
+    if (g_radioKpis)
+    {
+        g_stream.Float(s.ulSinrDb);
+        g_stream.Float(s.ulMcs);
+        g_stream.Int(s.ulPrbs);
+        g_stream.Int(s.ulHarqRetx);
+        g_stream.Int(s.ulRlcBacklog);
+        g_stream.Int(s.rlcDrops);
+        g_stream.Float(d.dlSinrDb);
+        g_stream.Float(d.dlMcs);
+        g_stream.Int(d.dlPrbs);
+        g_stream.Int(d.dlHarqRetx);
+        g_stream.Int(d.dlRlcBacklog);
+    }
+    if (g_balancer.IsEnabled())
+    {
+        g_stream.Float(weight);
+    }
+    g_stream.EndRow();
+}
 
-        // Label: if the source UE is in attackers set, mark attack
-        // Extract UE index from IPv4: EPC helper assigns 7.X.Y.Z; we cannot parse UE index reliably here,
-        // so approximate by checking src/dst membership using an external map would be better.
-        // For practicality, we label by rate: if packets/sec from a single source exceed threshold, flag as attack.
-        bool attackBinary = (flowPktsPerSec > 5000.0); // heuristic for high-rate DDoS
-        int attackIntensity = attackBinary ? 3 : 0;
-
-        // Packet size: average in window
-        double avgPktSize = 0.0;
-        uint64_t pktsAll = totalPktsFwd + totalPktsBwd;
-        if (pktsAll > 0)
+// Writes a row to the CSV and/or the window stream, per --output
+static void EmitRow(const WindowRow &r, double timeStart, double timeEnd, bool attackBinary, uint16_t cellId,
+                    const RadioWindow &s, const RadioWindow &d, double weight)
+{
+    if (g_writeCsv) FormatRow(r, timeStart, timeEnd, attackBinary, cellId, s, d, weight);
+    if (g_stream.IsOpen()) EncodeRow(r, timeStart, timeEnd, attackBinary, cellId, s, d, weight);
+}
+
+// Labels a row, hands it to the live consumers and, unless the class balancer skips or holds
+// it, formats it. Returns true if the row was written now.
+static bool WriteRow(const WindowRow &r, double timeEnd, uint16_t cellId)
+{
+    // Label: if the source UE is in attackers set, mark attack
+    // Extract UE index from IPv4: EPC helper assigns 7.X.Y.Z; we cannot parse UE index reliably here,
+    // so approximate by checking src/dst membership using an external map would be better.
+    // For practicality, we label by rate: if packets/sec from a single source exceed threshold, flag as attack.
+    bool attackBinary = (r.flowPktsPerSec > 5000.0); // heuristic for high-rate DDoS
+    int attackIntensity = attackBinary ? 3 : 0;
+    if (g_sink.IsOpen()) g_sink.AddRow(r, attackBinary, attackIntensity);
+    if (g_tensors.IsEnabled()) g_tensors.AddRow(r, g_windowIndex, attackBinary, attackIntensity);
+
+    static const RadioWindow noRadio;
+    const RadioWindow &s = g_radioKpis ? g_radio.Find(r.key.src) : noRadio;
+    const RadioWindow &d = g_radioKpis ? g_radio.Find(r.key.dst) : noRadio;
+    double weight = 1.0;
+    if (g_balancer.IsEnabled())
+    {
+        HeldRow *slot = nullptr;
+        switch (g_balancer.Offer(attackBinary, slot, weight))
         {
-            avgPktSize = static_cast<double>(totalBytesFwd + totalBytesBwd) / static_cast<double>(pktsAll);
+        case ClassBalancer<HeldRow>::SKIP:
+            return false;
+        case ClassBalancer<HeldRow>::HOLD:
+            *slot = HeldRow{r, g_windowStart, timeEnd, attackBinary, cellId, s, d};
+            return false;
+        case ClassBalancer<HeldRow>::WRITE:
+            break;
         }
+    }
+    EmitRow(r, g_windowStart, timeEnd, attackBinary, cellId, s, d, weight);
+    return true;
+}
+
+static void MarkFirstSecond()
+{
+    g_firstSecondWall = std::chrono::steady_clock::now();
+    g_firstSecondMarked = true;
+}
 
-        double timeEnd = g_windowStart + g_windowSize;
+static void SampleAndWrite()
+{
+    TRACE_SCOPE("SampleAndWrite");
+    // Window bounds from the index so fine windows (10-100 ms) do not accumulate rounding error
+    g_windowStart = g_windowIndex * g_windowSize;
+    double timeEnd = (g_windowIndex + 1) * g_windowSize;
+    auto sampleStart = std::chrono::steady_clock::now();
+    uint64_t rows = 0;
+
+    if (g_radioKpis)
+    {
+        TRACE_SCOPE("radio_kpis");
+        g_radio.CloseWindow();
+    }
 
-        g_out << g_windowStart << "," << timeEnd << "," << g_scenarioId << "," << g_ueTotal << ","
-              << g_attackers.size() << ",";
-        g_out << fwdKey.src << "," << fwdKey.dst << "," << fwdKey.srcPort << "," << fwdKey.dstPort << ","
-              << unsigned(fwdKey.protocol) << "," << avgPktSize << ",";
-        g_out << duration << "," << totalBytesFwd << "," << totalBytesBwd << "," << totalPktsFwd << ","
-              << totalPktsBwd << ",";
-        g_out << pktsPerSec << "," << bytesPerSec << "," << flowPktsPerSec << "," << flowBytesPerSec << ",";
-        g_out << avgJitterMs << "," << avgDelayMs << "," << (attackBinary ? 1 : 0) << "," << attackIntensity << "\n";
+    if (g_multiCell)
+    {
+        g_cells.Sample(g_windowSize,
+                       [timeEnd, &rows](const WindowRow &r, uint16_t cellId) { rows += WriteRow(r, timeEnd, cellId); });
+    }
+    else
+    {
+        g_sampler.Sample(g_windowSize, [timeEnd, &rows](const WindowRow &r) { rows += WriteRow(r, timeEnd, 0); });
+    }
+    if (g_sink.IsOpen())
+    {
+        TRACE_SCOPE("sink");
+        g_sink.EndWindow(g_windowStart, timeEnd);
     }
 
-    g_out.flush();
-    g_prev = std::move(current);
-    g_windowStart += g_windowSize;
+    // Flush at most once per simulated second; sub-second windows would otherwise flush every tick
+    if (timeEnd - g_lastFlush >= 1.0)
+    {
+        TRACE_SCOPE("flush");
+        g_out.flush();
+        g_lastFlush = timeEnd;
+    }
+    g_manifest.AddWindow(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - sampleStart).count(), rows);
+    g_windowIndex++;
 
     Simulator::Schedule(Seconds(g_windowSize), &SampleAndWrite);
 }
 
 int main(int argc, char *argv[])
 {
+    auto wallStart = std::chrono::steady_clock::now();
     uint16_t gNbNum = 1;
+    double gnbSpacing = 120.0; // inter-site distance (m); each gNB sits in the middle of its own square
+    std::string handoverAlgo = "ns3::NrA3RsrpHandoverAlgorithm"; // used when gNbNum > 1
     uint16_t ueTotal = 25;
     bool enableAttack = true;
     bool mobile = true;
@@ -202,32 +313,141 @@ int main(int argc, char *argv[])
     Time appStart = Seconds(0.5);
     Time attackInterval = Seconds(0.0002); // intensity control
     Time benignInterval = Seconds(0.02);
+    std::string trajectoryFile; // precomputed .trj walk replayed instead of RandomWalk2d
+    std::string beamCache; // persistent beamforming cache file (static runs)
+    std::string bfPolicy = "always"; // always|period|displacement|angle (mobile runs)
+    Time bfPeriod = MilliSeconds(500);
+    double bfMinDisplacement = 1.0; // m
+    double bfMinAngle = 2.0; // degrees, seen from the gNB
+    uint32_t bfAudit = 0; // recompute every Nth skipped update to measure beam drift
+    Time channelUpdatePeriod = MilliSeconds(0); // ThreeGppChannelModel refresh; 0 keeps the first realisation
+    bool floodApp = true; // burst-scheduled attacker instead of UdpClient/OnOff
+    uint32_t attackBurst = 10; // packets per scheduled attack event
+    std::string attackProfile = "constant"; // constant|ramp|pulse|onoff|lowslow
+    Time attackRampTime = Seconds(5.0);
+    Time attackPulsePeriod = Seconds(1.0); // shrew: period near the 1 s TCP minRTO
+    Time attackPulseWidth = MilliSeconds(100);
+    Time attackOnTime = Seconds(1.0);
+    Time attackOffTime = Seconds(1.0);
+    DataRate lowSlowRate("64kbps");
+    uint32_t lowSlowSize = 128;
+    uint32_t rlcBufferSize = 999999999; // bytes; lower it to let RLC overflow under attack
+    bool writeManifest = true; // <csv>.manifest.json with events, wall time, RSS, rows
+    uint32_t seed = 0; // 0 = server/client draw from std::random_device, as before
+    std::string scheduler; // empty = ns-3 default (MapScheduler)
+    std::string sinkSocket; // Unix socket of a live scorer; empty = CSV only
+    std::string sinkBackpressure = "block"; // block|drop|sample
+    uint32_t sinkBuffer = 4 << 20; // bytes queued for the scorer before drop/sample kicks in
+    bool tensors = false; // <csv>.ftns with each flow's windows as one float32 matrix
+    std::string balance = "off"; // off|rate|reservoir per-class row selection
+    uint64_t balanceBudget = 5000; // rows kept per class per run (reservoir)
+    double balanceKeepAttack = 1.0; // probability an attack row is kept (rate)
+    double balanceKeepBenign = 1.0; // probability a benign row is kept (rate)
+    std::string output = "csv"; // csv|dws|both: text rows and/or the delta-encoded window stream
+    std::string dwsCodec = "auto"; // auto|raw|lz4|zstd block compression of the window stream
 
     CommandLine cmd;
     cmd.AddValue("ueTotal", "Number of UEs", ueTotal);
+    cmd.AddValue("gnbNum", "Number of gNBs, laid out on a near-square grid", gNbNum);
+    cmd.AddValue("gnbSpacing", "Distance between neighbouring gNBs (m)", gnbSpacing);
+    cmd.AddValue("handoverAlgo", "Handover algorithm TypeId for multi-gNB runs", handoverAlgo);
     cmd.AddValue("mobile", "If true, UEs move (RandomWalk)", mobile);
+    cmd.AddValue("trajectoryFile", "Replay UE movement from a tools/trajectory_gen .trj file (mobile only)", trajectoryFile);
     cmd.AddValue("useTcp", "Use TCP instead of UDP", useTcp);
     cmd.AddValue("enableAttack", "Enable DDoS attackers", enableAttack);
     cmd.AddValue("attackInterval", "Inter-packet interval for attackers", attackInterval);
     cmd.AddValue("benignInterval", "Inter-packet interval for benign clients", benignInterval);
+    cmd.AddValue("floodApp", "Use the burst-scheduled DdosFloodApplication for attackers", floodApp);
+    cmd.AddValue("attackBurst", "Packets per attack event (floodApp only)", attackBurst);
+    cmd.AddValue("attackProfile", "Attack rate profile: constant|ramp|pulse|onoff|lowslow (floodApp only)", attackProfile);
+    cmd.AddValue("attackRampTime", "Time to reach the peak attack rate (ramp)", attackRampTime);
+    cmd.AddValue("attackPulsePeriod", "Attack pulse period (pulse)", attackPulsePeriod);
+    cmd.AddValue("attackPulseWidth", "Peak-rate time at the start of each pulse period (pulse)", attackPulseWidth);
+    cmd.AddValue("attackOnTime", "Attack on phase length (onoff)", attackOnTime);
+    cmd.AddValue("attackOffTime", "Attack off phase length (onoff)", attackOffTime);
+    cmd.AddValue("lowSlowRate", "Per-attacker offered load (lowslow)", lowSlowRate);
+    cmd.AddValue("lowSlowSize", "Attack packet size in bytes (lowslow)", lowSlowSize);
     cmd.AddValue("simTime", "Total simulation time", simTime);
     cmd.AddValue("outPath", "Output folder for CSV", outPath);
     cmd.AddValue("scenarioTag", "Scenario tag for scenario_id and file name", scenarioTag);
     cmd.AddValue("window", "Sampling window size (s)", g_windowSize);
+    cmd.AddValue("beamCache", "Beamforming cache file for static runs, loaded at start and updated at the end", beamCache);
+    cmd.AddValue("bfPolicy", "Beamforming update policy for mobile runs: always|period|displacement|angle", bfPolicy);
+    cmd.AddValue("bfPeriod", "Minimum time between beamforming updates per gNB-UE pair (period)", bfPeriod);
+    cmd.AddValue("bfMinDisplacement", "UE movement in metres that triggers a beamforming update (displacement)", bfMinDisplacement);
+    cmd.AddValue("bfMinAngle", "Change in gNB-UE direction in degrees that triggers an update (angle)", bfMinAngle);
+    cmd.AddValue("bfAudit", "Recompute every Nth skipped update and report beam correlation (0 = off)", bfAudit);
+    cmd.AddValue("channelUpdatePeriod", "ThreeGppChannelModel UpdatePeriod (0 = never refresh)", channelUpdatePeriod);
+    cmd.AddValue("radioKpis", "Append per-UE radio columns (SINR, MCS, PRBs, HARQ retx, RLC backlog)", g_radioKpis);
+    cmd.AddValue("rlcBufferSize", "NrRlcUm MaxTxBufferSize in bytes", rlcBufferSize);
+    cmd.AddValue("seed", "Fix the server/client draw and the ns-3 RNG seed (0 = random draw)", seed);
+    cmd.AddValue("scheduler", "Event scheduler: heap|calendar|map|list|priority or a TypeId (default map)", scheduler);
+    cmd.AddValue("sinkSocket", "Also stream each window's rows to a scorer listening on this Unix socket", sinkSocket);
+    cmd.AddValue("sinkBackpressure", "When the scorer falls behind: block|drop|sample", sinkBackpressure);
+    cmd.AddValue("sinkBuffer", "Bytes queued for the scorer before windows are dropped or sampled", sinkBuffer);
+    cmd.AddValue("tensors", "Also write a .ftns file with each flow's windows as a float32 matrix", tensors);
+    cmd.AddValue("balance", "Per-class row selection before formatting: off|rate|reservoir (adds a weight column)", balance);
+    cmd.AddValue("balanceBudget", "Rows kept per class per run (reservoir)", balanceBudget);
+    cmd.AddValue("balanceKeepAttack", "Probability an attack row is written (rate)", balanceKeepAttack);
+    cmd.AddValue("balanceKeepBenign", "Probability a benign row is written (rate)", balanceKeepBenign);
+    cmd.AddValue("output", "Rows as csv, dws (<csv>.dws delta-encoded stream; tools/window_stream_csv.cc converts) or both",
+                 output);
+    cmd.AddValue("dwsCodec", "Block compression of the .dws stream: auto|raw|lz4|zstd (built with -DDWS_WITH_*)", dwsCodec);
+    cmd.AddValue("manifest", "Write a .manifest.json performance sidecar next to the CSV", writeManifest);
     cmd.Parse(argc, argv);
+    NS_ABORT_MSG_IF(!SelectScheduler(scheduler), "Unknown scheduler " << scheduler);
+    NS_ABORT_MSG_IF(!g_balancer.Configure(balance, balanceBudget, balanceKeepAttack, balanceKeepBenign,
+                                          seed ? seed : std::random_device()()),
+                    "Invalid --balance=" << balance << " (budget " << balanceBudget << ", keep "
+                                         << balanceKeepAttack << "/" << balanceKeepBenign << ")");
+    NS_ABORT_MSG_IF(output != "csv" && output != "dws" && output != "both", "Invalid --output=" << output);
+    uint8_t streamCodec = kDwsRaw;
+    NS_ABORT_MSG_IF(output != "csv" && !WindowStreamParseCodec(dwsCodec, streamCodec),
+                    "--dwsCodec=" << dwsCodec << " is unknown or was not compiled in");
+    g_writeCsv = output != "dws";
+    if (writeManifest)
+    {
+        g_manifest.Begin();
+    }
+    if (seed)
+    {
+        RngSeedManager::SetSeed(seed);
+    }
+    // Compiled in with -DDDOS_TRACE; exported to <csv>.trace.json
+    TRACE_LAPS(phases, "setup", "app_install", "monitor_install", "run", "teardown");
+    TRACE_LAP(phases, 0);
 
     g_ueTotal = ueTotal;
+    g_multiCell = gNbNum > 1;
 
     // Create output directory path + file
     std::ostringstream fname;
     fname << outPath << "/dataset_" << scenarioTag << "_ue" << ueTotal << (useTcp ? "_tcp" : "_udp")
           << (enableAttack ? "_ddos" : "_benign") << ".csv";
     std::string fileName = fname.str();
+    std::string streamPath = fileName.substr(0, fileName.size() - 4) + ".dws";
 
-    g_out.open(fileName, std::ios::out);
-    WriteCsvHeader();
+    if (g_writeCsv)
+    {
+        g_out.open(fileName, std::ios::out);
+        WriteCsvHeader();
+    }
 
-    // NR parameters (single gNB / single band)
+    g_manifest.Set("generator", "nr_ddos_dataset");
+    g_manifest.Set("scenario_tag", scenarioTag);
+    g_manifest.Set("ue_total", ueTotal);
+    g_manifest.Set("gnb_num", gNbNum);
+    g_manifest.Set("mobility", mobile ? "mobile" : "static");
+    g_manifest.Set("transport", useTcp ? "tcp" : "udp");
+    g_manifest.Set("attack", enableAttack ? "ddos" : "benign");
+    g_manifest.Set("attack_interval_s", attackInterval.GetSeconds());
+    g_manifest.Set("sim_time_s", simTime.GetSeconds());
+    g_manifest.Set("window_s", g_windowSize);
+    g_manifest.Set("seed", seed);
+    g_manifest.Set("balance", balance);
+    g_manifest.Set("output", output);
+
+    // NR parameters (single band, gNbNum cells)
     uint16_t numerology = 2;
     double centralFrequency = 28e9;
     double bandwidth = 100e6;
@@ -238,42 +458,67 @@ int main(int argc, char *argv[])
     NodeContainer ueNodes;
     ueNodes.Create(ueTotal);
 
+    // gNB grid: one gnbSpacing square per gNB, UEs roam over the whole grid.
+    // gNbNum = 1 with the default spacing gives the original single gNB at (60,60) in 120x120 m.
+    uint16_t gridCols = static_cast<uint16_t>(std::ceil(std::sqrt(static_cast<double>(gNbNum))));
+    uint16_t gridRows = static_cast<uint16_t>((gNbNum + gridCols - 1) / gridCols);
+    double areaX = gridCols * gnbSpacing;
+    double areaY = gridRows * gnbSpacing;
+
     Ptr<ListPositionAllocator> gnbPos = CreateObject<ListPositionAllocator>();
-    gnbPos->Add(Vector(60.0, 60.0, 0.0));
+    for (uint16_t g = 0; g < gNbNum; ++g)
+    {
+        gnbPos->Add(Vector((g % gridCols + 0.5) * gnbSpacing, (g / gridCols + 0.5) * gnbSpacing, 0.0));
+    }
     MobilityHelper gnbMob;
     gnbMob.SetPositionAllocator(gnbPos);
     gnbMob.SetMobilityModel("ns3::ConstantPositionMobilityModel");
     gnbMob.Install(gnbNodes);
 
     MobilityHelper ueMob;
+    std::ostringstream xRange, yRange;
+    xRange << "ns3::UniformRandomVariable[Min=0.0|Max=" << areaX << "]";
+    yRange << "ns3::UniformRandomVariable[Min=0.0|Max=" << areaY << "]";
     if (mobile)
     {
         Ptr<RandomRectanglePositionAllocator> uePosAlloc = CreateObject<RandomRectanglePositionAllocator>();
-        uePosAlloc->SetAttribute("X", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=120.0]"));
-        uePosAlloc->SetAttribute("Y", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=120.0]"));
+        uePosAlloc->SetAttribute("X", StringValue(xRange.str()));
+        uePosAlloc->SetAttribute("Y", StringValue(yRange.str()));
         uePosAlloc->SetAttribute("Z", DoubleValue(0.0));
         ueMob.SetPositionAllocator(uePosAlloc);
         ueMob.SetMobilityModel("ns3::RandomWalk2dMobilityModel",
-                               "Bounds", RectangleValue(Rectangle(0.0, 120.0, 0.0, 120.0)),
+                               "Bounds", RectangleValue(Rectangle(0.0, areaX, 0.0, areaY)),
                                "Speed", StringValue("ns3::UniformRandomVariable[Min=1.0|Max=3.0]"),
                                "Distance", DoubleValue(3.0));
     }
     else
     {
         Ptr<RandomRectanglePositionAllocator> uePosAlloc = CreateObject<RandomRectanglePositionAllocator>();
-        uePosAlloc->SetAttribute("X", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=120.0]"));
-        uePosAlloc->SetAttribute("Y", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=120.0]"));
+        uePosAlloc->SetAttribute("X", StringValue(xRange.str()));
+        uePosAlloc->SetAttribute("Y", StringValue(yRange.str()));
         uePosAlloc->SetAttribute("Z", DoubleValue(0.0));
         ueMob.SetPositionAllocator(uePosAlloc);
         ueMob.SetMobilityModel("ns3::ConstantPositionMobilityModel");
     }
-    ueMob.Install(ueNodes);
+    if (mobile && !trajectoryFile.empty())
+    {
+        InstallTrajectories(ueNodes, trajectoryFile, simTime, Rectangle(0.0, areaX, 0.0, areaY));
+    }
+    else
+    {
+        ueMob.Install(ueNodes);
+    }
 
     Ptr<NrPointToPointEpcHelper> nrEpcHelper = CreateObject<NrPointToPointEpcHelper>();
     Ptr<IdealBeamformingHelper> beamHelper = CreateObject<IdealBeamformingHelper>();
     Ptr<NrHelper> nrHelper = CreateObject<NrHelper>();
     nrHelper->SetBeamformingHelper(beamHelper);
     nrHelper->SetEpcHelper(nrEpcHelper);
+    if (gNbNum > 1)
+    {
+        // Mobile UEs cross cell edges, so let them hand over instead of staying on the first gNB
+        nrHelper->SetHandoverAlgorithmType(handoverAlgo);
+    }
 
     CcBwpCreator ccBwpCreator;
     const uint8_t numCcPerBand = 1;
@@ -284,11 +529,32 @@ int main(int argc, char *argv[])
     channelHelper->ConfigureFactories("UMi", "Default", "ThreeGpp");
     channelHelper->SetChannelConditionModelAttribute("UpdatePeriod", TimeValue(MilliSeconds(0)));
     channelHelper->SetPathlossAttribute("ShadowingEnabled", BooleanValue(false));
+    // Must be set before AssignChannelsToBands, which creates the channel models
+    channelHelper->SetChannelModelAttribute("UpdatePeriod", TimeValue(channelUpdatePeriod));
     channelHelper->AssignChannelsToBands({band});
     BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps({band});
 
-    Config::SetDefault("ns3::NrRlcUm::MaxTxBufferSize", UintegerValue(999999999));
-    beamHelper->SetAttribute("BeamformingMethod", TypeIdValue(DirectPathBeamforming::GetTypeId()));
+    Config::SetDefault("ns3::NrRlcUm::MaxTxBufferSize", UintegerValue(rlcBufferSize));
+    bool bfThrottle = mobile && bfPolicy != "always";
+    NS_ABORT_MSG_IF(!BeamUpdatePolicy::Get().Configure(bfPolicy, bfPeriod, bfMinDisplacement, bfMinAngle, bfAudit),
+                    "Unknown bfPolicy " << bfPolicy << " (always|period|displacement|angle)");
+    if (!mobile && !beamCache.empty())
+    {
+        // Same weights as DirectPathBeamforming, reused across runs with the same geometry
+        std::ostringstream bandKey;
+        bandKey << "f=" << centralFrequency << ";bw=" << bandwidth << ";mu=" << numerology << ";bf=DirectPath";
+        BeamCacheStore::Get().Open(beamCache, bandKey.str());
+        beamHelper->SetAttribute("BeamformingMethod", TypeIdValue(CachedDirectPathBeamforming::GetTypeId()));
+    }
+    else if (bfThrottle)
+    {
+        // Reuse a pair's last weights until the policy says the UE has moved enough
+        beamHelper->SetAttribute("BeamformingMethod", TypeIdValue(ThrottledDirectPathBeamforming::GetTypeId()));
+    }
+    else
+    {
+        beamHelper->SetAttribute("BeamformingMethod", TypeIdValue(DirectPathBeamforming::GetTypeId()));
+    }
     nrEpcHelper->SetAttribute("S1uLinkDelay", TimeValue(MilliSeconds(0)));
 
     NetDeviceContainer gnbDevs = nrHelper->InstallGnbDevice(gnbNodes, allBwps);
@@ -300,19 +566,27 @@ int main(int argc, char *argv[])
 
     double x = pow(10, totalTxPower / 10.0);
     double totalBandwidth = bandwidth;
-    nrHelper->GetGnbPhy(gnbDevs.Get(0), 0)->SetAttribute("Numerology", UintegerValue(numerology));
-    nrHelper->GetGnbPhy(gnbDevs.Get(0), 0)
-        ->SetAttribute("TxPower", DoubleValue(10 * log10((bandwidth / totalBandwidth) * x)));
+    for (uint32_t g = 0; g < gnbDevs.GetN(); ++g)
+    {
+        nrHelper->GetGnbPhy(gnbDevs.Get(g), 0)->SetAttribute("Numerology", UintegerValue(numerology));
+        nrHelper->GetGnbPhy(gnbDevs.Get(g), 0)
+            ->SetAttribute("TxPower", DoubleValue(10 * log10((bandwidth / totalBandwidth) * x)));
+    }
 
     InternetStackHelper internet;
     internet.Install(ueNodes);
 
     Ipv4InterfaceContainer ueIfaces = nrEpcHelper->AssignUeIpv4Address(NetDeviceContainer(ueDevs));
     nrHelper->AttachToClosestGnb(ueDevs, gnbDevs);
+    if (gNbNum > 1)
+    {
+        nrHelper->AddX2Interface(gnbNodes);
+    }
 
     // Random server/client assignment
+    TRACE_LAP(phases, 1);
     std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937 gen(seed ? seed : rd());
     std::uniform_int_distribution<> dis(0, ueTotal - 1);
 
     std::set<uint32_t> serverUEs;
@@ -403,7 +677,40 @@ int main(int argc, char *argv[])
             uint16_t serverPort = serverPorts[serverIndex];
             Ipv4Address serverAddress = ueIfaces.GetAddress(serverIndex);
 
-            if (useTcp)
+            if (floodApp)
+            {
+                // Same offered load as the legacy apps, sent as bursts from a template packet
+                DataRate rate = useTcp ? DataRate("200Mbps")
+                                       : DataRate(static_cast<uint64_t>(1024 * 8 / attackInterval.GetSeconds()));
+                DdosFloodHelper flood(useTcp ? "ns3::TcpSocketFactory" : "ns3::UdpSocketFactory",
+                                      InetSocketAddress(serverAddress, serverPort));
+                flood.SetAttribute("RampTime", TimeValue(attackRampTime));
+                flood.SetAttribute("PulsePeriod", TimeValue(attackPulsePeriod));
+                flood.SetAttribute("PulseDuty",
+                                  DoubleValue(std::min(1.0, attackPulseWidth.GetSeconds() / attackPulsePeriod.GetSeconds())));
+                flood.SetAttribute("OnTime", TimeValue(attackOnTime));
+                flood.SetAttribute("OffTime", TimeValue(attackOffTime));
+                if (attackProfile == "lowslow")
+                {
+                    // Small packets trickled one at a time with jittered gaps
+                    flood.SetAttribute("DataRate", DataRateValue(lowSlowRate));
+                    flood.SetAttribute("PacketSize", UintegerValue(lowSlowSize));
+                    flood.SetAttribute("BurstSize", UintegerValue(1));
+                    flood.SetAttribute("GapJitter", DoubleValue(0.5));
+                    flood.SetAttribute("Profile", StringValue("constant"));
+                }
+                else
+                {
+                    flood.SetAttribute("DataRate", DataRateValue(rate));
+                    flood.SetAttribute("PacketSize", UintegerValue(1024));
+                    flood.SetAttribute("BurstSize", UintegerValue(attackBurst));
+                    flood.SetAttribute("Profile", StringValue(attackProfile));
+                }
+                auto app = flood.Install(ueNodes.Get(clientIndex));
+                app.Start(appStart);
+                app.Stop(simTime);
+            }
+            else if (useTcp)
             {
                 OnOffHelper onoff("ns3::TcpSocketFactory", InetSocketAddress(serverAddress, serverPort));
                 onoff.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1]"));
@@ -428,6 +735,7 @@ int main(int argc, char *argv[])
     }
 
     // FlowMonitor setup
+    TRACE_LAP(phases, 2);
     FlowMonitorHelper flowmonHelper;
     NodeContainer monitorNodes;
     monitorNodes.Add(ueNodes);
@@ -436,19 +744,177 @@ int main(int argc, char *argv[])
     g_monitor->SetAttribute("JitterBinWidth", DoubleValue(0.001));
     g_monitor->SetAttribute("PacketSizeBinWidth", DoubleValue(20));
     g_classifier = DynamicCast<Ipv4FlowClassifier>(flowmonHelper.GetClassifier());
+    g_sampler.Setup(g_monitor, g_classifier);
+    if (g_multiCell)
+    {
+        g_cells.Setup(&g_sampler, gnbDevs, ueDevs, ueIfaces);
+    }
+
+    if (g_radioKpis)
+    {
+        // PHY and RRC traces exist now; RLC bearers are tapped as the RRC sets them up
+        // (attach, handover), with a last sweep at appStart
+        g_radio.Setup(ueDevs, gnbDevs, ueIfaces);
+        Simulator::Schedule(appStart, &NrRadioKpiCollector::ConnectBearerTraces, &g_radio);
+    }
 
     // Schedule periodic sampling
     g_windowStart = 0.0;
+    g_windowIndex = 0;
     g_scenarioId = scenarioTag;
     Simulator::Schedule(Seconds(g_windowSize), &SampleAndWrite);
+    if (tensors)
+    {
+        g_tensors.Enable(g_scenarioId, g_windowSize);
+    }
+    if (output != "csv")
+    {
+        const std::map<std::string, std::string> consts = {{"scenario_id", g_scenarioId},
+                                                           {"ue_total", std::to_string(g_ueTotal)},
+                                                           {"attackers", std::to_string(g_attackers.size())}};
+        NS_ABORT_MSG_IF(!g_stream.Open(streamPath, WindowStreamColumns(CsvColumns(), consts), streamCodec),
+                        "Could not write " << streamPath);
+    }
+
+    if (!sinkSocket.empty())
+    {
+        NS_ABORT_MSG_IF(!g_sink.Open(sinkSocket, sinkBackpressure, sinkBuffer),
+                        "Could not connect to " << sinkSocket << " (backpressure " << sinkBackpressure << ")");
+        g_sink.Hello(g_scenarioId, ueTotal, g_attackers.size(), g_windowSize);
+        if (enableAttack)
+        {
+            // Reference point for detection latency: the first attack verdict is measured from here
+            Simulator::Schedule(appStart, &WindowSocketSink::MarkAttackStart, &g_sink);
+        }
+    }
+
+    Simulator::Schedule(Seconds(1.0), &MarkFirstSecond);
 
     Simulator::Stop(simTime);
+    auto runStart = std::chrono::steady_clock::now();
+    TRACE_CHECKPOINTS(MilliSeconds(100));
+    TRACE_LAP(phases, 3);
+    g_manifest.MarkRunStart();
     Simulator::Run();
+    g_manifest.MarkRunEnd();
+    TRACE_LAP(phases, 4);
+    auto runEnd = std::chrono::steady_clock::now();
+    NS_LOG_INFO("Executed events: " << Simulator::GetEventCount() << " ("
+                << Simulator::GetEventCount() / simTime.GetSeconds() << " per simulated second)");
 
-    g_out.flush();
-    g_out.close();
+    if (g_balancer.IsEnabled())
+    {
+        TRACE_SCOPE("balance");
+        uint64_t held = 0;
+        g_balancer.Drain([&held](const HeldRow &h, double weight) {
+            EmitRow(h.row, h.timeStart, h.timeEnd, h.attack, h.cellId, h.src, h.dst, weight);
+            held++;
+        });
+        g_manifest.AddRows(held);
+        const auto &a = g_balancer.GetStats(true);
+        const auto &b = g_balancer.GetStats(false);
+        std::cout << "ClassBalance: mode=" << balance << " attack=" << a.kept << "/" << a.seen << " benign=" << b.kept
+                  << "/" << b.seen << " heldMB=" << g_balancer.GetMemoryBytes() / 1e6 << std::endl;
+        g_manifest.SetExtra("balance_attack_seen", a.seen);
+        g_manifest.SetExtra("balance_attack_kept", a.kept);
+        g_manifest.SetExtra("balance_benign_seen", b.seen);
+        g_manifest.SetExtra("balance_benign_kept", b.kept);
+    }
+
+    uint64_t bytesWritten = 0;
+    if (g_writeCsv)
+    {
+        g_out.flush();
+        bytesWritten = static_cast<uint64_t>(g_out.tellp());
+        g_out.close();
+    }
+    if (g_stream.IsOpen())
+    {
+        TRACE_SCOPE("stream");
+        if (!g_stream.Close()) std::cerr << "Could not write " << streamPath << std::endl;
+        std::cout << "WindowStream: codec=" << g_stream.GetCodecName() << " rows=" << g_stream.GetRows()
+                  << " blocks=" << g_stream.GetBlocks() << " MB=" << g_stream.GetBytes() / 1e6
+                  << " rawMB=" << g_stream.GetRawBytes() / 1e6 << " file=" << streamPath << std::endl;
+        g_manifest.SetExtra("dws_bytes", g_stream.GetBytes());
+        bytesWritten += g_stream.GetBytes();
+    }
+    g_manifest.SetBytesWritten(bytesWritten);
+
+    if (!sinkSocket.empty())
+    {
+        g_sink.Close(Simulator::Now().GetSeconds());
+        const WindowSocketSink::Stats &ss = g_sink.GetStats();
+        std::cout << "SocketSink: windows=" << ss.windows << " dropped=" << ss.droppedWindows
+                  << " sampled=" << ss.sampledWindows << " sampledOutRows=" << ss.sampledOutRows
+                  << " MB=" << ss.bytes / 1e6 << " blockedMs=" << ss.blockedNs / 1e6 << std::endl;
+        g_manifest.SetExtra("sink_windows_sent", ss.windows - ss.droppedWindows);
+        g_manifest.SetExtra("sink_windows_dropped", ss.droppedWindows);
+        g_manifest.SetExtra("sink_rows_sampled_out", ss.sampledOutRows);
+        g_manifest.SetExtra("sink_blocked_ms", ss.blockedNs / 1e6);
+    }
+
+    if (tensors)
+    {
+        TRACE_SCOPE("tensors");
+        std::string tensorPath = fileName.substr(0, fileName.size() - 4) + ".ftns";
+        if (!g_tensors.Write(tensorPath)) std::cerr << "Could not write " << tensorPath << std::endl;
+        std::cout << "FlowTensors: flows=" << g_tensors.GetFlows() << " rows=" << g_tensors.GetRows()
+                  << " MB=" << g_tensors.GetFileBytes() / 1e6 << " file=" << tensorPath << std::endl;
+        g_manifest.SetExtra("tensor_flows", g_tensors.GetFlows());
+        g_manifest.SetExtra("tensor_rows", g_tensors.GetRows());
+    }
+
+    // Wall-time scaling line; compare across --gnbNum values to get the cost per added cell
+    double setupSec = std::chrono::duration<double>(runStart - wallStart).count();
+    double runSec = std::chrono::duration<double>(runEnd - runStart).count();
+    std::cout << "Cells: " << gNbNum << " UEs: " << ueTotal << " setup_s: " << setupSec;
+    if (g_firstSecondMarked)
+    {
+        std::cout << " first_s: " << std::chrono::duration<double>(g_firstSecondWall - runStart).count();
+    }
+    std::cout << " run_s: " << runSec << " wall_per_sim_s: " << runSec / simTime.GetSeconds() << std::endl;
+    if (!mobile && !beamCache.empty())
+    {
+        BeamCacheStore &cache = BeamCacheStore::Get();
+        cache.Save();
+        std::cout << "BeamCache: loaded " << cache.GetLoaded() << " hits " << cache.GetHits() << " misses "
+                  << cache.GetMisses() << std::endl;
+        g_manifest.SetExtra("beam_cache_hits", cache.GetHits());
+        g_manifest.SetExtra("beam_cache_misses", cache.GetMisses());
+    }
+    if (bfThrottle)
+    {
+        // Rerun with --bfPolicy=always and the same seed to compare the throughput/delay columns
+        const BeamUpdatePolicy::Stats &bf = BeamUpdatePolicy::Get().GetStats();
+        std::cout << "BeamThrottle: policy " << bfPolicy << " updates " << bf.calls << " skipped " << bf.skipped
+                  << " skip_ratio " << (bf.calls ? double(bf.skipped) / bf.calls : 0.0) << " compute_s "
+                  << bf.computeNs * 1e-9 << " saved_s " << BeamUpdatePolicy::Get().GetSavedSeconds();
+        if (bf.audits > 0)
+        {
+            std::cout << " audits " << bf.audits << " beam_corr_mean " << bf.correlationSum / bf.audits
+                      << " beam_corr_min " << bf.correlationMin;
+        }
+        std::cout << std::endl;
+        g_manifest.SetExtra("bf_updates", bf.calls);
+        g_manifest.SetExtra("bf_skipped", bf.skipped);
+    }
+    if (g_multiCell)
+    {
+        for (const CellSampler::CellStats &c : g_cells.GetStats())
+        {
+            std::cout << "  cell " << c.cellId << ": rows " << c.rows << ", peak flows " << c.peakFlows
+                      << ", flows handed over in " << c.handoversIn << std::endl;
+        }
+    }
 
     Simulator::Destroy();
+    TRACE_LAPS_END(phases);
+    TRACE_EXPORT(fileName.substr(0, fileName.size() - 4) + ".trace.json");
+    if (writeManifest)
+    {
+        std::string manifestPath = RunManifest::SidecarPath(fileName);
+        if (!g_manifest.Write(manifestPath)) std::cerr << "Could not write " << manifestPath << std::endl;
+    }
     return 0;
 }
 
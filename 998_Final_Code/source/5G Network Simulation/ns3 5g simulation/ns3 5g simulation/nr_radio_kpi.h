@@ -0,0 +1,297 @@
+// nr_radio_kpi.h - Per-UE per-window NR radio KPIs for nr_ddos_dataset.cc
+// Accumulates SINR, MCS, PRB allocations and HARQ retransmissions from the NR spectrum
+// PHY RxPacketTrace sources (DL at the UE, UL at the gNB) into one preallocated counter
+// block per UE. Nothing is written per event; CloseWindow() folds the counters into a
+// RadioWindow that rows join on src_ip (uplink side) and dst_ip (downlink side).
+// The RLC backlog is the RLC's own buffer status report to the MAC: each data bearer's RLC
+// gets an RlcBsrTap in front of its MAC SAP that forwards everything and keeps the last
+// reported queue size, so drops and header bytes are already accounted for by the RLC.
+// Bearers and RNTIs change at attach and handover, so the UE RRC's ConnectionEstablished,
+// ConnectionReconfiguration and HandoverEndOk traces keep the (cellId, RNTI) map current
+// and point each UE at the bearers that exist now; bearers left behind drop out.
+
+#ifndef NR_RADIO_KPI_H
+#define NR_RADIO_KPI_H
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/nr-module.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+// Radio features for one UE over the last closed window
+struct RadioWindow
+{
+    double dlSinrDb = 0.0;
+    double dlMcs = 0.0;
+    uint64_t dlPrbs = 0; // RBs summed over received DL transport blocks
+    uint64_t dlHarqRetx = 0;
+    double ulSinrDb = 0.0;
+    double ulMcs = 0.0;
+    uint64_t ulPrbs = 0;
+    uint64_t ulHarqRetx = 0;
+    int64_t ulRlcBacklog = 0; // bytes queued in the UE's RLC at window end
+    int64_t dlRlcBacklog = 0; // bytes queued for the UE in the gNB's RLC at window end
+    uint64_t rlcDrops = 0;
+};
+
+// Sits between one RLC entity and its MAC SAP provider. Everything is forwarded unchanged;
+// the last buffer status report (bytes waiting for transmission and retransmission) is kept.
+class RlcBsrTap : public NrMacSapProvider
+{
+  public:
+    explicit RlcBsrTap(NrMacSapProvider *mac)
+        : m_mac(mac)
+    {
+    }
+
+    void TransmitPdu(TransmitPduParameters params) override { m_mac->TransmitPdu(params); }
+
+    void BufferStatusReport(BufferStatusReportParameters params) override
+    {
+        m_queued = params.txQueueSize + params.retxQueueSize;
+        m_mac->BufferStatusReport(params);
+    }
+
+    uint32_t GetQueuedBytes() const { return m_queued; }
+
+  private:
+    NrMacSapProvider *m_mac;
+    uint32_t m_queued = 0;
+};
+
+class NrRadioKpiCollector
+{
+  public:
+    void Setup(const NetDeviceContainer &ueDevs, const NetDeviceContainer &gnbDevs,
+               const Ipv4InterfaceContainer &ueIfaces)
+    {
+        m_ueDevs = ueDevs;
+        m_gnbDevs = gnbDevs;
+        m_ues.assign(ueDevs.GetN(), Ue{});
+        for (uint32_t i = 0; i < ueDevs.GetN(); ++i)
+        {
+            m_byAddr[ueIfaces.GetAddress(i).Get()] = i;
+            Ptr<NrSpectrumPhy> phy = NrHelper::GetUePhy(ueDevs.Get(i), 0)->GetSpectrumPhy();
+            phy->TraceConnectWithoutContext("RxPacketTraceUe", MakeBoundCallback(&NrRadioKpiCollector::OnDlRx, &m_ues[i]));
+
+            Ptr<NrUeRrc> rrc = DynamicCast<NrUeNetDevice>(ueDevs.Get(i))->GetRrc();
+            rrc->TraceConnectWithoutContext("ConnectionEstablished",
+                                            MakeBoundCallback(&NrRadioKpiCollector::OnRnti, this, i));
+            rrc->TraceConnectWithoutContext("ConnectionReconfiguration",
+                                            MakeBoundCallback(&NrRadioKpiCollector::OnBearers, this, i));
+            rrc->TraceConnectWithoutContext("HandoverEndOk", MakeBoundCallback(&NrRadioKpiCollector::OnBearers, this, i));
+        }
+        for (uint32_t g = 0; g < gnbDevs.GetN(); ++g)
+        {
+            Ptr<NrSpectrumPhy> phy = NrHelper::GetGnbPhy(gnbDevs.Get(g), 0)->GetSpectrumPhy();
+            phy->TraceConnectWithoutContext("RxPacketTraceGnb", MakeCallback(&NrRadioKpiCollector::OnUlRx, this));
+            m_gnbByCell[DynamicCast<NrGnbNetDevice>(gnbDevs.Get(g))->GetCellId()] = g;
+        }
+    }
+
+    // Safety net after attachment (e.g. at appStart): picks up any bearer the RRC traces missed
+    // and checks that the UE bearers were found at all
+    void ConnectBearerTraces()
+    {
+        bool found = false;
+        for (uint32_t i = 0; i < m_ueDevs.GetN(); ++i)
+        {
+            if (m_ues[i].rntiKey != 0) RefreshBearers(i);
+            found |= !m_ues[i].ulTaps.empty();
+        }
+        NS_ABORT_MSG_IF(!found && m_ueDevs.GetN() > 0, "NrRadioKpiCollector: no UE bearers found");
+    }
+
+    void CloseWindow()
+    {
+        for (Ue &ue : m_ues)
+        {
+            RadioWindow &w = ue.last;
+            w.dlSinrDb = ue.dl.tbs ? ue.dl.sinrDbSum / ue.dl.tbs : 0.0;
+            w.dlMcs = ue.dl.tbs ? static_cast<double>(ue.dl.mcsSum) / ue.dl.tbs : 0.0;
+            w.dlPrbs = ue.dl.rbs;
+            w.dlHarqRetx = ue.dl.harqRetx;
+            w.ulSinrDb = ue.ul.tbs ? ue.ul.sinrDbSum / ue.ul.tbs : 0.0;
+            w.ulMcs = ue.ul.tbs ? static_cast<double>(ue.ul.mcsSum) / ue.ul.tbs : 0.0;
+            w.ulPrbs = ue.ul.rbs;
+            w.ulHarqRetx = ue.ul.harqRetx;
+            w.ulRlcBacklog = QueuedBytes(ue.ulTaps);
+            w.dlRlcBacklog = QueuedBytes(ue.dlTaps);
+            w.rlcDrops = ue.rlcDrops;
+
+            ue.dl = Link{};
+            ue.ul = Link{};
+            ue.rlcDrops = 0;
+        }
+    }
+
+    // Last closed window for the UE with this address (all zeros if unknown)
+    const RadioWindow &Find(Ipv4Address addr) const
+    {
+        static const RadioWindow none;
+        auto it = m_byAddr.find(addr.Get());
+        return it == m_byAddr.end() ? none : m_ues[it->second].last;
+    }
+
+  private:
+    struct Link
+    {
+        double sinrDbSum = 0.0;
+        uint64_t mcsSum = 0;
+        uint64_t tbs = 0;
+        uint64_t rbs = 0;
+        uint64_t harqRetx = 0;
+
+        void Add(const RxPacketTraceParams &p)
+        {
+            sinrDbSum += 10.0 * std::log10(std::max(p.m_sinr, 1e-12));
+            mcsSum += p.m_mcs;
+            tbs++;
+            rbs += p.m_rbAssignedNum;
+            if (p.m_rv > 0) harqRetx++;
+        }
+    };
+
+    struct Ue
+    {
+        Link dl;
+        Link ul;
+        uint64_t rlcDrops = 0;
+        uint32_t rntiKey = 0; // current (cellId << 16 | rnti); cell IDs start at 1, so 0 = none
+        std::vector<RlcBsrTap *> ulTaps; // the UE's own data bearers
+        std::vector<RlcBsrTap *> dlTaps; // the serving gNB's data bearers for this UE
+        RadioWindow last;
+    };
+
+    // NrRlc has no getter for the MAC SAP provider it sends to; a derived-class member
+    // pointer reads the protected field so the tap can forward to it
+    struct NrRlcMacSap : NrRlc
+    {
+        static NrMacSapProvider *Get(NrRlc *rlc) { return rlc->*(&NrRlcMacSap::m_macSapProvider); }
+    };
+
+    static int64_t QueuedBytes(const std::vector<RlcBsrTap *> &taps)
+    {
+        int64_t bytes = 0;
+        for (const RlcBsrTap *tap : taps) bytes += tap->GetQueuedBytes();
+        return bytes;
+    }
+
+    static void OnDlRx(Ue *ue, RxPacketTraceParams p) { ue->dl.Add(p); }
+    static void OnRlcDrop(Ue *ue, Ptr<const Packet>) { ue->rlcDrops++; }
+
+    void OnUlRx(RxPacketTraceParams p)
+    {
+        if (Ue *ue = ByRnti(static_cast<uint16_t>(p.m_cellId), p.m_rnti)) ue->ul.Add(p);
+    }
+
+    // (cellId, RNTI) -> UE, kept current by OnRnti; events for an unknown RNTI are dropped
+    Ue *ByRnti(uint16_t cellId, uint16_t rnti)
+    {
+        auto it = m_byRnti.find((static_cast<uint32_t>(cellId) << 16) | rnti);
+        return it == m_byRnti.end() ? nullptr : &m_ues[it->second];
+    }
+
+    // UE i has a new RNTI in cellId (attach or handover): move its entry in m_byRnti
+    static void OnRnti(NrRadioKpiCollector *self, uint32_t i, uint64_t, uint16_t cellId, uint16_t rnti)
+    {
+        Ue &ue = self->m_ues[i];
+        auto old = self->m_byRnti.find(ue.rntiKey);
+        if (old != self->m_byRnti.end() && old->second == i) self->m_byRnti.erase(old);
+        ue.rntiKey = (static_cast<uint32_t>(cellId) << 16) | rnti;
+        self->m_byRnti[ue.rntiKey] = i;
+    }
+
+    // UE i's bearers were (re)created: at reconfiguration after attach, or at the target cell
+    // after a handover
+    static void OnBearers(NrRadioKpiCollector *self, uint32_t i, uint64_t imsi, uint16_t cellId, uint16_t rnti)
+    {
+        OnRnti(self, i, imsi, cellId, rnti);
+        self->RefreshBearers(i);
+    }
+
+    // Point UE i's backlog at the data bearers that exist now: its own RLCs (UL) and the
+    // serving gNB's RLCs under its current RNTI (DL). Bearers of the source cell, or ones the
+    // UE released, are no longer in these lists and stop counting.
+    void RefreshBearers(uint32_t i)
+    {
+        Ue &ue = m_ues[i];
+        std::ostringstream ul;
+        ul << "/NodeList/" << m_ueDevs.Get(i)->GetNode()->GetId()
+           << "/DeviceList/*/$ns3::NrUeNetDevice/NrUeRrc/DataRadioBearerMap/*/NrRlc";
+        ue.ulTaps = Tap(ul.str());
+        ConnectNew(ul.str(), "TxDrop", MakeBoundCallback(&NrRadioKpiCollector::OnRlcDrop, &ue));
+
+        ue.dlTaps.clear();
+        auto g = m_gnbByCell.find(static_cast<uint16_t>(ue.rntiKey >> 16));
+        if (g != m_gnbByCell.end())
+        {
+            std::ostringstream dl;
+            dl << "/NodeList/" << m_gnbDevs.Get(g->second)->GetNode()->GetId()
+               << "/DeviceList/*/$ns3::NrGnbNetDevice/NrGnbRrc/UeMap/" << (ue.rntiKey & 0xFFFF)
+               << "/DataRadioBearerMap/*/NrRlc";
+            ue.dlTaps = Tap(dl.str());
+        }
+    }
+
+    // Taps for every RLC under path, inserting a tap in front of each RLC seen for the first time
+    std::vector<RlcBsrTap *> Tap(const std::string &path)
+    {
+        std::vector<RlcBsrTap *> taps;
+        Config::MatchContainer matches = Config::LookupMatches(path);
+        for (uint32_t k = 0; k < matches.GetN(); ++k)
+        {
+            Ptr<NrRlc> rlc = DynamicCast<NrRlc>(matches.Get(k));
+            if (!rlc) continue;
+            std::unique_ptr<RlcBsrTap> &tap = m_taps[rlc];
+            if (!tap)
+            {
+                tap = std::make_unique<RlcBsrTap>(NrRlcMacSap::Get(PeekPointer(rlc)));
+                rlc->SetNrMacSapProvider(tap.get());
+            }
+            taps.push_back(tap.get());
+        }
+        return taps;
+    }
+
+    // Connects trace on each object under path that is not hooked yet, so a bearer is never
+    // counted twice however often it is revisited. m_hooked holds a reference to every hooked
+    // object, so a released bearer's address cannot be reused by a new one.
+    uint32_t ConnectNew(const std::string &path, const std::string &trace, const CallbackBase &cb)
+    {
+        uint32_t connected = 0;
+        Config::MatchContainer matches = Config::LookupMatches(path);
+        for (uint32_t k = 0; k < matches.GetN(); ++k)
+        {
+            Ptr<Object> object = matches.Get(k);
+            if (m_hooked.insert({object, trace}).second && object->TraceConnectWithoutContext(trace, cb)) connected++;
+        }
+        return connected;
+    }
+
+    NetDeviceContainer m_ueDevs;
+    NetDeviceContainer m_gnbDevs;
+    std::vector<Ue> m_ues;                   // indexed like ueDevs; never resized after Setup
+    std::map<uint32_t, uint32_t> m_byAddr;   // UE IPv4 -> index
+    std::map<uint32_t, uint32_t> m_byRnti;   // (cellId << 16 | rnti) -> index
+    std::map<uint16_t, uint32_t> m_gnbByCell; // cellId -> index in gnbDevs
+    std::set<std::pair<Ptr<Object>, std::string>> m_hooked; // (RLC object, trace) already connected
+    std::map<Ptr<NrRlc>, std::unique_ptr<RlcBsrTap>> m_taps; // RLC -> its tap; holding the RLC keeps the tap valid
+};
+
+} // namespace ns3
+
+#endif // NR_RADIO_KPI_H
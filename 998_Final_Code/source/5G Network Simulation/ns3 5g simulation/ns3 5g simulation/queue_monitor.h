@@ -0,0 +1,154 @@
+// queue_monitor.h - Per-window queue occupancy and drop features for point-to-point devices
+// Counters are preallocated once per watched device and updated straight from the
+// queue trace sources (PacketsInQueue, Enqueue, Drop); a window close turns them into
+// max / time-weighted mean length, enqueue and drop counts and time spent full.
+// Once the device has an IPv4 address it also has a root queue disc (FqCoDel by default),
+// and with flow control the backlog builds and drops happen there, not in the device
+// queue. Such a device is measured as disc + device queue: length is the sum of both,
+// enqueues and drops come from the disc, and "full" means the disc is at its limit.
+// Devices are registered under the IPv4 address they deliver to, so window rows can be
+// joined on dst_ip.
+
+#ifndef QUEUE_MONITOR_H
+#define QUEUE_MONITOR_H
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/traffic-control-module.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace ns3
+{
+
+// Queue features for one device over the last closed window
+struct QueueWindow
+{
+    uint32_t maxPkts = 0;
+    double meanPkts = 0.0;
+    uint64_t enqueued = 0;
+    uint64_t dropped = 0;
+    double fullMs = 0.0;
+};
+
+class QueueMonitor
+{
+  public:
+    // Reserve counters up front so trace callbacks can hold stable pointers into them
+    void Setup(uint32_t devices) { m_counters.reserve(devices); }
+
+    // Call after addresses are assigned, so the root queue disc (if any) is already installed
+    void Add(Ptr<PointToPointNetDevice> dev, Ipv4Address deliversTo)
+    {
+        NS_ABORT_MSG_IF(m_counters.size() == m_counters.capacity(), "QueueMonitor::Setup reserved too few devices");
+        Ptr<Queue<Packet>> queue = dev->GetQueue();
+        Ptr<TrafficControlLayer> tc = dev->GetNode()->GetObject<TrafficControlLayer>();
+        Ptr<QueueDisc> disc = tc ? tc->GetRootQueueDiscOnDevice(dev) : nullptr;
+        m_counters.emplace_back();
+        Counters *c = &m_counters.back();
+        m_index[deliversTo.Get()] = m_counters.size() - 1;
+
+        queue->TraceConnectWithoutContext("PacketsInQueue", MakeBoundCallback(&QueueMonitor::OnDeviceLength, c));
+        queue->TraceConnectWithoutContext("Drop", MakeBoundCallback(&QueueMonitor::OnDrop, c));
+        if (disc)
+        {
+            c->limit = disc->GetMaxSize().GetValue();
+            c->limited = &c->discLength;
+            disc->TraceConnectWithoutContext("PacketsInQueue", MakeBoundCallback(&QueueMonitor::OnDiscLength, c));
+            disc->TraceConnectWithoutContext("Enqueue", MakeBoundCallback(&QueueMonitor::OnDiscEnqueue, c));
+            disc->TraceConnectWithoutContext("Drop", MakeBoundCallback(&QueueMonitor::OnDiscDrop, c));
+        }
+        else
+        {
+            c->limit = queue->GetMaxSize().GetValue();
+            c->limited = &c->deviceLength;
+            queue->TraceConnectWithoutContext("Enqueue", MakeBoundCallback(&QueueMonitor::OnEnqueue, c));
+        }
+    }
+
+    // Finalise the window ending now and start the next one
+    void CloseWindow(double windowSize)
+    {
+        double now = Simulator::Now().GetSeconds();
+        for (Counters &c : m_counters)
+        {
+            c.Advance(now);
+            c.last.maxPkts = c.maxPkts;
+            c.last.meanPkts = c.area / windowSize;
+            c.last.enqueued = c.enqueued;
+            c.last.dropped = c.dropped;
+            c.last.fullMs = 1000.0 * c.fullTime;
+
+            c.maxPkts = c.length;
+            c.area = 0.0;
+            c.fullTime = 0.0;
+            c.enqueued = 0;
+            c.dropped = 0;
+        }
+    }
+
+    // Last closed window for the device delivering to addr (all zeros if not watched)
+    const QueueWindow &Find(Ipv4Address addr) const
+    {
+        static const QueueWindow none;
+        auto it = m_index.find(addr.Get());
+        return it == m_index.end() ? none : m_counters[it->second].last;
+    }
+
+  private:
+    struct Counters
+    {
+        uint32_t limit = 0;
+        uint32_t length = 0; // disc + device queue
+        uint32_t deviceLength = 0;
+        uint32_t discLength = 0;
+        const uint32_t *limited = nullptr; // the length limit applies to (disc if installed)
+        uint32_t maxPkts = 0;
+        double lastChange = 0.0;
+        double area = 0.0;     // packet-seconds in the current window
+        double fullTime = 0.0; // seconds at limit in the current window
+        uint64_t enqueued = 0;
+        uint64_t dropped = 0;
+        QueueWindow last;
+
+        void Advance(double now)
+        {
+            double dt = now - lastChange;
+            area += length * dt;
+            if (limit > 0 && *limited >= limit) fullTime += dt;
+            lastChange = now;
+        }
+
+        void SetLength(uint32_t &part, uint32_t newValue)
+        {
+            Advance(Simulator::Now().GetSeconds());
+            part = newValue;
+            length = deviceLength + discLength;
+            maxPkts = std::max(maxPkts, length);
+        }
+    };
+
+    static void OnDeviceLength(Counters *c, uint32_t, uint32_t newValue) { c->SetLength(c->deviceLength, newValue); }
+
+    static void OnDiscLength(Counters *c, uint32_t, uint32_t newValue) { c->SetLength(c->discLength, newValue); }
+
+    static void OnEnqueue(Counters *c, Ptr<const Packet>) { c->enqueued++; }
+
+    static void OnDrop(Counters *c, Ptr<const Packet>) { c->dropped++; }
+
+    // Every packet passes through the disc first, so its enqueues are the device's arrivals
+    static void OnDiscEnqueue(Counters *c, Ptr<const QueueDiscItem>) { c->enqueued++; }
+
+    static void OnDiscDrop(Counters *c, Ptr<const QueueDiscItem>) { c->dropped++; }
+
+    std::vector<Counters> m_counters;
+    std::map<uint32_t, size_t> m_index; // delivered-to IPv4 address -> counters
+};
+
+} // namespace ns3
+
+#endif // QUEUE_MONITOR_H
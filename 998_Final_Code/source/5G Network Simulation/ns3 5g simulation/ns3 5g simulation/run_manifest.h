@@ -0,0 +1,254 @@
+// run_manifest.h - Per-run performance manifest written as a JSON sidecar next to the CSV
+// Records what a run cost: scheduled and executed events, wall time split into setup,
+// Simulator::Run and teardown, peak RSS, rows and bytes written, time spent sampling each
+// window, and the simulator implementation and scheduler in use. tools/manifest_summary.py
+// aggregates the sidecars of a sweep by scenario dimension.
+//
+// Scheduled events are counted by CountingSimulatorImpl, a DefaultSimulatorImpl that only
+// adds a counter to the Schedule* calls. RunManifest::Begin() selects it unless another
+// implementation (e.g. distributed) was requested, in which case "events_scheduled" is -1.
+// SelectScheduler() maps the generators' --scheduler names onto the SchedulerType global.
+
+#ifndef RUN_MANIFEST_H
+#define RUN_MANIFEST_H
+
+#include "ns3/core-module.h"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+class CountingSimulatorImpl : public DefaultSimulatorImpl
+{
+  public:
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::CountingSimulatorImpl")
+                                .SetParent<DefaultSimulatorImpl>()
+                                .SetGroupName("Core")
+                                .AddConstructor<CountingSimulatorImpl>();
+        return tid;
+    }
+
+    // Simulator::Destroy deletes the instance, so the count lives outside it
+    static uint64_t &Scheduled()
+    {
+        static uint64_t scheduled = 0;
+        return scheduled;
+    }
+
+    EventId Schedule(const Time &delay, EventImpl *event) override
+    {
+        Scheduled()++;
+        return DefaultSimulatorImpl::Schedule(delay, event);
+    }
+
+    void ScheduleWithContext(uint32_t context, const Time &delay, EventImpl *event) override
+    {
+        Scheduled()++;
+        DefaultSimulatorImpl::ScheduleWithContext(context, delay, event);
+    }
+
+    EventId ScheduleNow(EventImpl *event) override
+    {
+        Scheduled()++;
+        return DefaultSimulatorImpl::ScheduleNow(event);
+    }
+};
+
+NS_OBJECT_ENSURE_REGISTERED(CountingSimulatorImpl);
+
+// heap|calendar|map|list|priority, or a full scheduler TypeId name. Binds SchedulerType, which
+// the simulator reads when it is created, so call it before anything is scheduled. Returns
+// false for an unknown name; an empty name keeps the default (MapScheduler or --SchedulerType).
+inline bool SelectScheduler(const std::string &name)
+{
+    static const std::pair<const char *, const char *> kShortNames[] = {
+        {"heap", "ns3::HeapScheduler"},
+        {"calendar", "ns3::CalendarScheduler"},
+        {"map", "ns3::MapScheduler"},
+        {"list", "ns3::ListScheduler"},
+        {"priority", "ns3::PriorityQueueScheduler"},
+    };
+    if (name.empty()) return true;
+    std::string type = name;
+    for (const auto &s : kShortNames)
+    {
+        if (name == s.first) type = s.second;
+    }
+    TypeId tid;
+    if (!TypeId::LookupByNameFailSafe(type, &tid)) return false;
+    GlobalValue::Bind("SchedulerType", TypeIdValue(tid));
+    return true;
+}
+
+class RunManifest
+{
+  public:
+    // Call right after parsing the command line, before anything is scheduled
+    void Begin()
+    {
+        m_wallStart = std::chrono::steady_clock::now();
+        StringValue impl;
+        GlobalValue::GetValueByName("SimulatorImplementationType", impl);
+        m_counting = impl.Get() == "ns3::DefaultSimulatorImpl";
+        if (m_counting)
+        {
+            GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::CountingSimulatorImpl"));
+        }
+    }
+
+    // Scenario dimensions, written in insertion order under "scenario"
+    void Set(const std::string &key, const std::string &value) { m_scenario.emplace_back(key, Quote(value)); }
+    void Set(const std::string &key, const char *value) { Set(key, std::string(value)); }
+    void Set(const std::string &key, double value) { m_scenario.emplace_back(key, Number(value)); }
+    void SetFlag(const std::string &key, bool value) { m_scenario.emplace_back(key, value ? "true" : "false"); }
+
+    // Generator-specific extras (cache hits, skipped updates, ...), written under "extra"
+    void SetExtra(const std::string &key, double value) { m_extra.emplace_back(key, Number(value)); }
+
+    void MarkRunStart() { m_runStart = std::chrono::steady_clock::now(); }
+
+    // Right after Simulator::Run returns, while the simulator still exists
+    void MarkRunEnd()
+    {
+        m_runEnd = std::chrono::steady_clock::now();
+        m_executed = Simulator::GetEventCount();
+        StringValue impl;
+        StringValue sched;
+        GlobalValue::GetValueByName("SimulatorImplementationType", impl);
+        GlobalValue::GetValueByName("SchedulerType", sched);
+        m_impl = impl.Get();
+        m_scheduler = sched.Get();
+    }
+
+    // One SampleAndWrite call: wall time spent in it and rows it produced
+    void AddWindow(uint64_t ns, uint64_t rows)
+    {
+        m_windowNs.push_back(ns);
+        m_rows += rows;
+    }
+
+    // Rows written outside SampleAndWrite (rows a class balancer held until the run ended)
+    void AddRows(uint64_t rows) { m_rows += rows; }
+
+    void SetBytesWritten(uint64_t bytes) { m_bytes = bytes; }
+
+    // dataset_X.csv -> dataset_X.manifest.json
+    static std::string SidecarPath(const std::string &csvPath)
+    {
+        std::string base = csvPath;
+        if (base.size() > 4 && base.compare(base.size() - 4, 4, ".csv") == 0) base.resize(base.size() - 4);
+        return base + ".manifest.json";
+    }
+
+    // Call last, after Simulator::Destroy; everything since MarkRunEnd counts as teardown
+    bool Write(const std::string &path) const
+    {
+        auto now = std::chrono::steady_clock::now();
+        double setupSec = std::chrono::duration<double>(m_runStart - m_wallStart).count();
+        double runSec = std::chrono::duration<double>(m_runEnd - m_runStart).count();
+        double teardownSec = std::chrono::duration<double>(now - m_runEnd).count();
+
+        std::vector<uint64_t> sorted(m_windowNs);
+        std::sort(sorted.begin(), sorted.end());
+        uint64_t totalNs = 0;
+        for (uint64_t ns : sorted) totalNs += ns;
+
+        struct rusage ru;
+        getrusage(RUSAGE_SELF, &ru);
+        int64_t scheduled = m_counting ? static_cast<int64_t>(CountingSimulatorImpl::Scheduled()) : -1;
+
+        std::ostringstream js;
+        js << "{\n  \"manifest_version\": 1,\n  \"scenario\": {";
+        for (size_t i = 0; i < m_scenario.size(); ++i)
+        {
+            js << (i ? ", " : "") << Quote(m_scenario[i].first) << ": " << m_scenario[i].second;
+        }
+        js << "},\n";
+        js << "  \"simulator\": {\"implementation\": " << Quote(m_impl) << ", \"scheduler\": " << Quote(m_scheduler)
+           << "},\n";
+        js << "  \"events_scheduled\": " << scheduled << ",\n";
+        js << "  \"events_executed\": " << m_executed << ",\n";
+        js << "  \"wall_s\": {\"setup\": " << Number(setupSec) << ", \"run\": " << Number(runSec)
+           << ", \"teardown\": " << Number(teardownSec) << ", \"total\": " << Number(setupSec + runSec + teardownSec)
+           << "},\n";
+        js << "  \"peak_rss_kb\": " << ru.ru_maxrss << ",\n";
+        js << "  \"rows\": " << m_rows << ",\n";
+        js << "  \"bytes\": " << m_bytes << ",\n";
+        js << "  \"windows\": {\"count\": " << sorted.size() << ", \"total_ms\": " << Number(totalNs / 1e6)
+           << ", \"mean_us\": " << Number(sorted.empty() ? 0.0 : totalNs / 1e3 / sorted.size())
+           << ", \"p50_us\": " << Number(Percentile(sorted, 0.50) / 1e3)
+           << ", \"p99_us\": " << Number(Percentile(sorted, 0.99) / 1e3)
+           << ", \"max_us\": " << Number(sorted.empty() ? 0.0 : sorted.back() / 1e3) << "}";
+        if (!m_extra.empty())
+        {
+            js << ",\n  \"extra\": {";
+            for (size_t i = 0; i < m_extra.size(); ++i)
+            {
+                js << (i ? ", " : "") << Quote(m_extra[i].first) << ": " << m_extra[i].second;
+            }
+            js << "}";
+        }
+        js << "\n}\n";
+
+        std::ofstream out(path, std::ios::out);
+        out << js.str();
+        return out.good();
+    }
+
+  private:
+    static double Percentile(const std::vector<uint64_t> &sorted, double q)
+    {
+        if (sorted.empty()) return 0.0;
+        return static_cast<double>(sorted[static_cast<size_t>(q * (sorted.size() - 1))]);
+    }
+
+    static std::string Number(double v)
+    {
+        if (!std::isfinite(v)) return "null";
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.9g", v);
+        return buf;
+    }
+
+    static std::string Quote(const std::string &s)
+    {
+        std::string q = "\"";
+        for (char c : s)
+        {
+            if (c == '"' || c == '\\') q += '\\';
+            if (static_cast<unsigned char>(c) < 0x20) continue;
+            q += c;
+        }
+        return q + "\"";
+    }
+
+    std::chrono::steady_clock::time_point m_wallStart;
+    std::chrono::steady_clock::time_point m_runStart;
+    std::chrono::steady_clock::time_point m_runEnd;
+    bool m_counting = false;
+    uint64_t m_executed = 0;
+    std::string m_impl;
+    std::string m_scheduler;
+    std::vector<std::pair<std::string, std::string>> m_scenario;
+    std::vector<std::pair<std::string, std::string>> m_extra;
+    std::vector<uint64_t> m_windowNs;
+    uint64_t m_rows = 0;
+    uint64_t m_bytes = 0;
+};
+
+} // namespace ns3
+
+#endif // RUN_MANIFEST_H
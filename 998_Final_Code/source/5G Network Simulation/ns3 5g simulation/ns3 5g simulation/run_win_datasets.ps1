@@ -12,6 +12,7 @@ New-Item -ItemType Directory -Force -Path $outDir | Out-Null
 $srcFile = Join-Path $PSScriptRoot "simple_ddos_dataset.cc"
 $dstFile = Join-Path $NsPath "scratch\simple_ddos_dataset.cc"
 Copy-Item -Path $srcFile -Destination $dstFile -Force
+Copy-Item -Path (Join-Path $PSScriptRoot "*.h") -Destination (Join-Path $NsPath "scratch") -Force
 Write-Host "Copied dataset generator to $dstFile"
 
 if ($CopyOnly) {
@@ -0,0 +1,253 @@
+// scoped_trace.h - Compile-time scoped timers exported as Chrome trace-event JSON
+// Build with -DDDOS_TRACE to enable; without it every TRACE_* macro expands to nothing, so
+// the generators compile to exactly the same code as before.
+//
+// Events go into a fixed-size ring per thread. Only the owning thread writes its ring,
+// so recording is a clock read plus a store. The registry lock is taken once per thread,
+// when its ring is created. A full ring overwrites its oldest events. TRACE_EXPORT writes
+// all rings as {"traceEvents": [...]} for chrome://tracing or https://ui.perfetto.dev.
+//
+//   TRACE_SCOPE("poll");                        complete event for the enclosing block
+//   TRACE_LAPS(t, "delta", "format");           split one block into named phases that
+//   TRACE_LAP(t, 0); ... TRACE_LAP(t, 1); ...   interleave (e.g. per flow); each phase is
+//   TRACE_LAPS_END(t);                          emitted once with its summed time
+//   TRACE_CHECKPOINTS(Seconds(1));              sim time / executed events counters
+//   TRACE_EXPORT("run.trace.json");
+
+#ifndef SCOPED_TRACE_H
+#define SCOPED_TRACE_H
+
+#ifdef DDOS_TRACE
+
+#include "ns3/core-module.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+namespace trace
+{
+
+struct TraceEvent
+{
+    const char *name; // string literal
+    uint64_t startNs;
+    uint64_t durNs;
+    uint64_t value; // counter value ('C')
+    char phase;     // 'X' complete, 'C' counter, 'i' instant
+};
+
+class TraceRing
+{
+  public:
+    static const uint64_t kCapacity = 1 << 16; // power of two
+
+    explicit TraceRing(uint32_t tid)
+        : m_events(new TraceEvent[kCapacity]),
+          m_tid(tid)
+    {
+    }
+
+    // Owning thread only
+    void Push(const TraceEvent &e)
+    {
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+        m_events[head & (kCapacity - 1)] = e;
+        m_head.store(head + 1, std::memory_order_release);
+    }
+
+    uint64_t GetHead() const { return m_head.load(std::memory_order_acquire); }
+    const TraceEvent &At(uint64_t i) const { return m_events[i & (kCapacity - 1)]; }
+    uint32_t GetTid() const { return m_tid; }
+
+  private:
+    std::unique_ptr<TraceEvent[]> m_events;
+    std::atomic<uint64_t> m_head{0};
+    uint32_t m_tid;
+};
+
+class TraceRegistry
+{
+  public:
+    static TraceRegistry &Get()
+    {
+        static TraceRegistry registry;
+        return registry;
+    }
+
+    uint64_t Now() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_epoch).count();
+    }
+
+    TraceRing &Local()
+    {
+        thread_local TraceRing *ring = nullptr;
+        if (!ring)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_rings.emplace_back(new TraceRing(static_cast<uint32_t>(m_rings.size())));
+            ring = m_rings.back().get();
+        }
+        return *ring;
+    }
+
+    // Call once recording threads are idle (after Simulator::Run)
+    bool Export(const std::string &path)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        FILE *f = std::fopen(path.c_str(), "w");
+        if (!f) return false;
+        std::fprintf(f, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+        bool first = true;
+        uint64_t dropped = 0;
+        for (const auto &ring : m_rings)
+        {
+            uint64_t head = ring->GetHead();
+            uint64_t begin = head > TraceRing::kCapacity ? head - TraceRing::kCapacity : 0;
+            dropped += begin;
+            for (uint64_t i = begin; i < head; ++i)
+            {
+                const TraceEvent &e = ring->At(i);
+                std::fprintf(f, "%s", first ? "" : ",\n");
+                first = false;
+                if (e.phase == 'X')
+                {
+                    std::fprintf(f, "{\"name\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": %u}",
+                                 e.name, e.startNs / 1e3, e.durNs / 1e3, ring->GetTid());
+                }
+                else if (e.phase == 'C')
+                {
+                    std::fprintf(f, "{\"name\": \"%s\", \"ph\": \"C\", \"ts\": %.3f, \"pid\": 1, \"args\": {\"value\": %llu}}",
+                                 e.name, e.startNs / 1e3, static_cast<unsigned long long>(e.value));
+                }
+                else
+                {
+                    std::fprintf(f, "{\"name\": \"%s\", \"ph\": \"i\", \"s\": \"p\", \"ts\": %.3f, \"pid\": 1, \"tid\": %u}",
+                                 e.name, e.startNs / 1e3, ring->GetTid());
+                }
+            }
+        }
+        std::fprintf(f, "%s{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"ns-3 (%llu events dropped)\"}}\n]}\n",
+                     first ? "" : ",\n", static_cast<unsigned long long>(dropped));
+        return std::fclose(f) == 0;
+    }
+
+  private:
+    std::chrono::steady_clock::time_point m_epoch = std::chrono::steady_clock::now();
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<TraceRing>> m_rings;
+};
+
+class TraceScope
+{
+  public:
+    explicit TraceScope(const char *name)
+        : m_name(name),
+          m_start(TraceRegistry::Get().Now())
+    {
+    }
+
+    ~TraceScope()
+    {
+        TraceRegistry &reg = TraceRegistry::Get();
+        reg.Local().Push({m_name, m_start, reg.Now() - m_start, 0, 'X'});
+    }
+
+  private:
+    const char *m_name;
+    uint64_t m_start;
+};
+
+// Lap timer: Lap(i) charges the time since the previous lap to the previous phase. End()
+// emits the phases back to back from the first lap, so they nest under an enclosing scope.
+class TraceLaps
+{
+  public:
+    static const int kMaxPhases = 6;
+
+    template <typename... Names>
+    explicit TraceLaps(Names... names)
+        : m_names{names...}
+    {
+        static_assert(sizeof...(Names) <= kMaxPhases, "too many trace phases");
+    }
+
+    ~TraceLaps() { End(); }
+
+    void Lap(int phase)
+    {
+        uint64_t now = TraceRegistry::Get().Now();
+        if (m_current >= 0) m_total[m_current] += now - m_last;
+        else m_first = now;
+        m_current = phase;
+        m_last = now;
+    }
+
+    void End()
+    {
+        if (m_current < 0) return;
+        TraceRegistry &reg = TraceRegistry::Get();
+        m_total[m_current] += reg.Now() - m_last;
+        uint64_t t = m_first;
+        for (int i = 0; i < kMaxPhases && m_names[i]; ++i)
+        {
+            reg.Local().Push({m_names[i], t, m_total[i], 0, 'X'});
+            t += m_total[i];
+        }
+        m_current = -1;
+    }
+
+  private:
+    const char *m_names[kMaxPhases] = {};
+    uint64_t m_total[kMaxPhases] = {};
+    uint64_t m_first = 0;
+    uint64_t m_last = 0;
+    int m_current = -1;
+};
+
+inline void TraceCounter(const char *name, uint64_t value)
+{
+    TraceRegistry &reg = TraceRegistry::Get();
+    reg.Local().Push({name, reg.Now(), 0, value, 'C'});
+}
+
+inline void TraceCheckpoint(Time period)
+{
+    TraceRegistry &reg = TraceRegistry::Get();
+    reg.Local().Push({"checkpoint", reg.Now(), 0, 0, 'i'});
+    TraceCounter("sim_time_ms", static_cast<uint64_t>(Simulator::Now().GetMilliSeconds()));
+    TraceCounter("events_executed", Simulator::GetEventCount());
+    Simulator::Schedule(period, &TraceCheckpoint, period);
+}
+
+} // namespace trace
+} // namespace ns3
+
+#define TRACE_CAT2(a, b) a##b
+#define TRACE_CAT(a, b) TRACE_CAT2(a, b)
+#define TRACE_SCOPE(name) ::ns3::trace::TraceScope TRACE_CAT(traceScope_, __LINE__)(name)
+#define TRACE_LAPS(var, ...) ::ns3::trace::TraceLaps var(__VA_ARGS__)
+#define TRACE_LAP(var, phase) var.Lap(phase)
+#define TRACE_LAPS_END(var) var.End()
+#define TRACE_CHECKPOINTS(period) ::ns3::Simulator::Schedule(period, &::ns3::trace::TraceCheckpoint, period)
+#define TRACE_EXPORT(path) ::ns3::trace::TraceRegistry::Get().Export(path)
+
+#else // DDOS_TRACE
+
+#define TRACE_SCOPE(name) static_cast<void>(0)
+#define TRACE_LAPS(var, ...) static_cast<void>(0)
+#define TRACE_LAP(var, phase) static_cast<void>(0)
+#define TRACE_LAPS_END(var) static_cast<void>(0)
+#define TRACE_CHECKPOINTS(period) static_cast<void>(0)
+#define TRACE_EXPORT(path) static_cast<void>(0)
+
+#endif // DDOS_TRACE
+
+#endif // SCOPED_TRACE_H
@@ -9,8 +9,27 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/netanim-module.h"
 
+#include "ddos_flood_app.h"
+#include "bounded_flow_tracker.h"
+#include "class_balancer.h"
+#include "flow_tensor_writer.h"
+#include "flow_window_sampler.h"
+#include "queue_monitor.h"
+#include "run_manifest.h"
+#include "scoped_trace.h"
+#include "star_routing.h"
+#include "trajectory_mobility.h"
+#include "window_socket_sink.h"
+#include "window_stream.h"
+
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#endif
+
 #include <algorithm>
+#include <chrono>
 #include <fstream>
+#include <iostream>
 #include <map>
 #include <random>
 #include <set>
@@ -20,160 +39,255 @@ using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("SimpleDdosDataset");
 
-struct FlowKey
-{
-    Ipv4Address src;
-    Ipv4Address dst;
-    uint16_t srcPort;
-    uint16_t dstPort;
-    uint8_t protocol; // 6 TCP, 17 UDP
-
-    bool operator<(const FlowKey &other) const
-    {
-        if (src != other.src) return src < other.src;
-        if (dst != other.dst) return dst < other.dst;
-        if (srcPort != other.srcPort) return srcPort < other.srcPort;
-        if (dstPort != other.dstPort) return dstPort < other.dstPort;
-        return protocol < other.protocol;
-    }
-};
-
-struct FlowSnapshot
+static FlowWindowSampler g_sampler;
+static BoundedFlowTracker g_tracker;
+static bool g_useTracker = false; // bounded tracker instead of FlowMonitor
+static uint32_t g_spoofSources = 0;
+static const Ipv4Address g_spoofBase("172.16.0.0"); // spoofed sources live in 172.16.0.0/12
+static QueueMonitor g_queues; // hub -> UE queue discs and device queues, keyed by UE address
+static bool g_queueFeatures = false;
+static RunManifest g_manifest; // JSON sidecar with the run's cost
+static bool g_shard = false; // distributed run: this rank writes one shard, merged by tools/merge_shards.py
+static WindowSocketSink g_sink; // live rows to a local scorer (--sinkSocket)
+static FlowTensorWriter g_tensors; // per-flow float32 matrices (--tensors)
+static WindowStreamWriter g_stream; // delta-encoded, block-compressed rows (--output=dws|both)
+static bool g_writeCsv = true; // --output=csv|both
+
+// A row the class balancer holds until run end, with the per-window state it is formatted from
+struct HeldRow
 {
-    uint64_t txPackets = 0;
-    uint64_t rxPackets = 0;
-    uint64_t txBytes = 0;
-    uint64_t rxBytes = 0;
-    uint64_t lostPackets = 0;
-    double delaySum = 0.0;  // seconds
-    double jitterSum = 0.0; // seconds
+    WindowRow row;
+    double timeStart;
+    double timeEnd;
+    bool attack;
+    QueueWindow queue;
 };
-
-static std::map<FlowKey, FlowSnapshot> g_prev;
+static ClassBalancer<HeldRow> g_balancer; // per-class row budgets, weight column (--balance)
 static std::ofstream g_out;
 static double g_windowStart = 0.0;
+static uint64_t g_windowIndex = 0;
+static double g_lastFlush = 0.0;
 static double g_windowSize = 1.0; // seconds
 static std::string g_scenarioId;
 static uint32_t g_ueTotal = 0;
 static std::set<uint32_t> g_attackers;
+static std::set<uint32_t> g_attackerAddresses; // UE addresses of g_attackers, for labelling
 static std::map<uint32_t, bool> g_isServer;
 
 static Ptr<Ipv4FlowClassifier> g_classifier;
 static Ptr<FlowMonitor> g_monitor;
 
+// Column names, shared by the CSV header and the window stream's schema
+static std::vector<std::string> CsvColumns()
+{
+    std::vector<std::string> columns = {
+        "time_start", "time_end", "scenario_id", "ue_total", "attackers",
+        "src_ip", "dst_ip", "src_port", "dst_port", "protocol", "packet_size",
+        "flow_duration", "total_bytes_fwd", "total_bytes_bwd", "total_pkts_fwd", "total_pkts_bwd",
+        "pkts_per_sec", "bytes_per_sec", "flow_pkts_per_sec", "flow_bytes_per_sec",
+        "jitter_ms", "delay_ms", "label_binary", "label_intensity"};
+    if (g_queueFeatures)
+    {
+        columns.insert(columns.end(), {"dst_queue_max_pkts", "dst_queue_mean_pkts", "dst_queue_enq_pkts",
+                                       "dst_queue_drop_pkts", "dst_queue_full_ms"});
+        if (!g_useTracker)
+        {
+            columns.push_back("lost_pkts"); // the bounded tracker does not see losses
+        }
+    }
+    if (g_shard)
+    {
+        columns.push_back("rx_pkts");
+    }
+    if (g_balancer.IsEnabled())
+    {
+        columns.push_back("weight");
+    }
+    return columns;
+}
+
 static void WriteCsvHeader()
 {
-    g_out << "time_start,time_end,scenario_id,ue_total,attackers,";
-    g_out << "src_ip,dst_ip,src_port,dst_port,protocol,packet_size,";
-    g_out << "flow_duration,total_bytes_fwd,total_bytes_bwd,total_pkts_fwd,total_pkts_bwd,";
-    g_out << "pkts_per_sec,bytes_per_sec,flow_pkts_per_sec,flow_bytes_per_sec,";
-    g_out << "jitter_ms,delay_ms,label_binary,label_intensity\n";
+    std::vector<std::string> columns = CsvColumns();
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        g_out << (i ? "," : "") << columns[i];
+    }
+    g_out << "\n";
 }
 
-static void SampleAndWrite()
+static void FormatRow(const WindowRow &r, double timeStart, double timeEnd, bool attackBinary,
+                      const QueueWindow &q, double weight)
 {
-    // Poll current stats
-    g_monitor->CheckForLostPackets();
-    auto stats = g_monitor->GetFlowStats();
-
-    std::map<FlowKey, FlowSnapshot> current;
-
-    for (const auto &kv : stats)
-    {
-        FlowId id = kv.first;
-        const FlowMonitor::FlowStats &st = kv.second;
-        Ipv4FlowClassifier::FiveTuple t = g_classifier->FindFlow(id);
-
-        FlowKey key{t.sourceAddress, t.destinationAddress, t.sourcePort, t.destinationPort, t.protocol};
-        FlowSnapshot snap;
-        snap.txPackets = st.txPackets;
-        snap.rxPackets = st.rxPackets;
-        snap.txBytes = st.txBytes;
-        snap.rxBytes = st.rxBytes;
-        snap.lostPackets = st.lostPackets;
-        snap.delaySum = st.delaySum.GetSeconds();
-        snap.jitterSum = st.jitterSum.GetSeconds();
-        current[key] = snap;
-    }
-
-    // For each forward flow, find reverse to compute bwd
-    for (const auto &kv : current)
-    {
-        const FlowKey &fwdKey = kv.first;
-        const FlowSnapshot &curFwd = kv.second;
-
-        FlowKey revKey{fwdKey.dst, fwdKey.src, fwdKey.dstPort, fwdKey.srcPort, fwdKey.protocol};
-        FlowSnapshot curBwd = current.count(revKey) ? current[revKey] : FlowSnapshot{};
-
-        FlowSnapshot prevFwd = g_prev.count(fwdKey) ? g_prev[fwdKey] : FlowSnapshot{};
-        FlowSnapshot prevBwd = g_prev.count(revKey) ? g_prev[revKey] : FlowSnapshot{};
-
-        uint64_t dTxPktsF = curFwd.txPackets - prevFwd.txPackets;
-        uint64_t dRxPktsF = curFwd.rxPackets - prevFwd.rxPackets;
-        uint64_t dTxBytesF = curFwd.txBytes - prevFwd.txBytes;
-        uint64_t dRxBytesF = curFwd.rxBytes - prevFwd.rxBytes;
-
-        uint64_t dTxPktsB = curBwd.txPackets - prevBwd.txPackets;
-        uint64_t dRxPktsB = curBwd.rxPackets - prevBwd.rxPackets;
-        uint64_t dTxBytesB = curBwd.txBytes - prevBwd.txBytes;
-        uint64_t dRxBytesB = curBwd.rxBytes - prevBwd.rxBytes;
-
-        uint64_t totalPktsFwd = dTxPktsF + dRxPktsF;
-        uint64_t totalPktsBwd = dTxPktsB + dRxPktsB;
-        uint64_t totalBytesFwd = dTxBytesF + dRxBytesF;
-        uint64_t totalBytesBwd = dTxBytesB + dRxBytesB;
-
-        double duration = g_windowSize;
-        double pktsPerSec = (totalPktsFwd + totalPktsBwd) / duration;
-        double bytesPerSec = (totalBytesFwd + totalBytesBwd) / duration;
-        double flowPktsPerSec = totalPktsFwd / duration;
-        double flowBytesPerSec = totalBytesFwd / duration;
-
-        double avgDelayMs = 0.0;
-        double avgJitterMs = 0.0;
-        uint64_t dRxPktsAll = dRxPktsF + dRxPktsB;
-        double dDelay = (curFwd.delaySum + curBwd.delaySum) - (prevFwd.delaySum + prevBwd.delaySum);
-        double dJitter = (curFwd.jitterSum + curBwd.jitterSum) - (prevFwd.jitterSum + prevBwd.jitterSum);
-        if (dRxPktsAll > 0)
+    int attackIntensity = attackBinary ? 3 : 0;
+    g_out << timeStart << "," << timeEnd << "," << g_scenarioId << "," << g_ueTotal << ","
+          << g_attackers.size() << ",";
+    g_out << r.key.src << "," << r.key.dst << "," << r.key.srcPort << "," << r.key.dstPort << ","
+          << unsigned(r.key.protocol) << "," << r.avgPktSize << ",";
+    g_out << r.duration << "," << r.totalBytesFwd << "," << r.totalBytesBwd << "," << r.totalPktsFwd << ","
+          << r.totalPktsBwd << ",";
+    g_out << r.pktsPerSec << "," << r.bytesPerSec << "," << r.flowPktsPerSec << "," << r.flowBytesPerSec << ",";
+    g_out << r.avgJitterMs << "," << r.avgDelayMs << "," << (attackBinary ? 1 : 0) << "," << attackIntensity;
+    if (g_queueFeatures)
+    {
+        // Congestion on the hub device that delivers to this flow's destination
+        g_out << "," << q.maxPkts << "," << q.meanPkts << "," << q.enqueued << "," << q.dropped << "," << q.fullMs;
+        if (!g_useTracker)
         {
-            avgDelayMs = 1000.0 * dDelay / static_cast<double>(dRxPktsAll);
-            avgJitterMs = 1000.0 * dJitter / static_cast<double>(dRxPktsAll);
+            g_out << "," << r.lostPkts;
         }
+    }
+    if (g_shard)
+    {
+        // Each rank sees only its own nodes' half of a cross-rank flow; the merge sums the
+        // halves and weights delay and jitter by this count
+        g_out << "," << r.rxPkts;
+    }
+    if (g_balancer.IsEnabled())
+    {
+        g_out << "," << weight;
+    }
+    g_out << "\n";
+}
+
+// The row FormatRow() writes, as deltas against the flow's previous row (window_stream.h)
+static void EncodeRow(const WindowRow &r, double timeStart, double timeEnd, bool attackBinary,
+                      const QueueWindow &q, double weight)
+{
+    g_stream.BeginRow(timeStart, timeEnd, r.key.src.Get(), r.key.dst.Get(), r.key.srcPort, r.key.dstPort,
+                      r.key.protocol);
+    g_stream.Float(r.avgPktSize);
+    g_stream.Float(r.duration);
+    g_stream.Int(r.totalBytesFwd);
+    g_stream.Int(r.totalBytesBwd);
+    g_stream.Int(r.totalPktsFwd);
+    g_stream.Int(r.totalPktsBwd);
+    g_stream.Float(r.pktsPerSec);
+    g_stream.Float(r.bytesPerSec);
+    g_stream.Float(r.flowPktsPerSec);
+    g_stream.Float(r.flowBytesPerSec);
+    g_stream.Float(r.avgJitterMs);
+    g_stream.Float(r.avgDelayMs);
+    g_stream.Int(attackBinary ? 1 : 0);
+    g_stream.Int(attackBinary ? 3 : 0);
+    if (g_queueFeatures)
+    {
+        g_stream.Int(q.maxPkts);
+        g_stream.Float(q.meanPkts);
+        g_stream.Int(q.enqueued);
+        g_stream.Int(q.dropped);
+        g_stream.Float(q.fullMs);
+        if (!g_useTracker)
+        {
+            g_stream.Int(r.lostPkts);
+        }
+    }
+    if (g_shard)
+    {
+        g_stream.Int(r.rxPkts);
+    }
+    if (g_balancer.IsEnabled())
+    {
+        g_stream.Float(weight);
+    }
+    g_stream.EndRow();
+}
+
+// Writes a row to the CSV and/or the window stream, per --output
+static void EmitRow(const WindowRow &r, double timeStart, double timeEnd, bool attackBinary, const QueueWindow &q,
+                    double weight)
+{
+    if (g_writeCsv) FormatRow(r, timeStart, timeEnd, attackBinary, q, weight);
+    if (g_stream.IsOpen()) EncodeRow(r, timeStart, timeEnd, attackBinary, q, weight);
+}
 
-        // Label: if the source UE is in attackers set, mark attack
-        // Extract node ID from IP address (last octet)
-        uint32_t srcNodeId = fwdKey.src.Get() & 0xFF;
-        bool isAttacker = g_attackers.count(srcNodeId) > 0;
-        bool attackBinary = isAttacker || (flowPktsPerSec > 5000.0); // heuristic for high-rate DDoS
-        int attackIntensity = attackBinary ? 3 : 0;
-
-        // Packet size: average in window
-        double avgPktSize = 0.0;
-        uint64_t pktsAll = totalPktsFwd + totalPktsBwd;
-        if (pktsAll > 0)
+// Labels a row, hands it to the live consumers and, unless the class balancer skips or holds
+// it, formats it. Returns true if the row was written now.
+static bool WriteRow(const WindowRow &r, double timeEnd)
+{
+    // Label: if the source is an attacking UE's address, mark attack. Matched on the whole
+    // address: UEs continue past 10.1.1.x, so the last octet alone aliases other UEs.
+    bool isAttacker = g_attackerAddresses.count(r.key.src.Get()) > 0;
+    bool isSpoofed = g_spoofSources > 0 && (r.key.src.Get() & 0xFFF00000) == g_spoofBase.Get();
+    bool attackBinary = isAttacker || isSpoofed || (r.flowPktsPerSec > 5000.0); // heuristic for high-rate DDoS
+    int attackIntensity = attackBinary ? 3 : 0;
+    if (g_sink.IsOpen()) g_sink.AddRow(r, attackBinary, attackIntensity);
+    if (g_tensors.IsEnabled()) g_tensors.AddRow(r, g_windowIndex, attackBinary, attackIntensity);
+
+    static const QueueWindow noQueue;
+    const QueueWindow &q = g_queueFeatures ? g_queues.Find(r.key.dst) : noQueue;
+    double weight = 1.0;
+    if (g_balancer.IsEnabled())
+    {
+        HeldRow *slot = nullptr;
+        switch (g_balancer.Offer(attackBinary, slot, weight))
         {
-            avgPktSize = static_cast<double>(totalBytesFwd + totalBytesBwd) / static_cast<double>(pktsAll);
+        case ClassBalancer<HeldRow>::SKIP:
+            return false;
+        case ClassBalancer<HeldRow>::HOLD:
+            *slot = HeldRow{r, g_windowStart, timeEnd, attackBinary, q};
+            return false;
+        case ClassBalancer<HeldRow>::WRITE:
+            break;
         }
+    }
+    EmitRow(r, g_windowStart, timeEnd, attackBinary, q, weight);
+    return true;
+}
 
-        double timeEnd = g_windowStart + g_windowSize;
+static void SampleAndWrite()
+{
+    TRACE_SCOPE("SampleAndWrite");
+    // Window bounds from the index so fine windows (10-100 ms) do not accumulate rounding error
+    g_windowStart = g_windowIndex * g_windowSize;
+    double timeEnd = (g_windowIndex + 1) * g_windowSize;
+    auto sampleStart = std::chrono::steady_clock::now();
+    uint64_t rows = 0;
+
+    if (g_queueFeatures)
+    {
+        TRACE_SCOPE("queues");
+        g_queues.CloseWindow(g_windowSize);
+    }
 
-        g_out << g_windowStart << "," << timeEnd << "," << g_scenarioId << "," << g_ueTotal << ","
-              << g_attackers.size() << ",";
-        g_out << fwdKey.src << "," << fwdKey.dst << "," << fwdKey.srcPort << "," << fwdKey.dstPort << ","
-              << unsigned(fwdKey.protocol) << "," << avgPktSize << ",";
-        g_out << duration << "," << totalBytesFwd << "," << totalBytesBwd << "," << totalPktsFwd << ","
-              << totalPktsBwd << ",";
-        g_out << pktsPerSec << "," << bytesPerSec << "," << flowPktsPerSec << "," << flowBytesPerSec << ",";
-        g_out << avgJitterMs << "," << avgDelayMs << "," << (attackBinary ? 1 : 0) << "," << attackIntensity << "\n";
+    auto write = [timeEnd, &rows](const WindowRow &r) { rows += WriteRow(r, timeEnd); };
+    if (g_useTracker)
+    {
+        g_tracker.Sample(g_windowSize, write);
+    }
+    else
+    {
+        g_sampler.Sample(g_windowSize, write);
+    }
+    if (g_sink.IsOpen())
+    {
+        TRACE_SCOPE("sink");
+        g_sink.EndWindow(g_windowStart, timeEnd);
     }
 
-    g_out.flush();
-    g_prev = std::move(current);
-    g_windowStart += g_windowSize;
+    // Flush at most once per simulated second; sub-second windows would otherwise flush every tick
+    if (timeEnd - g_lastFlush >= 1.0)
+    {
+        TRACE_SCOPE("flush");
+        g_out.flush();
+        g_lastFlush = timeEnd;
+    }
+    g_manifest.AddWindow(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - sampleStart).count(), rows);
+    g_windowIndex++;
 
     Simulator::Schedule(Seconds(g_windowSize), &SampleAndWrite);
 }
 
+// Rank that owns UE i: contiguous blocks of UEs, or of aggregation hubs with their UEs in a
+// two-tier layout, so only hub links cross ranks. The core hub stays on rank 0.
+static uint32_t UeRank(uint32_t i, uint32_t nodeTotal, uint32_t hubFanout, uint32_t ranks)
+{
+    if (hubFanout == 0) return static_cast<uint64_t>(i) * ranks / nodeTotal;
+    uint32_t aggTotal = (nodeTotal + hubFanout - 1) / hubFanout;
+    return static_cast<uint64_t>(i / hubFanout) * ranks / aggTotal;
+}
+
 int main(int argc, char *argv[])
 {
     uint16_t nodeTotal = 25;
@@ -186,34 +300,181 @@ int main(int argc, char *argv[])
     Time appStart = Seconds(0.5);
     Time attackInterval = Seconds(0.0002); // intensity control
     Time benignInterval = Seconds(0.02);
+    std::string trajectoryFile; // precomputed .trj walk replayed instead of RandomWalk2d
+    bool floodApp = true; // burst-scheduled attacker instead of UdpClient/OnOff
+    uint32_t attackBurst = 10; // packets per scheduled attack event
+    std::string attackProfile = "constant"; // constant|ramp|pulse|onoff|lowslow
+    Time attackRampTime = Seconds(5.0);
+    Time attackPulsePeriod = Seconds(1.0); // shrew: period near the 1 s TCP minRTO
+    Time attackPulseWidth = MilliSeconds(100);
+    Time attackOnTime = Seconds(1.0);
+    Time attackOffTime = Seconds(1.0);
+    DataRate lowSlowRate("64kbps");
+    uint32_t lowSlowSize = 128;
+    std::string flowTracker = "monitor"; // monitor|bounded
+    uint32_t trackerMaxFlows = 65536;
+    Time trackerIdle = Seconds(2.0);
+    std::string routing = "star"; // star|global|none
+    uint32_t hubFanout = 0; // 0 = single hub; k = core hub + one aggregation hub per k UEs
+    bool writeManifest = true; // <csv>.manifest.json with events, wall time, RSS, rows
+    uint32_t seed = 0; // 0 = server/client draw from std::random_device, as before
+    std::string scheduler; // empty = ns-3 default (MapScheduler)
+    bool distributed = false; // MPI: UEs split across ranks, one CSV shard per rank
+    std::string sinkSocket; // Unix socket of a live scorer; empty = CSV only
+    std::string sinkBackpressure = "block"; // block|drop|sample
+    uint32_t sinkBuffer = 4 << 20; // bytes queued for the scorer before drop/sample kicks in
+    bool tensors = false; // <csv>.ftns with each flow's windows as one float32 matrix
+    std::string balance = "off"; // off|rate|reservoir per-class row selection
+    uint64_t balanceBudget = 5000; // rows kept per class per run (reservoir)
+    double balanceKeepAttack = 1.0; // probability an attack row is kept (rate)
+    double balanceKeepBenign = 1.0; // probability a benign row is kept (rate)
+    std::string output = "csv"; // csv|dws|both: text rows and/or the delta-encoded window stream
+    std::string dwsCodec = "auto"; // auto|raw|lz4|zstd block compression of the window stream
 
     CommandLine cmd;
     cmd.AddValue("ueTotal", "Number of UEs", nodeTotal);
     cmd.AddValue("mobile", "If true, UEs move (RandomWalk)", mobile);
+    cmd.AddValue("trajectoryFile", "Replay UE movement from a tools/trajectory_gen .trj file (mobile only)", trajectoryFile);
     cmd.AddValue("useTcp", "Use TCP instead of UDP", useTcp);
     cmd.AddValue("enableAttack", "Enable DDoS attackers", enableAttack);
     cmd.AddValue("attackInterval", "Inter-packet interval for attackers", attackInterval);
     cmd.AddValue("benignInterval", "Inter-packet interval for benign clients", benignInterval);
+    cmd.AddValue("floodApp", "Use the burst-scheduled DdosFloodApplication for attackers", floodApp);
+    cmd.AddValue("attackBurst", "Packets per attack event (floodApp only)", attackBurst);
+    cmd.AddValue("attackProfile", "Attack rate profile: constant|ramp|pulse|onoff|lowslow (floodApp only)", attackProfile);
+    cmd.AddValue("attackRampTime", "Time to reach the peak attack rate (ramp)", attackRampTime);
+    cmd.AddValue("attackPulsePeriod", "Attack pulse period (pulse)", attackPulsePeriod);
+    cmd.AddValue("attackPulseWidth", "Peak-rate time at the start of each pulse period (pulse)", attackPulseWidth);
+    cmd.AddValue("attackOnTime", "Attack on phase length (onoff)", attackOnTime);
+    cmd.AddValue("attackOffTime", "Attack off phase length (onoff)", attackOffTime);
+    cmd.AddValue("lowSlowRate", "Per-attacker offered load (lowslow)", lowSlowRate);
+    cmd.AddValue("lowSlowSize", "Attack packet size in bytes (lowslow)", lowSlowSize);
+    cmd.AddValue("spoofSources", "Distinct spoofed source IPs per UDP attacker (0 = no spoofing)", g_spoofSources);
+    cmd.AddValue("flowTracker", "Flow statistics source: monitor (FlowMonitor) or bounded", flowTracker);
+    cmd.AddValue("trackerMaxFlows", "Live flow cap for the bounded tracker", trackerMaxFlows);
+    cmd.AddValue("trackerIdle", "Idle timeout before the bounded tracker evicts a flow", trackerIdle);
+    cmd.AddValue("routing", "Routing: star (O(N) hub tables), global (Ipv4GlobalRouting) or none", routing);
+    cmd.AddValue("hubFanout", "UEs per aggregation hub in a two-tier layout (0 = single hub)", hubFanout);
+    cmd.AddValue("queueFeatures", "Append victim-side queue columns (hub -> dst device)", g_queueFeatures);
     cmd.AddValue("simTime", "Total simulation time", simTime);
     cmd.AddValue("outPath", "Output folder for CSV", outPath);
     cmd.AddValue("scenarioTag", "Scenario tag for scenario_id and file name", scenarioTag);
     cmd.AddValue("window", "Sampling window size (s)", g_windowSize);
+    cmd.AddValue("seed", "Fix the server/client draw and the ns-3 RNG seed (0 = random draw)", seed);
+    cmd.AddValue("scheduler", "Event scheduler: heap|calendar|map|list|priority or a TypeId (default map)", scheduler);
+    cmd.AddValue("distributed", "Split UEs across MPI ranks (run under mpirun; needs --seed)", distributed);
+    cmd.AddValue("sinkSocket", "Also stream each window's rows to a scorer listening on this Unix socket", sinkSocket);
+    cmd.AddValue("sinkBackpressure", "When the scorer falls behind: block|drop|sample", sinkBackpressure);
+    cmd.AddValue("sinkBuffer", "Bytes queued for the scorer before windows are dropped or sampled", sinkBuffer);
+    cmd.AddValue("tensors", "Also write a .ftns file with each flow's windows as a float32 matrix", tensors);
+    cmd.AddValue("balance", "Per-class row selection before formatting: off|rate|reservoir (adds a weight column)", balance);
+    cmd.AddValue("balanceBudget", "Rows kept per class per run (reservoir)", balanceBudget);
+    cmd.AddValue("balanceKeepAttack", "Probability an attack row is written (rate)", balanceKeepAttack);
+    cmd.AddValue("balanceKeepBenign", "Probability a benign row is written (rate)", balanceKeepBenign);
+    cmd.AddValue("output", "Rows as csv, dws (<csv>.dws delta-encoded stream; tools/window_stream_csv.cc converts) or both",
+                 output);
+    cmd.AddValue("dwsCodec", "Block compression of the .dws stream: auto|raw|lz4|zstd (built with -DDWS_WITH_*)", dwsCodec);
+    cmd.AddValue("manifest", "Write a .manifest.json performance sidecar next to the CSV", writeManifest);
     cmd.Parse(argc, argv);
+    NS_ABORT_MSG_IF(!SelectScheduler(scheduler), "Unknown scheduler " << scheduler);
+    NS_ABORT_MSG_IF(!sinkSocket.empty() && distributed, "--sinkSocket is not supported with --distributed");
+    NS_ABORT_MSG_IF(tensors && distributed, "--tensors is not supported with --distributed");
+    NS_ABORT_MSG_IF(balance != "off" && distributed, "--balance is not supported with --distributed");
+    NS_ABORT_MSG_IF(output != "csv" && distributed, "--output=" << output << " is not supported with --distributed");
+    NS_ABORT_MSG_IF(!g_balancer.Configure(balance, balanceBudget, balanceKeepAttack, balanceKeepBenign,
+                                          seed ? seed : std::random_device()()),
+                    "Invalid --balance=" << balance << " (budget " << balanceBudget << ", keep "
+                                         << balanceKeepAttack << "/" << balanceKeepBenign << ")");
+    NS_ABORT_MSG_IF(output != "csv" && output != "dws" && output != "both", "Invalid --output=" << output);
+    NS_ABORT_MSG_IF(trackerMaxFlows == 0 || trackerMaxFlows > BoundedFlowTracker::kMaxFlows,
+                    "--trackerMaxFlows must be in [1, " << BoundedFlowTracker::kMaxFlows << "]");
+    NS_ABORT_MSG_IF(g_spoofSources > DdosFloodApplication::kMaxSpoofSources,
+                    "--spoofSources is at most " << DdosFloodApplication::kMaxSpoofSources << " (one /12 from spoofBase)");
+    uint8_t streamCodec = kDwsRaw;
+    NS_ABORT_MSG_IF(output != "csv" && !WindowStreamParseCodec(dwsCodec, streamCodec),
+                    "--dwsCodec=" << dwsCodec << " is unknown or was not compiled in");
+    g_writeCsv = output != "dws";
+
+    uint32_t rank = 0;
+    uint32_t ranks = 1;
+    if (distributed)
+    {
+        // Every rank builds the whole topology and must draw the same servers and attackers
+        NS_ABORT_MSG_IF(seed == 0, "--distributed needs a fixed --seed shared by all ranks");
+        NS_ABORT_MSG_IF(g_queueFeatures, "--queueFeatures is not supported with --distributed");
+#ifdef NS3_MPI
+        GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::DistributedSimulatorImpl"));
+        MpiInterface::Enable(&argc, &argv);
+        rank = MpiInterface::GetSystemId();
+        ranks = MpiInterface::GetSize();
+#else
+        NS_ABORT_MSG("--distributed needs ns-3 configured with --enable-mpi");
+#endif
+        g_shard = true;
+    }
+    if (writeManifest)
+    {
+        g_manifest.Begin();
+    }
+    if (seed)
+    {
+        RngSeedManager::SetSeed(seed);
+    }
+    // Compiled in with -DDDOS_TRACE; exported to <csv>.trace.json
+    TRACE_LAPS(phases, "setup", "app_install", "monitor_install", "run", "teardown");
+    TRACE_LAP(phases, 0);
 
     g_ueTotal = nodeTotal;
+    // FlowMonitor never forgets a 5-tuple, so spoofed floods always use the bounded tracker.
+    // Distributed runs use it too: FlowMonitor matches rx to tx in per-process state, while the
+    // tracker's timestamp tag travels with the packet to the receiving rank.
+    g_useTracker = flowTracker == "bounded" || g_spoofSources > 0 || distributed;
 
     // Create output directory path + file
     std::ostringstream fname;
     fname << outPath << "/dataset_" << scenarioTag << "_ue" << nodeTotal << (useTcp ? "_tcp" : "_udp")
-          << (enableAttack ? "_ddos" : "_benign") << ".csv";
+          << (enableAttack ? "_ddos" : "_benign");
+    if (distributed)
+    {
+        fname << ".rank" << rank;
+    }
+    fname << ".csv";
     std::string fileName = fname.str();
+    std::string streamPath = fileName.substr(0, fileName.size() - 4) + ".dws";
 
-    g_out.open(fileName, std::ios::out);
-    WriteCsvHeader();
+    if (g_writeCsv)
+    {
+        g_out.open(fileName, std::ios::out);
+        WriteCsvHeader();
+    }
 
-    // Create nodes
+    g_manifest.Set("generator", "simple_ddos_dataset");
+    g_manifest.Set("scenario_tag", scenarioTag);
+    g_manifest.Set("ue_total", nodeTotal);
+    g_manifest.Set("mobility", mobile ? "mobile" : "static");
+    g_manifest.Set("transport", useTcp ? "tcp" : "udp");
+    g_manifest.Set("attack", enableAttack ? "ddos" : "benign");
+    g_manifest.Set("attack_interval_s", attackInterval.GetSeconds());
+    g_manifest.Set("sim_time_s", simTime.GetSeconds());
+    g_manifest.Set("window_s", g_windowSize);
+    g_manifest.Set("seed", seed);
+    g_manifest.Set("balance", balance);
+    g_manifest.Set("output", output);
+    g_manifest.Set("routing", routing);
+    g_manifest.Set("flow_tracker", g_useTracker ? "bounded" : "monitor");
+    if (distributed)
+    {
+        g_manifest.Set("rank", rank);
+        g_manifest.Set("ranks", ranks);
+    }
+
+    // Create nodes, each on the rank that simulates it (all on rank 0 unless distributed)
     NodeContainer nodes;
-    nodes.Create(nodeTotal);
+    for (uint32_t i = 0; i < nodeTotal; i++)
+    {
+        nodes.Create(1, UeRank(i, nodeTotal, hubFanout, ranks));
+    }
+    auto isLocal = [&nodes, rank](uint32_t i) { return nodes.Get(i)->GetSystemId() == rank; };
 
     // Set up mobility
     MobilityHelper mobility;
@@ -234,16 +495,31 @@ int main(int argc, char *argv[])
                                      "Y", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=100.0]"));
         mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
     }
-    mobility.Install(nodes);
+    if (mobile && !trajectoryFile.empty())
+    {
+        InstallTrajectories(nodes, trajectoryFile, simTime, Rectangle(0.0, 100.0, 0.0, 100.0));
+    }
+    else
+    {
+        mobility.Install(nodes);
+    }
 
-    // Create P2P links for all nodes to connect to a central node
+    // Create P2P links for all nodes to connect to a central node, either directly (star) or
+    // through aggregation hubs of hubFanout UEs each (two-tier)
+    uint32_t aggTotal = hubFanout > 0 ? (nodeTotal + hubFanout - 1) / hubFanout : 0;
     NodeContainer centralNode;
     centralNode.Create(1);
+    NodeContainer aggNodes;
+    for (uint32_t a = 0; a < aggTotal; a++)
+    {
+        aggNodes.Create(1, UeRank(a * hubFanout, nodeTotal, hubFanout, ranks));
+    }
     mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
     Ptr<ListPositionAllocator> centerPos = CreateObject<ListPositionAllocator>();
     centerPos->Add(Vector(50.0, 50.0, 0.0));
     mobility.SetPositionAllocator(centerPos);
     mobility.Install(centralNode);
+    mobility.Install(aggNodes);
 
     // Create P2P links
     PointToPointHelper p2p;
@@ -251,25 +527,95 @@ int main(int argc, char *argv[])
     p2p.SetChannelAttribute("Delay", StringValue("2ms"));
 
     NetDeviceContainer devices;
+    NetDeviceContainer hubDevices; // hub side of each UE link, i.e. the queue feeding UE i
     for (uint32_t i = 0; i < nodeTotal; i++)
     {
-        NetDeviceContainer link = p2p.Install(nodes.Get(i), centralNode.Get(0));
+        Ptr<Node> hub = aggTotal > 0 ? aggNodes.Get(i / hubFanout) : centralNode.Get(0);
+        NetDeviceContainer link = p2p.Install(nodes.Get(i), hub);
         devices.Add(link.Get(0));
+        hubDevices.Add(link.Get(1));
+    }
+    NetDeviceContainer coreDevices; // core side of each aggregation uplink
+    NetDeviceContainer aggUplinks;  // aggregation side
+    for (uint32_t a = 0; a < aggTotal; a++)
+    {
+        NetDeviceContainer link = p2p.Install(aggNodes.Get(a), centralNode.Get(0));
+        aggUplinks.Add(link.Get(0));
+        coreDevices.Add(link.Get(1));
     }
 
     // Install internet stack
     InternetStackHelper internet;
     internet.Install(nodes);
     internet.Install(centralNode);
+    internet.Install(aggNodes);
 
-    // Assign IP addresses
+    // Assign IP addresses. UEs keep 10.1.1.x for up to 254 nodes and continue into
+    // 10.1.2.x and beyond; hub-side interfaces use 10.2/16 and core uplinks 10.3/16.
     Ipv4AddressHelper ipv4;
-    ipv4.SetBase("10.1.1.0", "255.255.255.0");
+    ipv4.SetBase("10.1.0.0", "255.255.0.0", "0.0.1.1");
     Ipv4InterfaceContainer interfaces = ipv4.Assign(devices);
+    Ipv4InterfaceContainer hubInterfaces;
+    Ipv4InterfaceContainer aggInterfaces;
+    Ipv4InterfaceContainer coreInterfaces;
+    if (routing != "none")
+    {
+        Ipv4AddressHelper hubIp;
+        hubIp.SetBase("10.2.0.0", "255.255.0.0", "0.0.1.1");
+        hubInterfaces = hubIp.Assign(hubDevices);
+        Ipv4AddressHelper coreIp;
+        coreIp.SetBase("10.3.0.0", "255.255.0.0", "0.0.1.1");
+        aggInterfaces = coreIp.Assign(aggUplinks);
+        coreInterfaces = coreIp.Assign(coreDevices);
+    }
+
+    auto routingStart = std::chrono::steady_clock::now();
+    if (routing == "star")
+    {
+        // Spokes default to their hub; hubs get one host route per UE below them
+        Ipv4Address spokeBase("10.1.0.0");
+        uint32_t span = interfaces.GetAddress(nodeTotal - 1).Get() - spokeBase.Get() + 1;
+        Ptr<StarRouting> core = StarRouting::Install(centralNode.Get(0), spokeBase, span);
+        std::vector<Ptr<StarRouting>> aggs;
+        for (uint32_t a = 0; a < aggTotal; a++)
+        {
+            aggs.push_back(StarRouting::Install(aggNodes.Get(a), spokeBase, span));
+            aggs[a]->SetDefaultRoute(aggUplinks.Get(a), coreInterfaces.GetAddress(a));
+        }
+        for (uint32_t i = 0; i < nodeTotal; i++)
+        {
+            StarRouting::Install(nodes.Get(i), spokeBase, 0)->SetDefaultRoute(devices.Get(i), hubInterfaces.GetAddress(i));
+            if (aggTotal > 0)
+            {
+                aggs[i / hubFanout]->AddHostRoute(interfaces.GetAddress(i), hubDevices.Get(i));
+                core->AddHostRoute(interfaces.GetAddress(i), coreDevices.Get(i / hubFanout));
+            }
+            else
+            {
+                core->AddHostRoute(interfaces.GetAddress(i), hubDevices.Get(i));
+            }
+        }
+    }
+    else if (routing == "global")
+    {
+        Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    }
+    NS_LOG_INFO("Routing (" << routing << ") installed in "
+                << std::chrono::duration<double>(std::chrono::steady_clock::now() - routingStart).count() << " s");
+
+    if (g_queueFeatures)
+    {
+        g_queues.Setup(nodeTotal);
+        for (uint32_t i = 0; i < nodeTotal; i++)
+        {
+            g_queues.Add(DynamicCast<PointToPointNetDevice>(hubDevices.Get(i)), interfaces.GetAddress(i));
+        }
+    }
 
     // Random server/client assignment
+    TRACE_LAP(phases, 1);
     std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937 gen(seed ? seed : rd());
     std::uniform_int_distribution<> dis(0, nodeTotal - 1);
 
     std::set<uint32_t> serverNodes;
@@ -284,6 +630,7 @@ int main(int argc, char *argv[])
         uint16_t serverPort = 1000 + serverIndex;
         serverPorts[serverIndex] = serverPort;
         g_isServer[serverIndex] = true;
+        if (!isLocal(serverIndex)) continue;
 
         if (useTcp)
         {
@@ -308,7 +655,11 @@ int main(int argc, char *argv[])
     if (enableAttack && nodeTotal >= 5)
     {
         benignLimit = nodeTotal - 5;
-        for (uint32_t i = nodeTotal - 5; i < nodeTotal; ++i) g_attackers.insert(i);
+        for (uint32_t i = nodeTotal - 5; i < nodeTotal; ++i)
+        {
+            g_attackers.insert(i);
+            g_attackerAddresses.insert(interfaces.GetAddress(i).Get());
+        }
     }
 
     for (uint32_t i = 0; i < benignLimit; ++i)
@@ -326,6 +677,7 @@ int main(int argc, char *argv[])
         uint32_t serverIndex = *it;
         uint16_t serverPort = serverPorts[serverIndex];
         Ipv4Address serverAddress = interfaces.GetAddress(serverIndex);
+        if (!isLocal(clientIndex)) continue; // after the draw, so every rank stays in step
 
         if (useTcp)
         {
@@ -359,8 +711,44 @@ int main(int argc, char *argv[])
             uint32_t serverIndex = *it;
             uint16_t serverPort = serverPorts[serverIndex];
             Ipv4Address serverAddress = interfaces.GetAddress(serverIndex);
+            if (!isLocal(clientIndex)) continue;
 
-            if (useTcp)
+            if (floodApp)
+            {
+                // Same offered load as the legacy apps, sent as bursts from a template packet
+                DataRate rate = useTcp ? DataRate("200Mbps")
+                                       : DataRate(static_cast<uint64_t>(1024 * 8 / attackInterval.GetSeconds()));
+                DdosFloodHelper flood(useTcp ? "ns3::TcpSocketFactory" : "ns3::UdpSocketFactory",
+                                      InetSocketAddress(serverAddress, serverPort));
+                flood.SetAttribute("RampTime", TimeValue(attackRampTime));
+                flood.SetAttribute("PulsePeriod", TimeValue(attackPulsePeriod));
+                flood.SetAttribute("PulseDuty",
+                                  DoubleValue(std::min(1.0, attackPulseWidth.GetSeconds() / attackPulsePeriod.GetSeconds())));
+                flood.SetAttribute("OnTime", TimeValue(attackOnTime));
+                flood.SetAttribute("OffTime", TimeValue(attackOffTime));
+                if (attackProfile == "lowslow")
+                {
+                    // Small packets trickled one at a time with jittered gaps
+                    flood.SetAttribute("DataRate", DataRateValue(lowSlowRate));
+                    flood.SetAttribute("PacketSize", UintegerValue(lowSlowSize));
+                    flood.SetAttribute("BurstSize", UintegerValue(1));
+                    flood.SetAttribute("GapJitter", DoubleValue(0.5));
+                    flood.SetAttribute("Profile", StringValue("constant"));
+                }
+                else
+                {
+                    flood.SetAttribute("DataRate", DataRateValue(rate));
+                    flood.SetAttribute("PacketSize", UintegerValue(1024));
+                    flood.SetAttribute("BurstSize", UintegerValue(attackBurst));
+                    flood.SetAttribute("Profile", StringValue(attackProfile));
+                }
+                flood.SetAttribute("SpoofSources", UintegerValue(useTcp ? 0 : g_spoofSources));
+                flood.SetAttribute("SpoofBase", Ipv4AddressValue(g_spoofBase));
+                auto app = flood.Install(nodes.Get(clientIndex));
+                app.Start(appStart);
+                app.Stop(simTime);
+            }
+            else if (useTcp)
             {
                 OnOffHelper onoff("ns3::TcpSocketFactory", InetSocketAddress(serverAddress, serverPort));
                 onoff.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1]"));
@@ -385,26 +773,156 @@ int main(int argc, char *argv[])
     }
 
     // FlowMonitor setup
+    TRACE_LAP(phases, 2);
     FlowMonitorHelper flowmonHelper;
     NodeContainer monitorNodes;
-    monitorNodes.Add(nodes);
-    g_monitor = flowmonHelper.Install(monitorNodes);
-    g_monitor->SetAttribute("DelayBinWidth", DoubleValue(0.001));
-    g_monitor->SetAttribute("JitterBinWidth", DoubleValue(0.001));
-    g_monitor->SetAttribute("PacketSizeBinWidth", DoubleValue(20));
-    g_classifier = DynamicCast<Ipv4FlowClassifier>(flowmonHelper.GetClassifier());
+    for (uint32_t i = 0; i < nodeTotal; i++)
+    {
+        if (isLocal(i)) monitorNodes.Add(nodes.Get(i));
+    }
+    if (g_useTracker)
+    {
+        g_tracker.Setup(trackerMaxFlows, trackerIdle);
+        g_tracker.Install(monitorNodes);
+    }
+    else
+    {
+        g_monitor = flowmonHelper.Install(monitorNodes);
+        g_monitor->SetAttribute("DelayBinWidth", DoubleValue(0.001));
+        g_monitor->SetAttribute("JitterBinWidth", DoubleValue(0.001));
+        g_monitor->SetAttribute("PacketSizeBinWidth", DoubleValue(20));
+        g_classifier = DynamicCast<Ipv4FlowClassifier>(flowmonHelper.GetClassifier());
+        g_sampler.Setup(g_monitor, g_classifier);
+    }
 
     // Schedule periodic sampling
     g_windowStart = 0.0;
+    g_windowIndex = 0;
     g_scenarioId = scenarioTag;
     Simulator::Schedule(Seconds(g_windowSize), &SampleAndWrite);
+    if (tensors)
+    {
+        g_tensors.Enable(g_scenarioId, g_windowSize);
+    }
+    if (output != "csv")
+    {
+        const std::map<std::string, std::string> consts = {{"scenario_id", g_scenarioId},
+                                                           {"ue_total", std::to_string(g_ueTotal)},
+                                                           {"attackers", std::to_string(g_attackers.size())}};
+        NS_ABORT_MSG_IF(!g_stream.Open(streamPath, WindowStreamColumns(CsvColumns(), consts), streamCodec),
+                        "Could not write " << streamPath);
+    }
+
+    if (!sinkSocket.empty())
+    {
+        NS_ABORT_MSG_IF(!g_sink.Open(sinkSocket, sinkBackpressure, sinkBuffer),
+                        "Could not connect to " << sinkSocket << " (backpressure " << sinkBackpressure << ")");
+        g_sink.Hello(g_scenarioId, nodeTotal, g_attackers.size(), g_windowSize);
+        if (enableAttack)
+        {
+            // Reference point for detection latency: the first attack verdict is measured from here
+            Simulator::Schedule(appStart, &WindowSocketSink::MarkAttackStart, &g_sink);
+        }
+    }
 
     Simulator::Stop(simTime);
+    TRACE_CHECKPOINTS(MilliSeconds(100));
+    TRACE_LAP(phases, 3);
+    g_manifest.MarkRunStart();
     Simulator::Run();
+    g_manifest.MarkRunEnd();
+    TRACE_LAP(phases, 4);
+    NS_LOG_INFO("Executed events: " << Simulator::GetEventCount() << " ("
+                << Simulator::GetEventCount() / simTime.GetSeconds() << " per simulated second)");
 
-    g_out.flush();
-    g_out.close();
+    if (g_balancer.IsEnabled())
+    {
+        TRACE_SCOPE("balance");
+        uint64_t held = 0;
+        g_balancer.Drain([&held](const HeldRow &h, double weight) {
+            EmitRow(h.row, h.timeStart, h.timeEnd, h.attack, h.queue, weight);
+            held++;
+        });
+        g_manifest.AddRows(held);
+        const auto &a = g_balancer.GetStats(true);
+        const auto &b = g_balancer.GetStats(false);
+        std::cout << "ClassBalance: mode=" << balance << " attack=" << a.kept << "/" << a.seen << " benign=" << b.kept
+                  << "/" << b.seen << " heldMB=" << g_balancer.GetMemoryBytes() / 1e6 << std::endl;
+        g_manifest.SetExtra("balance_attack_seen", a.seen);
+        g_manifest.SetExtra("balance_attack_kept", a.kept);
+        g_manifest.SetExtra("balance_benign_seen", b.seen);
+        g_manifest.SetExtra("balance_benign_kept", b.kept);
+    }
+
+    uint64_t bytesWritten = 0;
+    if (g_writeCsv)
+    {
+        g_out.flush();
+        bytesWritten = static_cast<uint64_t>(g_out.tellp());
+        g_out.close();
+    }
+    if (g_stream.IsOpen())
+    {
+        TRACE_SCOPE("stream");
+        if (!g_stream.Close()) std::cerr << "Could not write " << streamPath << std::endl;
+        std::cout << "WindowStream: codec=" << g_stream.GetCodecName() << " rows=" << g_stream.GetRows()
+                  << " blocks=" << g_stream.GetBlocks() << " MB=" << g_stream.GetBytes() / 1e6
+                  << " rawMB=" << g_stream.GetRawBytes() / 1e6 << " file=" << streamPath << std::endl;
+        g_manifest.SetExtra("dws_bytes", g_stream.GetBytes());
+        bytesWritten += g_stream.GetBytes();
+    }
+    g_manifest.SetBytesWritten(bytesWritten);
+
+    if (!sinkSocket.empty())
+    {
+        g_sink.Close(Simulator::Now().GetSeconds());
+        const WindowSocketSink::Stats &ss = g_sink.GetStats();
+        std::cout << "SocketSink: windows=" << ss.windows << " dropped=" << ss.droppedWindows
+                  << " sampled=" << ss.sampledWindows << " sampledOutRows=" << ss.sampledOutRows
+                  << " MB=" << ss.bytes / 1e6 << " blockedMs=" << ss.blockedNs / 1e6 << std::endl;
+        g_manifest.SetExtra("sink_windows_sent", ss.windows - ss.droppedWindows);
+        g_manifest.SetExtra("sink_windows_dropped", ss.droppedWindows);
+        g_manifest.SetExtra("sink_rows_sampled_out", ss.sampledOutRows);
+        g_manifest.SetExtra("sink_blocked_ms", ss.blockedNs / 1e6);
+    }
+
+    if (tensors)
+    {
+        TRACE_SCOPE("tensors");
+        std::string tensorPath = fileName.substr(0, fileName.size() - 4) + ".ftns";
+        if (!g_tensors.Write(tensorPath)) std::cerr << "Could not write " << tensorPath << std::endl;
+        std::cout << "FlowTensors: flows=" << g_tensors.GetFlows() << " rows=" << g_tensors.GetRows()
+                  << " MB=" << g_tensors.GetFileBytes() / 1e6 << " file=" << tensorPath << std::endl;
+        g_manifest.SetExtra("tensor_flows", g_tensors.GetFlows());
+        g_manifest.SetExtra("tensor_rows", g_tensors.GetRows());
+    }
+
+    if (g_useTracker)
+    {
+        const BoundedFlowTracker::Stats &ts = g_tracker.GetStats();
+        std::cout << "FlowTracker: spoofSources=" << g_spoofSources << " peakFlows=" << ts.peakFlows
+                  << " inserted=" << ts.inserted << " evicted=" << ts.evicted
+                  << " overflowPackets=" << ts.overflowPackets << " aggregateRows=" << ts.aggregateRows
+                  << " memoryBytes=" << g_tracker.GetMemoryBytes()
+                  << " avgWindowUs=" << (ts.windows ? ts.totalWindowNs / ts.windows / 1000.0 : 0.0)
+                  << " maxWindowUs=" << ts.maxWindowNs / 1000.0 << std::endl;
+        g_manifest.SetExtra("tracker_peak_flows", ts.peakFlows);
+        g_manifest.SetExtra("tracker_evicted", ts.evicted);
+    }
 
     Simulator::Destroy();
+    TRACE_LAPS_END(phases);
+    TRACE_EXPORT(fileName.substr(0, fileName.size() - 4) + ".trace.json");
+    if (writeManifest)
+    {
+        std::string manifestPath = RunManifest::SidecarPath(fileName);
+        if (!g_manifest.Write(manifestPath)) std::cerr << "Could not write " << manifestPath << std::endl;
+    }
+#ifdef NS3_MPI
+    if (distributed)
+    {
+        MpiInterface::Disable();
+    }
+#endif
     return 0;
 }
@@ -0,0 +1,159 @@
+// star_routing.h - Topology-aware static routing for star and tiered hub-and-spoke layouts
+// Global routing runs an all-pairs SPF over every node, which is what makes thousands of
+// spokes slow to set up. A star needs none of that: spokes send everything to their hub,
+// and a hub only needs to know which interface leads to each spoke address. StarRouting
+// keeps that as a flat vector indexed by (dst - spoke base), so building the tables is
+// O(N) and every forwarding decision is a single array load. Aggregation hubs in a tiered
+// layout hold host routes for their own spokes plus a default route toward the core.
+
+#ifndef STAR_ROUTING_H
+#define STAR_ROUTING_H
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+class StarRouting : public Ipv4RoutingProtocol
+{
+  public:
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::StarRouting")
+                                .SetParent<Ipv4RoutingProtocol>()
+                                .SetGroupName("Internet")
+                                .AddConstructor<StarRouting>();
+        return tid;
+    }
+
+    // Replace the routing protocol the internet stack installed on node; call after addresses
+    // are assigned. Host routes cover spoke addresses in [spokeBase, spokeBase + span).
+    static Ptr<StarRouting> Install(Ptr<Node> node, Ipv4Address spokeBase, uint32_t span)
+    {
+        Ptr<StarRouting> routing = CreateObject<StarRouting>();
+        routing->m_base = spokeBase.Get();
+        routing->m_hostIface.assign(span, 0);
+        node->GetObject<Ipv4>()->SetRoutingProtocol(routing);
+        return routing;
+    }
+
+    // Send everything without a host route out of dev, toward gateway
+    void SetDefaultRoute(Ptr<NetDevice> dev, Ipv4Address gateway)
+    {
+        m_default = MakeRoute(dev, gateway);
+    }
+
+    // Reach spoke address dst through dev (directly attached or via a lower-tier hub)
+    void AddHostRoute(Ipv4Address dst, Ptr<NetDevice> dev)
+    {
+        uint32_t index = dst.Get() - m_base;
+        NS_ABORT_MSG_IF(index >= m_hostIface.size(), "StarRouting: " << dst << " outside the spoke range");
+        uint32_t iface = static_cast<uint32_t>(m_ipv4->GetInterfaceForDevice(dev));
+        if (iface >= m_ifaceRoutes.size()) m_ifaceRoutes.resize(iface + 1);
+        if (!m_ifaceRoutes[iface]) m_ifaceRoutes[iface] = MakeRoute(dev, Ipv4Address::GetZero());
+        m_hostIface[index] = iface;
+    }
+
+    Ptr<Ipv4Route> RouteOutput(Ptr<Packet>, const Ipv4Header &header, Ptr<NetDevice>,
+                               Socket::SocketErrno &sockerr) override
+    {
+        Ptr<Ipv4Route> route = Lookup(header.GetDestination());
+        sockerr = route ? Socket::ERROR_NOTERROR : Socket::ERROR_NOROUTETOHOST;
+        return route;
+    }
+
+    bool RouteInput(Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
+                    const UnicastForwardCallback &ucb, const MulticastForwardCallback &,
+                    const LocalDeliverCallback &lcb, const ErrorCallback &ecb) override
+    {
+        Ipv4Address dst = header.GetDestination();
+        uint32_t iif = static_cast<uint32_t>(m_ipv4->GetInterfaceForDevice(idev));
+
+        // Spoke addresses never belong to a hub, so try the table before the per-interface
+        // local address scan, which is O(interfaces) on a hub
+        uint32_t index = dst.Get() - m_base;
+        if (index < m_hostIface.size() && m_hostIface[index] != 0)
+        {
+            ucb(m_ifaceRoutes[m_hostIface[index]], p, header);
+            return true;
+        }
+        if (m_ipv4->IsDestinationAddress(dst, iif))
+        {
+            lcb(p, header, iif);
+            return true;
+        }
+        if (dst.IsMulticast() || dst.IsBroadcast()) return false;
+        if (m_default && m_ipv4->IsForwarding(iif))
+        {
+            ucb(m_default, p, header);
+            return true;
+        }
+        ecb(p, header, Socket::ERROR_NOROUTETOHOST);
+        return true;
+    }
+
+    void NotifyInterfaceUp(uint32_t) override {}
+    void NotifyInterfaceDown(uint32_t) override {}
+    void NotifyAddAddress(uint32_t, Ipv4InterfaceAddress) override {}
+    void NotifyRemoveAddress(uint32_t, Ipv4InterfaceAddress) override {}
+
+    void SetIpv4(Ptr<Ipv4> ipv4) override { m_ipv4 = ipv4; }
+
+    void PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Unit = Time::S) const override
+    {
+        std::ostream *os = stream->GetStream();
+        uint32_t hosts = 0;
+        for (uint32_t iface : m_hostIface)
+        {
+            if (iface != 0) hosts++;
+        }
+        *os << "StarRouting: " << hosts << " host routes over " << m_hostIface.size() << " addresses from "
+            << Ipv4Address(m_base);
+        if (m_default) *os << ", default via " << m_default->GetGateway();
+        *os << std::endl;
+    }
+
+  protected:
+    void DoDispose() override
+    {
+        m_ipv4 = nullptr;
+        m_default = nullptr;
+        m_ifaceRoutes.clear();
+        Ipv4RoutingProtocol::DoDispose();
+    }
+
+  private:
+    // Routes are only read by Ipv4L3Protocol, so one per interface is shared by all packets
+    Ptr<Ipv4Route> MakeRoute(Ptr<NetDevice> dev, Ipv4Address gateway) const
+    {
+        uint32_t iface = static_cast<uint32_t>(m_ipv4->GetInterfaceForDevice(dev));
+        Ptr<Ipv4Route> route = Create<Ipv4Route>();
+        route->SetSource(m_ipv4->GetAddress(iface, 0).GetLocal());
+        route->SetGateway(gateway);
+        route->SetOutputDevice(dev);
+        return route;
+    }
+
+    Ptr<Ipv4Route> Lookup(Ipv4Address dst) const
+    {
+        uint32_t index = dst.Get() - m_base;
+        if (index < m_hostIface.size() && m_hostIface[index] != 0) return m_ifaceRoutes[m_hostIface[index]];
+        return m_default;
+    }
+
+    Ptr<Ipv4> m_ipv4;
+    uint32_t m_base = 0;
+    std::vector<uint32_t> m_hostIface;          // (dst - m_base) -> interface, 0 = none (0 is loopback)
+    std::vector<Ptr<Ipv4Route>> m_ifaceRoutes;  // interface -> shared route
+    Ptr<Ipv4Route> m_default;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(StarRouting);
+
+} // namespace ns3
+
+#endif // STAR_ROUTING_H
@@ -0,0 +1,134 @@
+// bench_shim/ns3/core-module.h - Minimal stand-ins for the ns-3 types the samplers use
+// Lets tools/sampler_bench.cc compile flow_window_sampler.h unmodified with a plain C++
+// compiler. Only what the sampler touches is here, with the same semantics as ns-3:
+// Ipv4Address ordering and printing, FlowMonitor::FlowStatsContainer as a std::map keyed
+// by FlowId, and Ipv4FlowClassifier::FindFlow. Ptr is non-owning; the benchmark owns the
+// objects. The flow-monitor and internet module headers include this one.
+
+#ifndef BENCH_SHIM_CORE_MODULE_H
+#define BENCH_SHIM_CORE_MODULE_H
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <vector>
+
+namespace ns3
+{
+
+template <typename T>
+class Ptr
+{
+  public:
+    Ptr() = default;
+    Ptr(T *p)
+        : m_p(p)
+    {
+    }
+
+    T *operator->() const { return m_p; }
+    T &operator*() const { return *m_p; }
+    explicit operator bool() const { return m_p != nullptr; }
+
+  private:
+    T *m_p = nullptr;
+};
+
+class Time
+{
+  public:
+    Time() = default;
+    explicit Time(double seconds)
+        : m_s(seconds)
+    {
+    }
+
+    double GetSeconds() const { return m_s; }
+    Time &operator+=(const Time &o)
+    {
+        m_s += o.m_s;
+        return *this;
+    }
+
+  private:
+    double m_s = 0.0;
+};
+
+class Ipv4Address
+{
+  public:
+    Ipv4Address() = default;
+    explicit Ipv4Address(uint32_t address)
+        : m_address(address)
+    {
+    }
+
+    uint32_t Get() const { return m_address; }
+    bool operator==(const Ipv4Address &o) const { return m_address == o.m_address; }
+    bool operator!=(const Ipv4Address &o) const { return m_address != o.m_address; }
+    bool operator<(const Ipv4Address &o) const { return m_address < o.m_address; }
+
+  private:
+    uint32_t m_address = 0;
+};
+
+inline std::ostream &operator<<(std::ostream &os, const Ipv4Address &a)
+{
+    uint32_t v = a.Get();
+    return os << ((v >> 24) & 0xff) << "." << ((v >> 16) & 0xff) << "." << ((v >> 8) & 0xff) << "." << (v & 0xff);
+}
+
+typedef uint32_t FlowId;
+
+class FlowMonitor
+{
+  public:
+    struct FlowStats
+    {
+        Time delaySum;
+        Time jitterSum;
+        uint64_t txBytes = 0;
+        uint64_t rxBytes = 0;
+        uint32_t txPackets = 0;
+        uint32_t rxPackets = 0;
+        uint32_t lostPackets = 0;
+    };
+
+    typedef std::map<FlowId, FlowStats> FlowStatsContainer;
+
+    void CheckForLostPackets() {}
+    const FlowStatsContainer &GetFlowStats() const { return m_stats; }
+    FlowStatsContainer &GetMutableFlowStats() { return m_stats; }
+
+  private:
+    FlowStatsContainer m_stats;
+};
+
+class Ipv4FlowClassifier
+{
+  public:
+    struct FiveTuple
+    {
+        Ipv4Address sourceAddress;
+        Ipv4Address destinationAddress;
+        uint8_t protocol;
+        uint16_t sourcePort;
+        uint16_t destinationPort;
+    };
+
+    // FlowIds start at 1, as in ns-3
+    FlowId Add(const FiveTuple &t)
+    {
+        m_tuples.push_back(t);
+        return static_cast<FlowId>(m_tuples.size());
+    }
+
+    FiveTuple FindFlow(FlowId id) const { return m_tuples[id - 1]; }
+
+  private:
+    std::vector<FiveTuple> m_tuples;
+};
+
+} // namespace ns3
+
+#endif // BENCH_SHIM_CORE_MODULE_H
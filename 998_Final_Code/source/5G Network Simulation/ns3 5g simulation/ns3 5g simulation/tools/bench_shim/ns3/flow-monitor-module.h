@@ -0,0 +1,2 @@
+// bench_shim/ns3/flow-monitor-module.h - see core-module.h
+#include "core-module.h"
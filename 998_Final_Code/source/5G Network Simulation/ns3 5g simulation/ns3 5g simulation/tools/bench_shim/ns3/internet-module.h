@@ -0,0 +1,2 @@
+// bench_shim/ns3/internet-module.h - see core-module.h
+#include "core-module.h"
@@ -0,0 +1,634 @@
+// column_stats.cc - Per-feature statistics and scaler_params.json from the dataset CSVs
+// Replaces the pandas pass that fits StandardScaler before training. Every CSV is memory-mapped
+// and tokenized 64 bytes at a time (SSE2 compare + bitmask of ',' and '\n' positions). The 28
+// model features are built per row as in the training notebook. Statistics are accumulated
+// in blocks of rows: a block's mean, M2, min and max come from straight loops over
+// one feature's values, and blocks, threads and partitions are combined with Chan's parallel
+// Welford update.
+//
+// src_ip_freq / dst_ip_freq are dataset-wide address counts, so they are not known until every
+// file has been read. Their statistics come from the count tables instead: a row's value is
+// count(ip), so the sum over rows is sum(count^2) and the sum of squares is sum(count^3).
+//
+// Output is scaler_params.json in the shape service/scorer_ml.py reads (mean_, scale_,
+// n_features_in_), plus var_, min_, max_, the class balance and the same figures per
+// partition (ue_total x mobility x transport x attack x intensity). As with StandardScaler,
+// scale_ is the population standard deviation, or 1 for a constant feature. Pass
+// --files=splits/train.txt (tools/dataset_split) to fit on the training runs only.
+//
+// Build: g++ -O2 -std=c++17 -pthread -o column_stats tools/column_stats.cc
+// Usage: ./column_stats --data=datasets --features=../../../5G_IDS_ML_Cap/models/features.txt --out=scaler_params.json
+
+#include "dataset_shard.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct Options
+{
+    std::string data = "datasets";
+    std::string files; // list of CSV paths, one per line (tools/dataset_split train.txt); overrides --data
+    std::string features; // one name per line; empty = the 28 features of service/api.py
+    std::string out = "scaler_params.json";
+    uint32_t threads = std::max(1u, std::thread::hardware_concurrency());
+    bool partitions = true;
+};
+
+// Feature order of service/api.py's Flow model and of models/features.txt
+static const char *kDefaultFeatures[] = {
+    "time_start", "time_end", "ue_total", "src_port", "dst_port", "protocol", "packet_size", "flow_duration",
+    "total_bytes_fwd", "total_bytes_bwd", "total_pkts_fwd", "total_pkts_bwd", "pkts_per_sec", "bytes_per_sec",
+    "flow_pkts_per_sec", "flow_bytes_per_sec", "jitter_ms", "delay_ms", "src_ip_numeric", "src_ip_freq",
+    "dst_ip_numeric", "dst_ip_freq", "fwd_bwd_packets_ratio", "fwd_bwd_bytes_ratio", "avg_packet_size",
+    "flow_duration_log", "is_common_port", "port_range"};
+
+// CSV columns the features are built from
+enum Raw
+{
+    kTimeStart,
+    kTimeEnd,
+    kUeTotal,
+    kSrcIp,
+    kDstIp,
+    kSrcPort,
+    kDstPort,
+    kProtocol,
+    kPacketSize,
+    kFlowDuration,
+    kBytesFwd,
+    kBytesBwd,
+    kPktsFwd,
+    kPktsBwd,
+    kPktsPerSec,
+    kBytesPerSec,
+    kFlowPktsPerSec,
+    kFlowBytesPerSec,
+    kJitterMs,
+    kDelayMs,
+    kLabelBinary,
+    kRawCount
+};
+
+static const char *kRawNames[kRawCount] = {
+    "time_start", "time_end", "ue_total", "src_ip", "dst_ip", "src_port", "dst_port",
+    "protocol", "packet_size", "flow_duration", "total_bytes_fwd", "total_bytes_bwd", "total_pkts_fwd",
+    "total_pkts_bwd", "pkts_per_sec", "bytes_per_sec", "flow_pkts_per_sec", "flow_bytes_per_sec",
+    "jitter_ms", "delay_ms", "label_binary"};
+
+static const size_t kBlockRows = 2048;
+
+static bool ParseArg(const char *arg, const char *name, std::string &value)
+{
+    size_t n = std::strlen(name);
+    if (std::strncmp(arg, "--", 2) != 0 || std::strncmp(arg + 2, name, n) != 0 || arg[2 + n] != '=') return false;
+    value = arg + 3 + n;
+    return true;
+}
+
+static Options ParseOptions(int argc, char *argv[])
+{
+    Options o;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string v;
+        if (ParseArg(argv[i], "data", v)) o.data = v;
+        else if (ParseArg(argv[i], "files", v)) o.files = v;
+        else if (ParseArg(argv[i], "features", v)) o.features = v;
+        else if (ParseArg(argv[i], "out", v)) o.out = v;
+        else if (ParseArg(argv[i], "threads", v)) o.threads = std::max(1ul, std::stoul(v));
+        else if (ParseArg(argv[i], "partitions", v)) o.partitions = v == "1" || v == "true";
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << "\n"
+                      << "Options: --data --files --features --out --threads --partitions\n";
+            std::exit(1);
+        }
+    }
+    return o;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Tokenizer and number parsing
+
+// Calls onDelim(position) for every ',' and '\n' in [p, end), in order
+template <typename F>
+static void ScanDelimiters(const char *p, const char *end, F &&onDelim)
+{
+    const char *base = p;
+#ifdef __SSE2__
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; end - base >= 64; base += 64)
+    {
+        uint64_t mask = 0;
+        for (int k = 0; k < 4; ++k)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(base + 16 * k));
+            __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, newline));
+            mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(hit))) << (16 * k);
+        }
+        while (mask)
+        {
+            onDelim(base + __builtin_ctzll(mask));
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; base < end; ++base)
+    {
+        if (*base == ',' || *base == '\n') onDelim(base);
+    }
+}
+
+// Decimal and exponent notation as written by std::ostream; anything else goes to strtod.
+// Exact for up to 15 significant digits, which covers the generators' 6-digit output.
+static double ParseNumber(const char *p, const char *end)
+{
+    static const double pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const char *s = p;
+    bool neg = p < end && *p == '-';
+    if (neg) ++p;
+    uint64_t mant = 0;
+    int digits = 0;
+    int exp10 = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p, ++digits) mant = mant * 10 + (*p - '0');
+    if (p < end && *p == '.')
+    {
+        for (++p; p < end && *p >= '0' && *p <= '9'; ++p, ++digits, --exp10) mant = mant * 10 + (*p - '0');
+    }
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        ++p;
+        bool eneg = p < end && *p == '-';
+        if (p < end && (*p == '-' || *p == '+')) ++p;
+        int e = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; ++p) e = e * 10 + (*p - '0');
+        exp10 += eneg ? -e : e;
+    }
+    if (p != end || digits == 0 || digits > 15 || exp10 < -22 || exp10 > 22)
+    {
+        char buf[64];
+        size_t n = std::min<size_t>(end - s, sizeof(buf) - 1);
+        std::memcpy(buf, s, n);
+        buf[n] = '\0';
+        double v = std::strtod(buf, nullptr);
+        return std::isfinite(v) ? v : 0.0; // the notebook replaces inf and NaN with 0
+    }
+    double v = exp10 < 0 ? mant / pow10[-exp10] : mant * pow10[exp10];
+    return neg ? -v : v;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Statistics
+
+struct Moments
+{
+    double n = 0;
+    double mean = 0;
+    double m2 = 0;
+    double min = INFINITY;
+    double max = -INFINITY;
+
+    // Chan et al. pairwise combination
+    void Merge(const Moments &b)
+    {
+        if (b.n == 0) return;
+        if (n == 0)
+        {
+            *this = b;
+            return;
+        }
+        double total = n + b.n;
+        double delta = b.mean - mean;
+        mean += delta * b.n / total;
+        m2 += b.m2 + delta * delta * n * b.n / total;
+        n = total;
+        min = std::min(min, b.min);
+        max = std::max(max, b.max);
+    }
+};
+
+// Moments of one block of values: two straight passes with four independent accumulators,
+// so the compiler can keep them in vector registers
+static Moments BlockMoments(const double *x, size_t n)
+{
+    Moments m;
+    if (n == 0) return m;
+    double s[4] = {0, 0, 0, 0};
+    double lo[4] = {INFINITY, INFINITY, INFINITY, INFINITY};
+    double hi[4] = {-INFINITY, -INFINITY, -INFINITY, -INFINITY};
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        for (int k = 0; k < 4; ++k)
+        {
+            s[k] += x[i + k];
+            lo[k] = std::min(lo[k], x[i + k]);
+            hi[k] = std::max(hi[k], x[i + k]);
+        }
+    }
+    for (; i < n; ++i)
+    {
+        s[0] += x[i];
+        lo[0] = std::min(lo[0], x[i]);
+        hi[0] = std::max(hi[0], x[i]);
+    }
+    double mean = (s[0] + s[1] + s[2] + s[3]) / n;
+    double d[4] = {0, 0, 0, 0};
+    for (i = 0; i + 4 <= n; i += 4)
+    {
+        for (int k = 0; k < 4; ++k) d[k] += (x[i + k] - mean) * (x[i + k] - mean);
+    }
+    for (; i < n; ++i) d[0] += (x[i] - mean) * (x[i] - mean);
+    m.n = static_cast<double>(n);
+    m.mean = mean;
+    m.m2 = d[0] + d[1] + d[2] + d[3];
+    m.min = std::min(std::min(lo[0], lo[1]), std::min(lo[2], lo[3]));
+    m.max = std::max(std::max(hi[0], hi[1]), std::max(hi[2], hi[3]));
+    return m;
+}
+
+using IpCounts = std::unordered_map<uint32_t, uint64_t>;
+
+struct PartitionStats
+{
+    std::vector<Moments> features;
+    uint64_t rows = 0;
+    uint64_t attackRows = 0;
+    IpCounts src; // rows per address in this partition, for the *_ip_freq features
+    IpCounts dst;
+
+    void Merge(const PartitionStats &b)
+    {
+        if (features.empty()) features.resize(b.features.size());
+        for (size_t f = 0; f < features.size(); ++f) features[f].Merge(b.features[f]);
+        rows += b.rows;
+        attackRows += b.attackRows;
+        for (const auto &e : b.src) src[e.first] += e.second;
+        for (const auto &e : b.dst) dst[e.first] += e.second;
+    }
+};
+
+// Maps a feature name to a function of the raw columns; *_ip_freq are filled in afterwards
+struct FeatureSet
+{
+    std::vector<std::string> names;
+    std::vector<int> ids; // index into kDefaultFeatures
+    int srcFreq = -1;
+    int dstFreq = -1;
+
+    bool Load(const std::string &path)
+    {
+        if (path.empty())
+        {
+            names.assign(std::begin(kDefaultFeatures), std::end(kDefaultFeatures));
+        }
+        else
+        {
+            std::ifstream in(path);
+            if (!in) return false;
+            std::string line;
+            while (std::getline(in, line))
+            {
+                line.erase(line.find_last_not_of(" \t\r") + 1);
+                line.erase(0, line.find_first_not_of(" \t"));
+                if (!line.empty()) names.push_back(line);
+            }
+        }
+        for (size_t f = 0; f < names.size(); ++f)
+        {
+            auto it = std::find_if(std::begin(kDefaultFeatures), std::end(kDefaultFeatures),
+                                   [&](const char *n) { return names[f] == n; });
+            if (it == std::end(kDefaultFeatures))
+            {
+                std::cerr << "Unknown feature " << names[f] << "\n";
+                return false;
+            }
+            ids.push_back(static_cast<int>(it - std::begin(kDefaultFeatures)));
+            if (names[f] == "src_ip_freq") srcFreq = static_cast<int>(f);
+            if (names[f] == "dst_ip_freq") dstFreq = static_cast<int>(f);
+        }
+        return !names.empty();
+    }
+};
+
+// The 28 features of one row, in kDefaultFeatures order (the two *_ip_freq left at 0)
+static void BuildRow(const double *r, double *out)
+{
+    static const double commonPorts[] = {80, 443, 22, 21, 25, 53, 110, 143};
+    out[0] = r[kTimeStart];
+    out[1] = r[kTimeEnd];
+    out[2] = r[kUeTotal];
+    out[3] = r[kSrcPort];
+    out[4] = r[kDstPort];
+    out[5] = r[kProtocol];
+    out[6] = r[kPacketSize];
+    out[7] = r[kFlowDuration];
+    out[8] = r[kBytesFwd];
+    out[9] = r[kBytesBwd];
+    out[10] = r[kPktsFwd];
+    out[11] = r[kPktsBwd];
+    out[12] = r[kPktsPerSec];
+    out[13] = r[kBytesPerSec];
+    out[14] = r[kFlowPktsPerSec];
+    out[15] = r[kFlowBytesPerSec];
+    out[16] = r[kJitterMs];
+    out[17] = r[kDelayMs];
+    out[18] = r[kSrcIp];
+    out[19] = 0.0;
+    out[20] = r[kDstIp];
+    out[21] = 0.0;
+    out[22] = r[kPktsFwd] / (r[kPktsBwd] + 1);
+    out[23] = r[kBytesFwd] / (r[kBytesBwd] + 1);
+    out[24] = (r[kBytesFwd] + r[kBytesBwd]) / (r[kPktsFwd] + r[kPktsBwd] + 1);
+    out[25] = std::log1p(r[kFlowDuration]);
+    out[26] = std::find(std::begin(commonPorts), std::end(commonPorts), r[kDstPort]) != std::end(commonPorts);
+    // pd.cut(src_port, [0, 1024, 49152, 65535]) with NaN (port 0) filled as 0
+    out[27] = r[kSrcPort] > 49152 ? 2 : r[kSrcPort] > 1024 ? 1 : 0;
+}
+
+// Scans one CSV into 'part'. Returns false if the header lacks a needed column.
+static bool ScanFile(const std::string &path, const FeatureSet &fs, PartitionStats &part, uint64_t &bytes)
+{
+    MappedFile f;
+    if (!f.Open(path)) return false;
+    bytes = f.Size();
+    const char *p = f.Data();
+    const char *end = p + f.Size();
+    const char *eol = std::find(p, end, '\n');
+    std::string headerLine(p, eol);
+    if (!headerLine.empty() && headerLine.back() == '\r') headerLine.pop_back();
+    std::vector<std::string> header = SplitString(headerLine, ',');
+
+    // CSV column -> raw slot (-1 = unused)
+    std::vector<int> slot(header.size(), -1);
+    for (int r = 0; r < kRawCount; ++r)
+    {
+        auto it = std::find(header.begin(), header.end(), kRawNames[r]);
+        if (it == header.end()) return false;
+        slot[it - header.begin()] = r;
+    }
+
+    size_t nf = fs.names.size();
+    std::vector<double> block(nf * kBlockRows); // column-major: feature f at f * kBlockRows
+    size_t inBlock = 0;
+    double raw[kRawCount];
+    double row[std::size(kDefaultFeatures)];
+    auto flush = [&]() {
+        for (size_t k = 0; k < nf; ++k) part.features[k].Merge(BlockMoments(&block[k * kBlockRows], inBlock));
+        inBlock = 0;
+    };
+
+    size_t col = 0;
+    bool lineOk = true;
+    const char *field = eol < end ? eol + 1 : end;
+    auto onField = [&](const char *d, bool lineEnd) {
+        const char *fe = d > field && d[-1] == '\r' ? d - 1 : d;
+        if (col < slot.size() && slot[col] >= 0)
+        {
+            int r = slot[col];
+            if (r == kSrcIp || r == kDstIp)
+            {
+                uint32_t ip = 0;
+                lineOk &= ParseIpv4(field, fe, ip);
+                raw[r] = ip;
+            }
+            else
+            {
+                raw[r] = ParseNumber(field, fe);
+            }
+        }
+        col++;
+        field = d + 1;
+        if (!lineEnd) return;
+
+        if (lineOk && col == header.size())
+        {
+            BuildRow(raw, row);
+            for (size_t k = 0; k < nf; ++k) block[k * kBlockRows + inBlock] = row[fs.ids[k]];
+            if (++inBlock == kBlockRows) flush();
+            part.rows++;
+            part.attackRows += raw[kLabelBinary] != 0.0;
+            part.src[static_cast<uint32_t>(raw[kSrcIp])]++;
+            part.dst[static_cast<uint32_t>(raw[kDstIp])]++;
+        }
+        col = 0;
+        lineOk = true;
+    };
+    if (eol < end) ScanDelimiters(eol + 1, end, [&](const char *d) { onField(d, *d == '\n'); });
+    if (field < end) onField(end, true); // last line without a newline
+    flush();
+    return true;
+}
+
+// Moments of count(ip) over the rows of 'part', where counts are dataset-wide
+static Moments FreqMoments(const IpCounts &rowsPerIp, const IpCounts &global)
+{
+    Moments m;
+    long double s1 = 0;
+    long double s2 = 0;
+    for (const auto &e : rowsPerIp)
+    {
+        double c = static_cast<double>(global.at(e.first));
+        m.n += e.second;
+        s1 += static_cast<long double>(e.second) * c;
+        s2 += static_cast<long double>(e.second) * c * c;
+        m.min = std::min(m.min, c);
+        m.max = std::max(m.max, c);
+    }
+    if (m.n == 0) return m;
+    m.mean = static_cast<double>(s1 / m.n);
+    m.m2 = static_cast<double>(std::max<long double>(0, s2 - s1 * s1 / m.n));
+    return m;
+}
+
+static void FinishFreq(PartitionStats &p, const FeatureSet &fs, const PartitionStats &global)
+{
+    if (fs.srcFreq >= 0) p.features[fs.srcFreq] = FreqMoments(p.src, global.src);
+    if (fs.dstFreq >= 0) p.features[fs.dstFreq] = FreqMoments(p.dst, global.dst);
+}
+
+static void WriteArray(std::ostream &js, const char *key, const std::vector<Moments> &m, int what)
+{
+    js << "\"" << key << "\": [";
+    const double eps = std::numeric_limits<double>::epsilon();
+    for (size_t f = 0; f < m.size(); ++f)
+    {
+        double var = m[f].n > 0 ? m[f].m2 / m[f].n : 0.0;
+        // StandardScaler's constant-feature test, so rounding noise does not become a tiny scale
+        double bound = m[f].n * eps * var + (m[f].n * m[f].mean * eps) * (m[f].n * m[f].mean * eps);
+        bool constant = m[f].min == m[f].max || var <= bound;
+        double v = what == 0   ? m[f].mean
+                   : what == 1 ? (constant ? 1.0 : std::sqrt(var))
+                   : what == 2 ? (constant ? 0.0 : var)
+                   : what == 3 ? m[f].min
+                               : m[f].max;
+        js << (f ? ", " : "") << (std::isfinite(v) ? v : 0.0);
+    }
+    js << "]";
+}
+
+static void WriteStats(std::ostream &js, const PartitionStats &p, const char *indent)
+{
+    js << indent;
+    WriteArray(js, "mean_", p.features, 0);
+    js << ",\n" << indent;
+    WriteArray(js, "scale_", p.features, 1);
+    js << ",\n" << indent;
+    WriteArray(js, "var_", p.features, 2);
+    js << ",\n" << indent;
+    WriteArray(js, "min_", p.features, 3);
+    js << ",\n" << indent;
+    WriteArray(js, "max_", p.features, 4);
+    js << ",\n" << indent << "\"rows\": " << p.rows << ", \"attack_rows\": " << p.attackRows
+       << ", \"benign_rows\": " << p.rows - p.attackRows;
+}
+
+int main(int argc, char *argv[])
+{
+    Options o = ParseOptions(argc, argv);
+    FeatureSet fs;
+    if (!fs.Load(o.features))
+    {
+        std::cerr << "Could not load features from " << (o.features.empty() ? "defaults" : o.features) << "\n";
+        return 1;
+    }
+    auto wallStart = std::chrono::steady_clock::now();
+
+    struct Input
+    {
+        std::string path;
+        std::string key;
+    };
+    std::vector<Input> inputs;
+    std::vector<std::string> paths;
+    if (!o.files.empty())
+    {
+        std::ifstream list(o.files);
+        if (!list)
+        {
+            std::cerr << "Cannot read " << o.files << "\n";
+            return 1;
+        }
+        for (std::string line; std::getline(list, line);)
+        {
+            line.erase(line.find_last_not_of(" \t\r") + 1);
+            if (!line.empty()) paths.push_back(line);
+        }
+    }
+    else
+    {
+        for (const auto &e : std::filesystem::directory_iterator(o.data))
+        {
+            if (e.is_regular_file()) paths.push_back(e.path().string());
+        }
+    }
+    for (const std::string &path : paths)
+    {
+        ScenarioInfo info;
+        if (ParseScenario(path, info)) inputs.push_back({path, info.Key()});
+    }
+    std::sort(inputs.begin(), inputs.end(), [](const Input &a, const Input &b) { return a.path < b.path; });
+    if (inputs.empty())
+    {
+        std::cerr << "No dataset_*.csv files in " << (o.files.empty() ? o.data : o.files) << "\n";
+        return 1;
+    }
+
+    // Thread-local partition tables, merged at the end
+    uint32_t nThreads = std::min<size_t>(o.threads, inputs.size());
+    std::vector<std::map<std::string, PartitionStats>> local(nThreads);
+    std::vector<uint64_t> bytes(nThreads, 0);
+    std::vector<std::string> skipped;
+    std::mutex skippedLock;
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> workers;
+    for (uint32_t t = 0; t < nThreads; ++t)
+    {
+        workers.emplace_back([&, t]() {
+            for (size_t i; (i = next.fetch_add(1)) < inputs.size();)
+            {
+                PartitionStats &p = local[t][inputs[i].key];
+                if (p.features.empty()) p.features.resize(fs.names.size());
+                uint64_t b = 0;
+                if (!ScanFile(inputs[i].path, fs, p, b))
+                {
+                    std::lock_guard<std::mutex> g(skippedLock);
+                    skipped.push_back(inputs[i].path);
+                }
+                bytes[t] += b;
+            }
+        });
+    }
+    for (std::thread &t : workers) t.join();
+
+    std::map<std::string, PartitionStats> parts;
+    PartitionStats global;
+    global.features.resize(fs.names.size());
+    uint64_t totalBytes = 0;
+    for (uint32_t t = 0; t < nThreads; ++t)
+    {
+        for (auto &e : local[t]) parts[e.first].Merge(e.second);
+        totalBytes += bytes[t];
+        local[t].clear();
+    }
+    for (auto &e : parts) global.Merge(e.second);
+    FinishFreq(global, fs, global);
+    for (auto &e : parts) FinishFreq(e.second, fs, global);
+    double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    std::ofstream js(o.out);
+    js << std::setprecision(17);
+    js << "{\n  \"n_features_in_\": " << fs.names.size() << ",\n  \"n_samples_seen_\": " << global.rows
+       << ",\n  \"feature_names_in_\": [";
+    for (size_t f = 0; f < fs.names.size(); ++f) js << (f ? ", " : "") << "\"" << fs.names[f] << "\"";
+    js << "],\n";
+    WriteStats(js, global, "  ");
+    js << ",\n  \"class_balance\": {\"benign\": " << global.rows - global.attackRows
+       << ", \"attack\": " << global.attackRows << "},\n  \"files\": " << inputs.size() - skipped.size()
+       << ",\n  \"source\": \"" << (o.files.empty() ? o.data : o.files) << "\"";
+    if (o.partitions)
+    {
+        js << ",\n  \"partitions\": {";
+        size_t i = 0;
+        for (const auto &e : parts)
+        {
+            js << (i++ ? "," : "") << "\n    \"" << e.first << "\": {\n";
+            WriteStats(js, e.second, "      ");
+            js << "}";
+        }
+        js << "\n  }";
+    }
+    js << "\n}\n";
+    if (!js)
+    {
+        std::cerr << "Failed writing " << o.out << "\n";
+        return 1;
+    }
+
+    for (const std::string &s : skipped) std::cerr << "Skipped " << s << ": missing columns or unreadable\n";
+    std::cout << "Scanned " << inputs.size() - skipped.size() << " files, " << global.rows << " rows, "
+              << totalBytes / 1e6 << " MB in " << wallS << " s (" << totalBytes / 1e6 / wallS << " MB/s, " << nThreads
+              << " threads); attack " << global.attackRows << ", benign " << global.rows - global.attackRows
+              << "; wrote " << o.out << "\n";
+    return skipped.empty() ? 0 : 2;
+}
@@ -0,0 +1,398 @@
+// dataset_compact.cc - Compact the per-run dataset CSVs into partitioned columnar shards
+// Every generator run writes its own small CSV, so training globs and opens thousands of
+// files. This reads them in parallel and rewrites them as typed columnar shards
+// (tools/dataset_shard.h) partitioned by ue_total x mobility x transport x attack x intensity,
+// the dimensions encoded in each run's scenario_id. Shards close once they reach --shardMB, at a
+// run boundary. manifest.json in --out lists every partition with its row count, label balance
+// and shards (rows and the byte offset of each column), plus every run, so a training job can
+// map only the partitions it needs.
+//
+// Build: g++ -O2 -std=c++17 -pthread -o dataset_compact tools/dataset_compact.cc
+// Usage: ./dataset_compact --data=datasets --out=datasets_compact --threads=8 --shardMB=64
+
+#include "dataset_shard.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Options
+{
+    std::string data = "datasets";
+    std::string out = "datasets_compact";
+    uint32_t threads = std::max(1u, std::thread::hardware_concurrency());
+    double shardMB = 64.0;
+};
+
+struct RunInfo
+{
+    std::string path;
+    ScenarioInfo scenario;
+    uint64_t bytesIn = 0;
+    uint64_t rows = 0;
+    uint64_t attackRows = 0;
+    uint64_t firstRow = 0; // within its shard
+    int shard = -1;        // index into the partition's shards; -1 = skipped
+    std::string error;
+};
+
+struct ShardInfo
+{
+    std::string file;
+    uint64_t rows = 0;
+    uint64_t attackRows = 0;
+    uint64_t bytes = 0;
+    uint32_t firstRun = 0; // global run index
+    uint32_t runs = 0;
+    std::vector<ShardColumnEntry> columns;
+};
+
+struct Partition
+{
+    std::string key;
+    std::vector<uint32_t> runs; // global run indices, in file name order
+    std::vector<ShardInfo> shards;
+    uint64_t rows = 0;
+    uint64_t attackRows = 0;
+};
+
+static bool ParseArg(const char *arg, const char *name, std::string &value)
+{
+    size_t n = std::strlen(name);
+    if (std::strncmp(arg, "--", 2) != 0 || std::strncmp(arg + 2, name, n) != 0 || arg[2 + n] != '=') return false;
+    value = arg + 3 + n;
+    return true;
+}
+
+static Options ParseOptions(int argc, char *argv[])
+{
+    Options o;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string v;
+        if (ParseArg(argv[i], "data", v)) o.data = v;
+        else if (ParseArg(argv[i], "out", v)) o.out = v;
+        else if (ParseArg(argv[i], "threads", v)) o.threads = std::max(1ul, std::stoul(v));
+        else if (ParseArg(argv[i], "shardMB", v)) o.shardMB = std::stod(v);
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << "\n"
+                      << "Options: --data --out --threads --shardMB\n";
+            std::exit(1);
+        }
+    }
+    return o;
+}
+
+static std::string Quote(const std::string &s)
+{
+    std::string out = "\"";
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+// Appends one run's rows to the writer; on a malformed row the run is rolled back
+static void CompactRun(RunInfo &run, uint32_t runIndex, ShardWriter &w)
+{
+    MappedFile f;
+    if (!f.Open(run.path))
+    {
+        run.error = "cannot open";
+        return;
+    }
+    run.bytesIn = f.Size();
+    const char *p = f.Data();
+    const char *end = p + f.Size();
+    const char *eol = std::find(p, end, '\n');
+    std::vector<std::string> names = SplitString(std::string(p, eol), ',');
+    if (!names.empty() && !names.back().empty() && names.back().back() == '\r') names.back().pop_back();
+    p = eol < end ? eol + 1 : end;
+
+    // scenario_id is replaced by the run index
+    int scenarioCol = -1;
+    int labelCol = -1;
+    for (size_t c = 0; c < names.size(); ++c)
+    {
+        if (names[c] == "scenario_id")
+        {
+            scenarioCol = static_cast<int>(c);
+            names[c] = "run";
+        }
+        if (names[c] == "label_binary") labelCol = static_cast<int>(c);
+    }
+    if (scenarioCol < 0 || labelCol < 0)
+    {
+        run.error = "no scenario_id or label_binary column";
+        return;
+    }
+    if (w.GetNames() != names)
+    {
+        run.error = "header changed while reading"; // the caller set the schema from HeaderOf()
+        return;
+    }
+
+    uint64_t start = w.GetRows();
+    run.firstRow = start;
+    while (p < end)
+    {
+        eol = std::find(p, end, '\n');
+        const char *lineEnd = eol > p && eol[-1] == '\r' ? eol - 1 : eol;
+        if (lineEnd == p)
+        {
+            p = eol < end ? eol + 1 : end;
+            continue;
+        }
+        size_t col = 0;
+        const char *field = p;
+        bool ok = true;
+        for (const char *q = p; ok; ++q)
+        {
+            if (q != lineEnd && *q != ',') continue;
+            if (col >= names.size())
+            {
+                ok = false;
+                break;
+            }
+            if (static_cast<int>(col) == scenarioCol)
+            {
+                if (run.rows == 0 && std::string(field, q) != run.scenario.scenarioId)
+                {
+                    std::cerr << run.path << ": scenario_id " << std::string(field, q) << " differs from the file name\n";
+                }
+                w.Append(col, runIndex);
+            }
+            else
+            {
+                if (static_cast<int>(col) == labelCol && q - field == 1 && *field == '1') run.attackRows++;
+                ok = w.AppendText(col, field, q);
+            }
+            col++;
+            field = q + 1;
+            if (q == lineEnd) break;
+        }
+        if (!ok || col != names.size())
+        {
+            w.Truncate(start);
+            run.error = "malformed row " + std::to_string(run.rows + 2);
+            run.rows = 0;
+            run.attackRows = 0;
+            return;
+        }
+        w.EndRow();
+        run.rows++;
+        p = eol < end ? eol + 1 : end;
+    }
+}
+
+static std::vector<std::string> HeaderOf(const std::string &path)
+{
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    std::vector<std::string> names = SplitString(line, ',');
+    std::replace(names.begin(), names.end(), std::string("scenario_id"), std::string("run"));
+    return names;
+}
+
+static void CompactPartition(const Options &o, Partition &part, std::vector<RunInfo> &runs)
+{
+    ShardWriter w;
+    uint64_t limit = static_cast<uint64_t>(o.shardMB * 1024 * 1024);
+    ShardInfo current;
+
+    auto flush = [&]() {
+        if (w.GetRows() == 0) return;
+        char name[32];
+        std::snprintf(name, sizeof(name), "-%05zu.ddsh", part.shards.size());
+        current.file = part.key + name;
+        current.rows = w.GetRows();
+        if (!w.Write(o.out + "/" + current.file, current.columns))
+        {
+            std::cerr << "Failed writing " << current.file << "\n";
+            std::exit(1);
+        }
+        current.bytes = std::filesystem::file_size(o.out + "/" + current.file);
+        part.shards.push_back(current);
+        current = ShardInfo();
+    };
+
+    for (uint32_t r : part.runs)
+    {
+        RunInfo &run = runs[r];
+        std::vector<std::string> names = HeaderOf(run.path);
+        if (names != w.GetNames())
+        {
+            flush();
+            w.SetSchema(names);
+        }
+        CompactRun(run, r, w);
+        if (!run.error.empty() || run.rows == 0) continue;
+        if (current.runs == 0) current.firstRun = r;
+        current.runs++;
+        current.rows += run.rows;
+        current.attackRows += run.attackRows;
+        run.shard = static_cast<int>(part.shards.size());
+        part.rows += run.rows;
+        part.attackRows += run.attackRows;
+        if (w.GetBytes() >= limit) flush();
+    }
+    flush();
+}
+
+static void WriteManifest(const Options &o, const std::vector<Partition> &parts, const std::vector<RunInfo> &runs,
+                          double wallS)
+{
+    uint64_t rows = 0;
+    uint64_t attackRows = 0;
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+    size_t shards = 0;
+    for (const Partition &p : parts)
+    {
+        rows += p.rows;
+        attackRows += p.attackRows;
+        shards += p.shards.size();
+        for (const ShardInfo &s : p.shards) bytesOut += s.bytes;
+    }
+    for (const RunInfo &r : runs) bytesIn += r.bytesIn;
+
+    std::ofstream js(o.out + "/manifest.json");
+    js << "{\n  \"format\": \"ddsh\",\n  \"version\": " << kShardVersion << ",\n  \"source\": " << Quote(o.data)
+       << ",\n  \"files\": " << runs.size() << ",\n  \"rows\": " << rows << ",\n  \"attack_rows\": " << attackRows
+       << ",\n  \"benign_rows\": " << rows - attackRows << ",\n  \"shards\": " << shards
+       << ",\n  \"bytes_in\": " << bytesIn << ",\n  \"bytes_out\": " << bytesOut << ",\n  \"wall_s\": " << wallS
+       << ",\n  \"partitions\": [";
+    for (size_t i = 0; i < parts.size(); ++i)
+    {
+        const Partition &p = parts[i];
+        const ScenarioInfo &s = runs[p.runs.front()].scenario;
+        js << (i ? "," : "") << "\n    {\"key\": " << Quote(p.key) << ", \"ue_total\": " << s.ueTotal
+           << ", \"mobility\": " << Quote(s.mobility) << ", \"transport\": " << Quote(s.transport)
+           << ", \"attack\": " << Quote(s.attack) << ", \"intensity\": " << Quote(s.intensity)
+           << ",\n     \"rows\": " << p.rows << ", \"attack_rows\": " << p.attackRows
+           << ", \"benign_rows\": " << p.rows - p.attackRows << ", \"runs\": " << p.runs.size()
+           << ",\n     \"shards\": [";
+        for (size_t k = 0; k < p.shards.size(); ++k)
+        {
+            const ShardInfo &sh = p.shards[k];
+            js << (k ? "," : "") << "\n       {\"file\": " << Quote(sh.file) << ", \"rows\": " << sh.rows
+               << ", \"attack_rows\": " << sh.attackRows << ", \"bytes\": " << sh.bytes
+               << ", \"first_run\": " << sh.firstRun << ", \"runs\": " << sh.runs << ",\n        \"columns\": [";
+            for (size_t c = 0; c < sh.columns.size(); ++c)
+            {
+                const ShardColumnEntry &e = sh.columns[c];
+                js << (c ? ", " : "") << "{\"name\": " << Quote(e.name) << ", \"dtype\": " << Quote(ShardTypeName(e.type))
+                   << ", \"offset\": " << e.offset << ", \"bytes\": " << e.bytes << "}";
+            }
+            js << "]}";
+        }
+        js << "]}";
+    }
+    js << "\n  ],\n  \"runs\": [";
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        const RunInfo &r = runs[i];
+        js << (i ? "," : "") << "\n    {\"run\": " << i << ", \"scenario_id\": " << Quote(r.scenario.scenarioId)
+           << ", \"rep\": " << r.scenario.rep << ", \"partition\": " << Quote(r.scenario.Key())
+           << ", \"file\": " << Quote(r.path.substr(r.path.find_last_of('/') + 1)) << ", \"shard\": " << r.shard
+           << ", \"first_row\": " << r.firstRow << ", \"rows\": " << r.rows << ", \"attack_rows\": " << r.attackRows;
+        if (!r.error.empty()) js << ", \"error\": " << Quote(r.error);
+        js << "}";
+    }
+    js << "\n  ]\n}\n";
+    if (!js)
+    {
+        std::cerr << "Failed writing " << o.out << "/manifest.json\n";
+        std::exit(1);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Options o = ParseOptions(argc, argv);
+    auto wallStart = std::chrono::steady_clock::now();
+
+    // Runs sorted by partition, then file name; the position is the run index
+    std::vector<RunInfo> runs;
+    for (const auto &e : std::filesystem::directory_iterator(o.data))
+    {
+        RunInfo r;
+        r.path = e.path().string();
+        if (e.is_regular_file() && ParseScenario(r.path, r.scenario)) runs.push_back(r);
+    }
+    if (runs.empty())
+    {
+        std::cerr << "No dataset_*.csv files in " << o.data << "\n";
+        return 1;
+    }
+    std::sort(runs.begin(), runs.end(), [](const RunInfo &a, const RunInfo &b) {
+        std::string ka = a.scenario.Key();
+        std::string kb = b.scenario.Key();
+        return ka != kb ? ka < kb : a.path < b.path;
+    });
+
+    std::vector<Partition> parts;
+    for (uint32_t i = 0; i < runs.size(); ++i)
+    {
+        std::string key = runs[i].scenario.Key();
+        if (parts.empty() || parts.back().key != key)
+        {
+            parts.emplace_back();
+            parts.back().key = key;
+        }
+        parts.back().runs.push_back(i);
+    }
+
+    std::filesystem::create_directories(o.out);
+    // One partition per task: memory stays at about one shard per thread
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> workers;
+    for (uint32_t t = 0; t < std::min<size_t>(o.threads, parts.size()); ++t)
+    {
+        workers.emplace_back([&]() {
+            for (size_t i; (i = next.fetch_add(1)) < parts.size();) CompactPartition(o, parts[i], runs);
+        });
+    }
+    for (std::thread &t : workers) t.join();
+
+    double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    WriteManifest(o, parts, runs, wallS);
+
+    uint64_t rows = 0;
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+    size_t shards = 0;
+    size_t skipped = 0;
+    for (const Partition &p : parts)
+    {
+        rows += p.rows;
+        shards += p.shards.size();
+        for (const ShardInfo &s : p.shards) bytesOut += s.bytes;
+    }
+    for (const RunInfo &r : runs)
+    {
+        bytesIn += r.bytesIn;
+        if (!r.error.empty())
+        {
+            std::cerr << "Skipped " << r.path << ": " << r.error << "\n";
+            skipped++;
+        }
+    }
+    std::cout << "Compacted " << runs.size() - skipped << " of " << runs.size() << " files, " << rows << " rows into "
+              << shards << " shards in " << parts.size() << " partitions: " << bytesIn / 1e6 << " MB -> "
+              << bytesOut / 1e6 << " MB in " << wallS << " s\n";
+    return skipped ? 2 : 0;
+}
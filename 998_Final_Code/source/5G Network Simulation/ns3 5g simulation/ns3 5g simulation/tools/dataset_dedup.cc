@@ -0,0 +1,516 @@
+// dataset_dedup.cc - Collapse identical window rows across runs into one row with a weight
+// Many rows repeat across repetitions and scenarios: one-packet handshake flows, idle flows
+// with zero delay. A row's content key is every column except scenario_id, time_start,
+// time_end, src_ip and dst_ip (labels included, so an attack row never merges with a benign
+// one). The key is hashed to 64 bits. The output keeps one row per distinct key, the first
+// occurrence in file-name order, with a trailing weight column counting its copies. Train with
+// sample_weight=weight to recover the original distribution.
+//
+// Memory is bounded by --memMB however large the corpus is. Pass 1 streams the memory-mapped
+// CSVs on --threads workers. Each row goes with its hash to one of B bucket spill files,
+// chosen by the top hash bits. Pass 2 deduplicates the buckets in parallel, one at a time per
+// worker, each with its own hash table. B is sized so that threads x bucket fits in --memMB.
+// Keys whose hashes collide are compared byte for byte and kept apart.
+//
+// Build: g++ -O2 -std=c++17 -pthread -o dataset_dedup tools/dataset_dedup.cc
+// Usage: ./dataset_dedup --data=datasets --out=dataset_dedup.csv --threads=8 --memMB=512
+
+#include "dataset_shard.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct Options
+{
+    std::string data = "datasets";
+    std::string out = "dataset_dedup.csv";
+    std::string spill; // empty = <out>.spill
+    uint32_t threads = std::max(1u, std::thread::hardware_concurrency());
+    uint64_t memMB = 512;
+};
+
+// Columns that identify a run or a moment rather than the traffic, left out of the key
+static const char *kExcluded[] = {"scenario_id", "time_start", "time_end", "src_ip", "dst_ip"};
+
+static const size_t kSpillBufferBytes = 16 * 1024;
+
+static bool ParseArg(const char *arg, const char *name, std::string &value)
+{
+    size_t n = std::strlen(name);
+    if (std::strncmp(arg, "--", 2) != 0 || std::strncmp(arg + 2, name, n) != 0 || arg[2 + n] != '=') return false;
+    value = arg + 3 + n;
+    return true;
+}
+
+static Options ParseOptions(int argc, char *argv[])
+{
+    Options o;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string v;
+        if (ParseArg(argv[i], "data", v)) o.data = v;
+        else if (ParseArg(argv[i], "out", v)) o.out = v;
+        else if (ParseArg(argv[i], "spill", v)) o.spill = v;
+        else if (ParseArg(argv[i], "threads", v)) o.threads = std::max(1ul, std::stoul(v));
+        else if (ParseArg(argv[i], "memMB", v)) o.memMB = std::max(1ul, std::stoul(v));
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << "\n"
+                      << "Options: --data --out --spill --threads --memMB\n";
+            std::exit(1);
+        }
+    }
+    if (o.spill.empty()) o.spill = o.out + ".spill";
+    return o;
+}
+
+// wyhash-style multiply-fold over 16-byte blocks
+static inline uint64_t Fold(uint64_t a, uint64_t b)
+{
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+}
+
+static uint64_t HashBytes(const char *p, size_t n)
+{
+    const uint64_t k0 = 0xa0761d6478bd642full, k1 = 0xe7037ed1a0b428dbull, k2 = 0x8ebc6af09c88c6e3ull;
+    uint64_t h = k0 ^ Fold(n, k1);
+    uint64_t a = 0;
+    uint64_t b = 0;
+    for (; n > 16; n -= 16, p += 16)
+    {
+        std::memcpy(&a, p, 8);
+        std::memcpy(&b, p + 8, 8);
+        h = Fold(a ^ k1, b ^ h);
+    }
+    a = 0;
+    b = 0;
+    std::memcpy(&a, p, std::min<size_t>(n, 8));
+    if (n > 8) std::memcpy(&b, p + 8, n - 8);
+    return Fold(k2 ^ n, Fold(a ^ k1, b ^ h));
+}
+
+// Spill record: this header, the row text without its newline, then the row's key text,
+// padded to 8 bytes so the next header is aligned
+struct SpillRecord
+{
+    uint64_t hash;
+    uint32_t file;
+    uint32_t line;
+    uint32_t keyBytes;
+    uint32_t rowBytes;
+
+    size_t Size() const { return (sizeof(SpillRecord) + rowBytes + keyBytes + 7) & ~size_t(7); }
+    const char *Row() const { return reinterpret_cast<const char *>(this + 1); }
+    const char *Key() const { return Row() + rowBytes; }
+};
+
+// True if the row's label_binary field is not 0
+static bool IsAttack(const char *p, const char *end, size_t labelCol)
+{
+    for (size_t col = 0; col < labelCol; ++col)
+    {
+        const char *c = static_cast<const char *>(std::memchr(p, ',', end - p));
+        if (!c) return false;
+        p = c + 1;
+    }
+    return p < end && *p != '0';
+}
+
+// Appends the key columns of one row (separated by ',') to 'key'
+static void ProjectKey(const char *p, const char *end, const std::vector<bool> &inKey, std::string &key)
+{
+    key.clear();
+    size_t col = 0;
+    while (p <= end)
+    {
+        const char *comma = static_cast<const char *>(std::memchr(p, ',', end - p));
+        const char *fe = comma ? comma : end;
+        if (col < inKey.size() && inKey[col])
+        {
+            key.append(p, fe);
+            key.push_back(',');
+        }
+        ++col;
+        if (!comma) break;
+        p = comma + 1;
+    }
+}
+
+class Spill
+{
+  public:
+    bool Open(const std::string &dir, uint32_t buckets)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+        m_dir = dir;
+        m_files.resize(buckets);
+        m_locks = std::vector<std::mutex>(buckets);
+        for (uint32_t b = 0; b < buckets; ++b)
+        {
+            m_files[b] = std::fopen(Path(b).c_str(), "wb");
+            if (!m_files[b]) return false;
+        }
+        return true;
+    }
+
+    std::string Path(uint32_t b) const { return m_dir + "/bucket-" + std::to_string(b) + ".bin"; }
+
+    bool Append(uint32_t b, const std::vector<char> &data)
+    {
+        std::lock_guard<std::mutex> g(m_locks[b]);
+        m_bytes += data.size();
+        return std::fwrite(data.data(), 1, data.size(), m_files[b]) == data.size();
+    }
+
+    bool Close()
+    {
+        bool ok = true;
+        for (FILE *&f : m_files)
+        {
+            if (f) ok &= std::fclose(f) == 0;
+            f = nullptr;
+        }
+        return ok;
+    }
+
+    uint64_t Bytes() const { return m_bytes; }
+
+  private:
+    std::string m_dir;
+    std::vector<FILE *> m_files;
+    std::vector<std::mutex> m_locks;
+    std::atomic<uint64_t> m_bytes{0};
+};
+
+struct Totals
+{
+    std::atomic<uint64_t> rowsIn{0};
+    std::atomic<uint64_t> attackIn{0};
+    std::atomic<uint64_t> rowsOut{0};
+    std::atomic<uint64_t> attackOut{0};
+    std::atomic<uint64_t> collisions{0};
+    std::atomic<uint64_t> maxWeight{0};
+};
+
+// Pass 1: hash every row of one CSV into the spill buckets
+static bool SpillFile(const std::string &path, uint32_t fileIndex, const std::string &header,
+                      const std::vector<bool> &inKey, size_t labelCol, Spill &spill,
+                      std::vector<std::vector<char>> &buffers, int bucketShift, Totals &totals)
+{
+    MappedFile f;
+    if (!f.Open(path)) return false;
+    const char *p = f.Data();
+    const char *end = p + f.Size();
+    const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+    std::string h(p, eol ? eol : end);
+    if (!h.empty() && h.back() == '\r') h.pop_back();
+    if (h != header) return false;
+
+    std::string key;
+    uint32_t line = 0;
+    for (p = eol ? eol + 1 : end; p < end; ++line)
+    {
+        const char *nl = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        const char *le = nl ? nl : end;
+        const char *next = nl ? nl + 1 : end;
+        if (le > p && le[-1] == '\r') --le;
+        if (le == p)
+        {
+            p = next;
+            continue;
+        }
+        ProjectKey(p, le, inKey, key);
+        SpillRecord r;
+        r.hash = HashBytes(key.data(), key.size());
+        r.file = fileIndex;
+        r.line = line;
+        r.keyBytes = static_cast<uint32_t>(key.size());
+        r.rowBytes = static_cast<uint32_t>(le - p);
+
+        uint32_t b = bucketShift >= 64 ? 0 : static_cast<uint32_t>(r.hash >> bucketShift);
+        std::vector<char> &buf = buffers[b];
+        buf.insert(buf.end(), reinterpret_cast<const char *>(&r), reinterpret_cast<const char *>(&r + 1));
+        buf.insert(buf.end(), p, le);
+        buf.insert(buf.end(), key.begin(), key.end());
+        buf.resize(buf.size() + (r.Size() - sizeof(r) - r.rowBytes - r.keyBytes), '\0');
+        if (buf.size() >= kSpillBufferBytes)
+        {
+            if (!spill.Append(b, buf)) return false;
+            buf.clear();
+        }
+        totals.rowsIn++;
+        if (IsAttack(p, le, labelCol)) totals.attackIn++;
+        p = next;
+    }
+    return true;
+}
+
+// Pass 2 output per bucket: this header, then the finished CSV line
+struct OutputRecord
+{
+    uint32_t file;
+    uint32_t line;
+    uint32_t bytes;
+};
+
+// Reads one bucket's output records in order, for the final merge
+struct BucketCursor
+{
+    FILE *in = nullptr;
+    OutputRecord rec{};
+    std::string text;
+
+    bool Next()
+    {
+        if (std::fread(&rec, sizeof(rec), 1, in) != 1) return false;
+        text.resize(rec.bytes);
+        return std::fread(&text[0], 1, rec.bytes, in) == rec.bytes;
+    }
+};
+
+struct Kept
+{
+    const SpillRecord *rec;
+    uint64_t weight;
+    int64_t next; // next distinct key with the same hash, -1 = none
+};
+
+// Pass 2: deduplicate one bucket and write its distinct rows in first-occurrence order
+static bool DedupBucket(const std::string &path, const std::string &outPath, size_t labelCol, Totals &totals)
+{
+    MappedFile f;
+    std::vector<Kept> kept;
+    std::unordered_map<uint64_t, int64_t> first;
+    if (std::filesystem::file_size(path) > 0)
+    {
+        if (!f.Open(path)) return false;
+        const char *p = f.Data();
+        const char *end = p + f.Size();
+        while (p + sizeof(SpillRecord) <= end)
+        {
+            const SpillRecord *r = reinterpret_cast<const SpillRecord *>(p);
+            p += r->Size();
+            auto it = first.find(r->hash);
+            if (it == first.end())
+            {
+                first.emplace(r->hash, static_cast<int64_t>(kept.size()));
+                kept.push_back({r, 1, -1});
+                continue;
+            }
+            int64_t i = it->second;
+            for (;;)
+            {
+                Kept &k = kept[i];
+                if (k.rec->keyBytes == r->keyBytes && std::memcmp(k.rec->Key(), r->Key(), r->keyBytes) == 0)
+                {
+                    k.weight++;
+                    // Records arrive in thread order; keep the earliest row as the representative
+                    if (std::make_pair(r->file, r->line) < std::make_pair(k.rec->file, k.rec->line)) k.rec = r;
+                    break;
+                }
+                if (k.next < 0)
+                {
+                    totals.collisions++;
+                    k.next = static_cast<int64_t>(kept.size());
+                    kept.push_back({r, 1, -1});
+                    break;
+                }
+                i = k.next;
+            }
+        }
+    }
+
+    std::sort(kept.begin(), kept.end(), [](const Kept &a, const Kept &b) {
+        return std::make_pair(a.rec->file, a.rec->line) < std::make_pair(b.rec->file, b.rec->line);
+    });
+    FILE *out = std::fopen(outPath.c_str(), "wb");
+    if (!out) return false;
+    uint64_t maxWeight = 0;
+    std::string line;
+    for (const Kept &k : kept)
+    {
+        line.assign(k.rec->Row(), k.rec->rowBytes);
+        line += "," + std::to_string(k.weight) + "\n";
+        OutputRecord r{k.rec->file, k.rec->line, static_cast<uint32_t>(line.size())};
+        std::fwrite(&r, sizeof(r), 1, out);
+        std::fwrite(line.data(), 1, line.size(), out);
+        maxWeight = std::max(maxWeight, k.weight);
+        if (IsAttack(k.rec->Row(), k.rec->Row() + k.rec->rowBytes, labelCol)) totals.attackOut++;
+    }
+    totals.rowsOut += kept.size();
+    uint64_t seen = totals.maxWeight.load();
+    while (seen < maxWeight && !totals.maxWeight.compare_exchange_weak(seen, maxWeight))
+    {
+    }
+    return std::fclose(out) == 0;
+}
+
+int main(int argc, char *argv[])
+{
+    Options o = ParseOptions(argc, argv);
+    auto wallStart = std::chrono::steady_clock::now();
+
+    std::vector<std::string> paths;
+    uint64_t inputBytes = 0;
+    for (const auto &e : std::filesystem::directory_iterator(o.data))
+    {
+        ScenarioInfo info;
+        if (e.is_regular_file() && ParseScenario(e.path().string(), info))
+        {
+            paths.push_back(e.path().string());
+            inputBytes += e.file_size();
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    if (paths.empty())
+    {
+        std::cerr << "No dataset_*.csv files in " << o.data << "\n";
+        return 1;
+    }
+
+    // Schema from the first file; every other file must match it
+    std::string header;
+    {
+        MappedFile f;
+        if (!f.Open(paths[0])) return 1;
+        const char *eol = static_cast<const char *>(std::memchr(f.Data(), '\n', f.Size()));
+        header.assign(f.Data(), eol ? eol : f.Data() + f.Size());
+        if (!header.empty() && header.back() == '\r') header.pop_back();
+    }
+    std::vector<std::string> columns = SplitString(header, ',');
+    std::vector<bool> inKey(columns.size(), true);
+    size_t labelCol = columns.size();
+    for (size_t c = 0; c < columns.size(); ++c)
+    {
+        if (std::find(std::begin(kExcluded), std::end(kExcluded), columns[c]) != std::end(kExcluded)) inKey[c] = false;
+        if (columns[c] == "label_binary") labelCol = c;
+    }
+
+    // Spill records hold the row and its key (about twice the CSV text) plus the table entry;
+    // size buckets so that one per thread fits the budget
+    uint64_t budget = o.memMB << 20;
+    uint64_t perThread = std::max<uint64_t>(1, budget / o.threads);
+    uint64_t needed = (inputBytes * 3) / perThread + 1;
+    uint32_t buckets = 1;
+    while (buckets < needed || buckets < o.threads) buckets <<= 1;
+    int bucketShift = 64;
+    for (uint32_t b = buckets; b > 1; b >>= 1) --bucketShift;
+
+    Spill spill;
+    if (!spill.Open(o.spill, buckets))
+    {
+        std::cerr << "Cannot create spill files in " << o.spill << "\n";
+        return 1;
+    }
+
+    Totals totals;
+    std::vector<std::string> skipped;
+    std::mutex skippedLock;
+    std::atomic<size_t> next{0};
+    std::atomic<bool> ioOk{true};
+    std::vector<std::thread> workers;
+    for (uint32_t t = 0; t < std::min<size_t>(o.threads, paths.size()); ++t)
+    {
+        workers.emplace_back([&]() {
+            std::vector<std::vector<char>> buffers(buckets);
+            for (size_t i; (i = next.fetch_add(1)) < paths.size();)
+            {
+                if (!SpillFile(paths[i], static_cast<uint32_t>(i), header, inKey, labelCol, spill, buffers, bucketShift,
+                               totals))
+                {
+                    std::lock_guard<std::mutex> g(skippedLock);
+                    skipped.push_back(paths[i]);
+                }
+            }
+            for (uint32_t b = 0; b < buckets; ++b)
+            {
+                if (!buffers[b].empty() && !spill.Append(b, buffers[b])) ioOk = false;
+            }
+        });
+    }
+    for (std::thread &t : workers) t.join();
+    if (!spill.Close()) ioOk = false;
+    double spillS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    std::atomic<uint32_t> nextBucket{0};
+    std::atomic<bool> dedupOk{true};
+    workers.clear();
+    for (uint32_t t = 0; t < std::min(o.threads, buckets); ++t)
+    {
+        workers.emplace_back([&]() {
+            for (uint32_t b; (b = nextBucket.fetch_add(1)) < buckets;)
+            {
+                std::string in = spill.Path(b);
+                if (!DedupBucket(in, in + ".out", labelCol, totals)) dedupOk = false;
+                std::remove(in.c_str());
+            }
+        });
+    }
+    for (std::thread &t : workers) t.join();
+
+    // Each bucket is sorted by first occurrence; merging them gives input order, so the output
+    // is the same for any --threads and --memMB
+    FILE *out = std::fopen(o.out.c_str(), "wb");
+    bool outOk = out && std::fprintf(out, "%s,weight\n", header.c_str()) > 0;
+    std::vector<BucketCursor> cursors(buckets);
+    auto later = [&](uint32_t a, uint32_t b) {
+        return std::make_pair(cursors[a].rec.file, cursors[a].rec.line) >
+               std::make_pair(cursors[b].rec.file, cursors[b].rec.line);
+    };
+    std::priority_queue<uint32_t, std::vector<uint32_t>, decltype(later)> heap(later);
+    for (uint32_t b = 0; b < buckets && outOk; ++b)
+    {
+        cursors[b].in = std::fopen((spill.Path(b) + ".out").c_str(), "rb");
+        if (!cursors[b].in) outOk = false;
+        else if (cursors[b].Next()) heap.push(b);
+    }
+    while (outOk && !heap.empty())
+    {
+        uint32_t b = heap.top();
+        heap.pop();
+        outOk = std::fwrite(cursors[b].text.data(), 1, cursors[b].text.size(), out) == cursors[b].text.size();
+        if (cursors[b].Next()) heap.push(b);
+    }
+    for (uint32_t b = 0; b < buckets; ++b)
+    {
+        if (cursors[b].in) std::fclose(cursors[b].in);
+        std::remove((spill.Path(b) + ".out").c_str());
+    }
+    if (out) outOk &= std::fclose(out) == 0;
+    std::error_code ec;
+    std::filesystem::remove(o.spill, ec);
+    if (!ioOk || !dedupOk)
+    {
+        std::cerr << "Failed writing spill files in " << o.spill << "\n";
+        return 1;
+    }
+    if (!outOk)
+    {
+        std::cerr << "Failed writing " << o.out << "\n";
+        return 1;
+    }
+
+    double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    uint64_t in = totals.rowsIn, outRows = totals.rowsOut;
+    for (const std::string &s : skipped) std::cerr << "Skipped " << s << ": unreadable or different header\n";
+    std::cout << "Read " << in << " rows from " << paths.size() - skipped.size() << " files ("
+              << inputBytes / 1e6 << " MB); kept " << outRows << " distinct (" << (in ? 100.0 * outRows / in : 0.0)
+              << " %), max weight " << totals.maxWeight << "\n"
+              << "  attack rows " << totals.attackIn << " -> " << totals.attackOut << ", benign "
+              << in - totals.attackIn << " -> " << outRows - totals.attackOut << "\n"
+              << "  " << buckets << " buckets, " << spill.Bytes() / 1e6 << " MB spilled, " << totals.collisions
+              << " hash collisions; spill " << spillS << " s, total " << wallS << " s\n"
+              << "Wrote " << o.out << "\n";
+    return skipped.empty() ? 0 : 2;
+}
@@ -0,0 +1,426 @@
+// dataset_shard.h - Typed columnar shard files for the compacted dataset corpus (.ddsh)
+// Written by tools/dataset_compact.cc; read by the dataset tools and, through the column
+// offsets in manifest.json, by NumPy (np.memmap). No ns-3 dependency.
+//
+// Layout, little-endian:
+//   ShardFileHeader
+//   ShardColumnEntry[columns]   name, type, byte offset and length of each column
+//   column data                 rows values of the column's type, each column 64-byte aligned
+// scenario_id is not stored per row: the "run" column indexes manifest.json's "runs" list.
+// A run (one generator CSV) is never split across shards.
+
+#ifndef DATASET_SHARD_H
+#define DATASET_SHARD_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#pragma pack(push, 1)
+
+struct ShardFileHeader
+{
+    char magic[4];      // "DDSH"
+    uint32_t version;   // 1
+    uint64_t rows;
+    uint32_t columns;
+    uint32_t reserved;
+    uint64_t dataBytes; // file size
+    uint8_t pad[32];
+};
+
+struct ShardColumnEntry
+{
+    char name[40];      // NUL-padded
+    uint32_t type;      // ShardColumnType
+    uint32_t reserved;
+    uint64_t offset;    // from the start of the file
+    uint64_t bytes;
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(ShardFileHeader) == 64, "ShardFileHeader layout changed");
+static_assert(sizeof(ShardColumnEntry) == 64, "ShardColumnEntry layout changed");
+
+static const char kShardMagic[4] = {'D', 'D', 'S', 'H'};
+static const uint32_t kShardVersion = 1;
+static const uint64_t kShardAlign = 64;
+
+enum ShardColumnType : uint32_t
+{
+    kU8 = 1,
+    kU16 = 2,
+    kU32 = 3,
+    kU64 = 4,
+    kF64 = 5,
+    kIpv4 = 6, // u32, host order (10.1.1.3 = 0x0A010103)
+};
+
+inline size_t ShardTypeSize(uint32_t type)
+{
+    switch (type)
+    {
+    case kU8: return 1;
+    case kU16: return 2;
+    case kU32: case kIpv4: return 4;
+    default: return 8;
+    }
+}
+
+// NumPy dtype string, for manifest.json
+inline const char *ShardTypeName(uint32_t type)
+{
+    switch (type)
+    {
+    case kU8: return "u1";
+    case kU16: return "<u2";
+    case kU32: return "<u4";
+    case kU64: return "<u8";
+    case kIpv4: return "<u4";
+    default: return "<f8";
+    }
+}
+
+// Storage type of a CSV column; columns not listed (queue and radio KPIs) are kept as f64
+inline uint32_t ShardTypeForColumn(const std::string &name)
+{
+    if (name == "src_ip" || name == "dst_ip") return kIpv4;
+    if (name == "src_port" || name == "dst_port" || name == "cell_id") return kU16;
+    if (name == "protocol" || name == "label_binary" || name == "label_intensity") return kU8;
+    if (name == "ue_total" || name == "attackers" || name == "run") return kU32;
+    if (name.compare(0, 6, "total_") == 0) return kU64;
+    return kF64;
+}
+
+inline bool ParseIpv4(const char *p, const char *end, uint32_t &out)
+{
+    uint32_t v = 0;
+    for (int octet = 0; octet < 4; ++octet)
+    {
+        uint32_t x = 0;
+        const char *start = p;
+        while (p < end && *p >= '0' && *p <= '9') x = x * 10 + (*p++ - '0');
+        if (p == start || x > 255) return false;
+        v = (v << 8) | x;
+        if (octet < 3 && (p >= end || *p++ != '.')) return false;
+    }
+    out = v;
+    return p == end;
+}
+
+// Scenario dimensions of one generator CSV, the partition key of the compacted corpus.
+// scenario_id is the --scenarioTag, which the batch runners build as
+// <ueTotal>_<mobile|static>_<udp|tcp>_<ddos|benign>_<low|med|high>_r<rep>. The file name
+// dataset_<tag>_ue<N>_<udp|tcp>_<ddos|benign>.csv carries the tag and the fixed dimensions,
+// so other tags still get ue_total, transport and attack ("unknown" mobility and intensity).
+struct ScenarioInfo
+{
+    std::string scenarioId;
+    uint32_t ueTotal = 0;
+    std::string mobility = "unknown";
+    std::string transport = "unknown";
+    std::string attack = "unknown";
+    std::string intensity = "unknown";
+    int rep = -1;
+
+    std::string Key() const
+    {
+        return "ue" + std::to_string(ueTotal) + "_" + mobility + "_" + transport + "_" + attack + "_" + intensity;
+    }
+};
+
+inline std::vector<std::string> SplitString(const std::string &s, char sep)
+{
+    std::vector<std::string> out;
+    size_t start = 0;
+    for (size_t i = 0; i <= s.size(); ++i)
+    {
+        if (i == s.size() || s[i] == sep)
+        {
+            out.emplace_back(s, start, i - start);
+            start = i + 1;
+        }
+    }
+    return out;
+}
+
+// False for names that are not a generator CSV (or are --distributed shards)
+inline bool ParseScenario(const std::string &path, ScenarioInfo &info)
+{
+    std::string name = path.substr(path.find_last_of('/') + 1);
+    if (name.compare(0, 8, "dataset_") != 0 || name.size() < 13 || name.compare(name.size() - 4, 4, ".csv") != 0)
+    {
+        return false;
+    }
+    if (name.find(".rank") != std::string::npos) return false;
+    name = name.substr(8, name.size() - 12);
+
+    size_t ue = name.rfind("_ue");
+    if (ue == std::string::npos) return false;
+    std::vector<std::string> suffix = SplitString(name.substr(ue + 3), '_');
+    if (suffix.size() != 3 || suffix[0].empty() || suffix[0].find_first_not_of("0123456789") != std::string::npos)
+    {
+        return false;
+    }
+    info = ScenarioInfo();
+    info.scenarioId = name.substr(0, ue);
+    info.ueTotal = static_cast<uint32_t>(std::stoul(suffix[0]));
+    info.transport = suffix[1];
+    info.attack = suffix[2];
+
+    std::vector<std::string> t = SplitString(info.scenarioId, '_');
+    if (t.size() == 6 && (t[1] == "mobile" || t[1] == "static") && t[3] == info.attack &&
+        (t[4] == "low" || t[4] == "med" || t[4] == "high") && t[5].size() > 1 && t[5][0] == 'r')
+    {
+        info.mobility = t[1];
+        info.intensity = t[4];
+        info.rep = std::atoi(t[5].c_str() + 1);
+    }
+    return true;
+}
+
+// Accumulates rows column by column and writes them as one shard
+class ShardWriter
+{
+  public:
+    void SetSchema(const std::vector<std::string> &names)
+    {
+        m_names = names;
+        m_types.clear();
+        for (const std::string &n : names) m_types.push_back(ShardTypeForColumn(n));
+        m_data.assign(names.size(), std::vector<uint8_t>());
+        m_rows = 0;
+    }
+
+    const std::vector<std::string> &GetNames() const { return m_names; }
+    uint32_t GetType(size_t col) const { return m_types[col]; }
+    uint64_t GetRows() const { return m_rows; }
+
+    uint64_t GetBytes() const
+    {
+        uint64_t b = 0;
+        for (const auto &d : m_data) b += d.size();
+        return b;
+    }
+
+    template <typename T>
+    void Append(size_t col, T v)
+    {
+        std::vector<uint8_t> &d = m_data[col];
+        size_t n = d.size();
+        d.resize(n + sizeof(T));
+        std::memcpy(d.data() + n, &v, sizeof(T));
+    }
+
+    // Appends a value given as text, converted to the column's type
+    bool AppendText(size_t col, const char *p, const char *end)
+    {
+        switch (m_types[col])
+        {
+        case kIpv4: {
+            uint32_t ip;
+            if (!ParseIpv4(p, end, ip)) return false;
+            Append(col, ip);
+            return true;
+        }
+        case kF64: {
+            char buf[64];
+            size_t n = std::min<size_t>(end - p, sizeof(buf) - 1);
+            std::memcpy(buf, p, n);
+            buf[n] = '\0';
+            char *stop;
+            double v = std::strtod(buf, &stop);
+            if (stop == buf) return false;
+            Append(col, v);
+            return true;
+        }
+        default: {
+            uint64_t v = 0;
+            const char *start = p;
+            while (p < end && *p >= '0' && *p <= '9') v = v * 10 + (*p++ - '0');
+            if (p == start || p != end) return false;
+            switch (m_types[col])
+            {
+            case kU8: Append(col, static_cast<uint8_t>(v)); break;
+            case kU16: Append(col, static_cast<uint16_t>(v)); break;
+            case kU32: Append(col, static_cast<uint32_t>(v)); break;
+            default: Append(col, v); break;
+            }
+            return true;
+        }
+        }
+    }
+
+    void EndRow() { m_rows++; }
+
+    // Drops the last rows down to 'rows' (a file that failed to parse part way)
+    void Truncate(uint64_t rows)
+    {
+        for (size_t c = 0; c < m_data.size(); ++c) m_data[c].resize(rows * ShardTypeSize(m_types[c]));
+        m_rows = rows;
+    }
+
+    // Writes the shard and fills 'entries' with the column directory; clears the rows
+    bool Write(const std::string &path, std::vector<ShardColumnEntry> &entries)
+    {
+        entries.assign(m_names.size(), ShardColumnEntry{});
+        uint64_t offset = sizeof(ShardFileHeader) + m_names.size() * sizeof(ShardColumnEntry);
+        for (size_t c = 0; c < m_names.size(); ++c)
+        {
+            offset = (offset + kShardAlign - 1) / kShardAlign * kShardAlign;
+            std::strncpy(entries[c].name, m_names[c].c_str(), sizeof(entries[c].name) - 1);
+            entries[c].type = m_types[c];
+            entries[c].offset = offset;
+            entries[c].bytes = m_data[c].size();
+            offset += m_data[c].size();
+        }
+
+        ShardFileHeader h{};
+        std::memcpy(h.magic, kShardMagic, 4);
+        h.version = kShardVersion;
+        h.rows = m_rows;
+        h.columns = static_cast<uint32_t>(m_names.size());
+        h.dataBytes = offset;
+
+        FILE *f = std::fopen(path.c_str(), "wb");
+        if (!f) return false;
+        bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1 &&
+                  std::fwrite(entries.data(), sizeof(ShardColumnEntry), entries.size(), f) == entries.size();
+        static const uint8_t zeros[kShardAlign] = {};
+        uint64_t pos = sizeof(h) + entries.size() * sizeof(ShardColumnEntry);
+        for (size_t c = 0; ok && c < m_names.size(); ++c)
+        {
+            ok = std::fwrite(zeros, 1, entries[c].offset - pos, f) == entries[c].offset - pos &&
+                 std::fwrite(m_data[c].data(), 1, m_data[c].size(), f) == m_data[c].size();
+            pos = entries[c].offset + m_data[c].size();
+        }
+        ok = std::fclose(f) == 0 && ok;
+        Truncate(0);
+        return ok;
+    }
+
+  private:
+    std::vector<std::string> m_names;
+    std::vector<uint32_t> m_types;
+    std::vector<std::vector<uint8_t>> m_data;
+    uint64_t m_rows = 0;
+};
+
+// Read-only memory map of a whole file
+class MappedFile
+{
+  public:
+    ~MappedFile() { Close(); }
+
+    bool Open(const std::string &path)
+    {
+        Close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (::fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        m_size = static_cast<size_t>(st.st_size);
+        if (m_size > 0)
+        {
+            void *p = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED)
+            {
+                ::close(fd);
+                return false;
+            }
+            m_data = static_cast<const char *>(p);
+            ::madvise(p, m_size, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+        return true;
+    }
+
+    void Close()
+    {
+        if (m_data) ::munmap(const_cast<char *>(m_data), m_size);
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    const char *Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+
+  private:
+    const char *m_data = nullptr;
+    size_t m_size = 0;
+};
+
+// Memory-mapped shard with typed column access
+class ShardReader
+{
+  public:
+    bool Open(const std::string &path)
+    {
+        if (!m_file.Open(path) || m_file.Size() < sizeof(ShardFileHeader)) return false;
+        std::memcpy(&m_header, m_file.Data(), sizeof(m_header));
+        if (std::memcmp(m_header.magic, kShardMagic, 4) != 0 || m_header.version != kShardVersion) return false;
+        if (m_file.Size() < sizeof(ShardFileHeader) + m_header.columns * sizeof(ShardColumnEntry)) return false;
+        m_columns.resize(m_header.columns);
+        std::memcpy(m_columns.data(), m_file.Data() + sizeof(ShardFileHeader),
+                    m_header.columns * sizeof(ShardColumnEntry));
+        for (const ShardColumnEntry &c : m_columns)
+        {
+            if (c.offset + c.bytes > m_file.Size()) return false;
+        }
+        return true;
+    }
+
+    uint64_t GetRows() const { return m_header.rows; }
+    const std::vector<ShardColumnEntry> &GetColumns() const { return m_columns; }
+
+    // Column index by name, or -1
+    int Find(const std::string &name) const
+    {
+        for (size_t i = 0; i < m_columns.size(); ++i)
+        {
+            if (name == m_columns[i].name) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    template <typename T>
+    const T *Column(size_t i) const
+    {
+        return reinterpret_cast<const T *>(m_file.Data() + m_columns[i].offset);
+    }
+
+    // Value of any numeric column as a double
+    double Get(size_t col, uint64_t row) const
+    {
+        const char *p = m_file.Data() + m_columns[col].offset;
+        switch (m_columns[col].type)
+        {
+        case kU8: return reinterpret_cast<const uint8_t *>(p)[row];
+        case kU16: return reinterpret_cast<const uint16_t *>(p)[row];
+        case kU32: case kIpv4: return reinterpret_cast<const uint32_t *>(p)[row];
+        case kU64: return static_cast<double>(reinterpret_cast<const uint64_t *>(p)[row]);
+        default: return reinterpret_cast<const double *>(p)[row];
+        }
+    }
+
+  private:
+    MappedFile m_file;
+    ShardFileHeader m_header{};
+    std::vector<ShardColumnEntry> m_columns;
+};
+
+#endif // DATASET_SHARD_H
@@ -0,0 +1,372 @@
+// dataset_split.cc - Scenario-stratified train/val/test split of whole runs
+// A row-level train_test_split puts windows of the same run on both sides, and the same
+// flows a few windows apart are near-duplicates. This assigns every run (one generator CSV, one
+// scenario_id) to exactly one split. Within each stratum (ue_total x mobility x transport x
+// attack x intensity, from the file name as in tools/dataset_compact) the runs are shuffled with
+// a seed derived from --seed and the stratum. Each split then gets its share by largest
+// remainder, with at least one run in val and test when the stratum has three or more. Nothing
+// is copied. --out gets train.txt, val.txt and test.txt (one CSV path per line) and split.json
+// with every run's split, rows and attack rows, and totals per split and stratum.
+//
+// The shuffle is a splitmix64 Fisher-Yates rather than std::shuffle, whose algorithm differs
+// between standard libraries, so a seed gives the same split everywhere. Adding or removing
+// runs in one stratum does not move runs in another.
+//
+// Build: g++ -O2 -std=c++17 -pthread -o dataset_split tools/dataset_split.cc
+// Usage: ./dataset_split --data=datasets --out=splits --train=0.7 --val=0.15 --test=0.15 --seed=42
+
+#include "dataset_shard.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Options
+{
+    std::string data = "datasets";
+    std::string out = "splits";
+    double train = 0.7;
+    double val = 0.15;
+    double test = 0.15;
+    uint64_t seed = 42;
+    uint32_t threads = std::max(1u, std::thread::hardware_concurrency());
+};
+
+static const char *kSplitNames[3] = {"train", "val", "test"};
+
+static bool ParseArg(const char *arg, const char *name, std::string &value)
+{
+    size_t n = std::strlen(name);
+    if (std::strncmp(arg, "--", 2) != 0 || std::strncmp(arg + 2, name, n) != 0 || arg[2 + n] != '=') return false;
+    value = arg + 3 + n;
+    return true;
+}
+
+static Options ParseOptions(int argc, char *argv[])
+{
+    Options o;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string v;
+        if (ParseArg(argv[i], "data", v)) o.data = v;
+        else if (ParseArg(argv[i], "out", v)) o.out = v;
+        else if (ParseArg(argv[i], "train", v)) o.train = std::stod(v);
+        else if (ParseArg(argv[i], "val", v)) o.val = std::stod(v);
+        else if (ParseArg(argv[i], "test", v)) o.test = std::stod(v);
+        else if (ParseArg(argv[i], "seed", v)) o.seed = std::stoull(v);
+        else if (ParseArg(argv[i], "threads", v)) o.threads = std::max(1ul, std::stoul(v));
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << "\n"
+                      << "Options: --data --out --train --val --test --seed --threads\n";
+            std::exit(1);
+        }
+    }
+    if (o.train < 0 || o.val < 0 || o.test < 0 || o.train + o.val + o.test <= 0)
+    {
+        std::cerr << "Split fractions must be non-negative and not all zero\n";
+        std::exit(1);
+    }
+    return o;
+}
+
+static uint64_t SplitMix64(uint64_t &state)
+{
+    uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+static uint64_t HashString(const std::string &s)
+{
+    uint64_t h = 0xcbf29ce484222325ull; // FNV-1a
+    for (char c : s) h = (h ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+    return h;
+}
+
+struct Run
+{
+    std::string path;
+    ScenarioInfo info;
+    std::string csvScenarioId; // from the first data row; empty for a header-only file
+    uint64_t foreignRows = 0;  // rows whose scenario_id differs from the first row's
+    uint64_t rows = 0;
+    uint64_t attackRows = 0;
+    int split = -1;
+    bool readable = true;
+};
+
+// Counts rows and label_binary = 1 rows, and checks that every row has the same scenario_id
+static void ScanRun(Run &run)
+{
+    MappedFile f;
+    if (!f.Open(run.path))
+    {
+        run.readable = false;
+        return;
+    }
+    const char *p = f.Data();
+    const char *end = p + f.Size();
+    const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+    std::string header(p, eol ? eol : end);
+    if (!header.empty() && header.back() == '\r') header.pop_back();
+    std::vector<std::string> cols = SplitString(header, ',');
+    size_t labelCol = std::find(cols.begin(), cols.end(), "label_binary") - cols.begin();
+    size_t idCol = std::find(cols.begin(), cols.end(), "scenario_id") - cols.begin();
+    if (labelCol == cols.size() || idCol == cols.size())
+    {
+        run.readable = false;
+        return;
+    }
+
+    for (p = eol ? eol + 1 : end; p < end;)
+    {
+        const char *nl = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        const char *le = nl ? nl : end;
+        if (le > p)
+        {
+            const char *field = p;
+            for (size_t col = 0; field < le; ++col)
+            {
+                const char *c = static_cast<const char *>(std::memchr(field, ',', le - field));
+                const char *fe = c ? c : le;
+                if (col == idCol)
+                {
+                    if (run.rows == 0) run.csvScenarioId.assign(field, fe);
+                    else if (run.csvScenarioId.compare(0, std::string::npos, field, fe - field) != 0) run.foreignRows++;
+                }
+                if (col == labelCol)
+                {
+                    run.attackRows += *field != '0';
+                    break;
+                }
+                if (!c) break;
+                field = c + 1;
+            }
+            run.rows++;
+        }
+        p = nl ? nl + 1 : end;
+    }
+}
+
+// Runs per split for a stratum of n: largest remainder, val and test non-empty when n >= 3
+static std::vector<size_t> Allocate(size_t n, const double frac[3])
+{
+    double total = frac[0] + frac[1] + frac[2];
+    std::vector<size_t> count(3);
+    std::vector<std::pair<double, int>> rem;
+    size_t used = 0;
+    for (int s = 0; s < 3; ++s)
+    {
+        double exact = n * frac[s] / total;
+        count[s] = static_cast<size_t>(std::floor(exact));
+        used += count[s];
+        rem.push_back({exact - count[s], s});
+    }
+    std::sort(rem.begin(), rem.end(), [](const std::pair<double, int> &a, const std::pair<double, int> &b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+    for (size_t i = 0; used < n; ++i, ++used) count[rem[i % 3].second]++;
+    if (n >= 3)
+    {
+        for (int s = 1; s < 3; ++s)
+        {
+            if (count[s] == 0 && frac[s] > 0 && count[0] > 1)
+            {
+                count[0]--;
+                count[s]++;
+            }
+        }
+    }
+    return count;
+}
+
+static std::string JsonEscape(const std::string &s)
+{
+    std::string out;
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+int main(int argc, char *argv[])
+{
+    Options o = ParseOptions(argc, argv);
+    auto wallStart = std::chrono::steady_clock::now();
+
+    std::vector<Run> runs;
+    for (const auto &e : std::filesystem::directory_iterator(o.data))
+    {
+        Run r;
+        if (e.is_regular_file() && ParseScenario(e.path().string(), r.info))
+        {
+            r.path = e.path().string();
+            runs.push_back(r);
+        }
+    }
+    std::sort(runs.begin(), runs.end(), [](const Run &a, const Run &b) { return a.path < b.path; });
+    if (runs.empty())
+    {
+        std::cerr << "No dataset_*.csv files in " << o.data << "\n";
+        return 1;
+    }
+
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> workers;
+    for (uint32_t t = 0; t < std::min<size_t>(o.threads, runs.size()); ++t)
+    {
+        workers.emplace_back([&]() {
+            for (size_t i; (i = next.fetch_add(1)) < runs.size();) ScanRun(runs[i]);
+        });
+    }
+    for (std::thread &t : workers) t.join();
+
+    // A run is its scenario_id; the file name and the rows must agree on it
+    std::map<std::string, size_t> byScenario;
+    size_t mismatched = 0;
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        const Run &r = runs[i];
+        if (r.foreignRows)
+        {
+            std::cerr << "Warning: " << r.path << " has " << r.foreignRows << " rows of other runs\n";
+            mismatched++;
+        }
+        else if (!r.csvScenarioId.empty() && r.csvScenarioId != r.info.scenarioId)
+        {
+            std::cerr << "Warning: " << r.path << " holds scenario_id " << r.csvScenarioId << "\n";
+            mismatched++;
+        }
+        if (!byScenario.emplace(r.info.scenarioId, i).second)
+        {
+            std::cerr << "Warning: scenario_id " << r.info.scenarioId << " is in more than one file: "
+                      << runs[byScenario[r.info.scenarioId]].path << ", " << r.path << "\n";
+        }
+    }
+
+    // Group by stratum; runs sharing a scenario_id are assigned together
+    std::map<std::string, std::vector<std::string>> strata;
+    for (const auto &e : byScenario) strata[runs[e.second].info.Key()].push_back(e.first);
+    std::map<std::string, int> splitOf;
+    const double frac[3] = {o.train, o.val, o.test};
+    for (auto &s : strata)
+    {
+        std::vector<std::string> &ids = s.second; // sorted, from the map
+        uint64_t state = o.seed ^ HashString(s.first);
+        for (size_t i = ids.size(); i > 1; --i) std::swap(ids[i - 1], ids[SplitMix64(state) % i]);
+        std::vector<size_t> count = Allocate(ids.size(), frac);
+        size_t k = 0;
+        for (int split = 0; split < 3; ++split)
+        {
+            for (size_t c = 0; c < count[split]; ++c) splitOf[ids[k++]] = split;
+        }
+    }
+    for (Run &r : runs) r.split = splitOf.at(r.info.scenarioId);
+
+    // Leakage check: every scenario_id in exactly one split, whether from a file name or its rows
+    std::map<std::string, std::set<int>> seen;
+    for (const Run &r : runs)
+    {
+        seen[r.info.scenarioId].insert(r.split);
+        if (!r.csvScenarioId.empty()) seen[r.csvScenarioId].insert(r.split);
+    }
+    size_t leaked = 0;
+    for (const Run &r : runs) leaked += r.foreignRows > 0; // rows of another run cannot be placed
+    for (const auto &e : seen)
+    {
+        if (e.second.size() > 1)
+        {
+            std::cerr << "Leak: scenario_id " << e.first << " is in " << e.second.size() << " splits\n";
+            leaked++;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(o.out, ec);
+    uint64_t splitRuns[3] = {}, splitRows[3] = {}, splitAttack[3] = {};
+    std::map<std::string, std::vector<uint64_t>> strataTotals; // per stratum: runs, rows, attack x 3 splits
+    bool ok = true;
+    for (int split = 0; split < 3; ++split)
+    {
+        std::ofstream list(o.out + "/" + kSplitNames[split] + ".txt");
+        for (const Run &r : runs)
+        {
+            if (r.split != split || !r.readable) continue;
+            list << r.path << "\n";
+            splitRuns[split]++;
+            splitRows[split] += r.rows;
+            splitAttack[split] += r.attackRows;
+            std::vector<uint64_t> &t = strataTotals[r.info.Key()];
+            t.resize(9);
+            t[split * 3] += 1;
+            t[split * 3 + 1] += r.rows;
+            t[split * 3 + 2] += r.attackRows;
+        }
+        ok &= static_cast<bool>(list);
+    }
+
+    std::ofstream js(o.out + "/split.json");
+    js << "{\n  \"seed\": " << o.seed << ",\n  \"fractions\": {\"train\": " << o.train << ", \"val\": " << o.val
+       << ", \"test\": " << o.test << "},\n  \"source\": \"" << JsonEscape(o.data) << "\",\n  \"totals\": {";
+    for (int split = 0; split < 3; ++split)
+    {
+        js << (split ? ", " : "") << "\"" << kSplitNames[split] << "\": {\"runs\": " << splitRuns[split]
+           << ", \"rows\": " << splitRows[split] << ", \"attack_rows\": " << splitAttack[split] << "}";
+    }
+    js << "},\n  \"strata\": {";
+    size_t n = 0;
+    for (const auto &e : strataTotals)
+    {
+        js << (n++ ? "," : "") << "\n    \"" << e.first << "\": {";
+        for (int split = 0; split < 3; ++split)
+        {
+            js << (split ? ", " : "") << "\"" << kSplitNames[split] << "\": {\"runs\": " << e.second[split * 3]
+               << ", \"rows\": " << e.second[split * 3 + 1] << ", \"attack_rows\": " << e.second[split * 3 + 2]
+               << "}";
+        }
+        js << "}";
+    }
+    js << "\n  },\n  \"runs\": [";
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        const Run &r = runs[i];
+        js << (i ? "," : "") << "\n    {\"scenario_id\": \"" << JsonEscape(r.info.scenarioId) << "\", \"path\": \""
+           << JsonEscape(r.path) << "\", \"partition\": \"" << r.info.Key() << "\", \"rep\": " << r.info.rep
+           << ", \"split\": \"" << kSplitNames[r.split] << "\", \"rows\": " << r.rows
+           << ", \"attack_rows\": " << r.attackRows << (r.readable ? "" : ", \"error\": \"unreadable\"") << "}";
+    }
+    js << "\n  ]\n}\n";
+    ok &= static_cast<bool>(js);
+    if (!ok)
+    {
+        std::cerr << "Failed writing split lists in " << o.out << "\n";
+        return 1;
+    }
+
+    double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    uint64_t totalRows = splitRows[0] + splitRows[1] + splitRows[2];
+    std::cout << "Split " << runs.size() << " runs in " << strata.size() << " strata (seed " << o.seed << ") in "
+              << wallS << " s\n";
+    for (int split = 0; split < 3; ++split)
+    {
+        std::cout << "  " << kSplitNames[split] << ": " << splitRuns[split] << " runs, " << splitRows[split]
+                  << " rows (" << (totalRows ? 100.0 * splitRows[split] / totalRows : 0.0) << " %), attack "
+                  << (splitRows[split] ? 100.0 * splitAttack[split] / splitRows[split] : 0.0) << " %\n";
+    }
+    std::cout << "  " << leaked << " scenario_ids in more than one split, " << mismatched
+              << " files whose rows disagree with the name; wrote " << o.out << "/{train,val,test}.txt, split.json\n";
+    return leaked ? 2 : 0;
+}
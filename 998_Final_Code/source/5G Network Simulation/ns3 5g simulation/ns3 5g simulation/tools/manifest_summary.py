@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""manifest_summary.py - Aggregate run manifests (*.manifest.json) across a sweep
+
+Each generator run writes <csv>.manifest.json (see run_manifest.h). This groups them by
+scenario dimensions and reports what a scenario class costs, so a full grid can be planned
+from a small sample sweep.
+
+Usage:
+  python3 tools/manifest_summary.py datasets/
+  python3 tools/manifest_summary.py datasets/ --by ue_total,transport --csv cost.csv
+  python3 tools/manifest_summary.py datasets/ --project 2640   # wall hours for N runs at the sampled mix
+"""
+
+import argparse
+import csv
+import glob
+import json
+import os
+import sys
+from collections import OrderedDict
+
+DEFAULT_BY = "generator,ue_total,mobility,transport,attack,attack_interval_s"
+
+COLUMNS = [
+    "runs", "wall_s", "setup_s", "run_s", "teardown_s", "wall_per_sim_s", "events_per_wall_s",
+    "sched_per_exec", "peak_rss_mb", "rows", "mb_written", "window_p99_us", "window_share",
+]
+
+
+def load(paths):
+    manifests = []
+    for p in paths:
+        files = glob.glob(os.path.join(p, "**", "*.manifest.json"), recursive=True) if os.path.isdir(p) else [p]
+        for f in sorted(files):
+            try:
+                with open(f) as fh:
+                    m = json.load(fh)
+            except (OSError, ValueError) as e:
+                print("skipping %s: %s" % (f, e), file=sys.stderr)
+                continue
+            m["_path"] = f
+            manifests.append(m)
+    return manifests
+
+
+def mean(values):
+    values = [v for v in values if v is not None]
+    return sum(values) / len(values) if values else 0.0
+
+
+def summarise(group):
+    wall = [m["wall_s"]["total"] for m in group]
+    run = [m["wall_s"]["run"] for m in group]
+    sim = [m["scenario"].get("sim_time_s", 0.0) for m in group]
+    executed = [m["events_executed"] for m in group]
+    scheduled = [m["events_scheduled"] for m in group if m["events_scheduled"] >= 0]
+    window_ms = [m["windows"]["total_ms"] for m in group]
+    return OrderedDict([
+        ("runs", len(group)),
+        ("wall_s", mean(wall)),
+        ("setup_s", mean(m["wall_s"]["setup"] for m in group)),
+        ("run_s", mean(run)),
+        ("teardown_s", mean(m["wall_s"]["teardown"] for m in group)),
+        ("wall_per_sim_s", sum(run) / sum(sim) if sum(sim) > 0 else 0.0),
+        ("events_per_wall_s", sum(executed) / sum(run) if sum(run) > 0 else 0.0),
+        ("sched_per_exec", sum(scheduled) / sum(executed) if scheduled and sum(executed) > 0 else None),
+        ("peak_rss_mb", max(m["peak_rss_kb"] for m in group) / 1024.0),
+        ("rows", mean(m["rows"] for m in group)),
+        ("mb_written", mean(m["bytes"] / 1e6 for m in group)),
+        ("window_p99_us", max(m["windows"]["p99_us"] for m in group)),
+        # Fraction of Simulator::Run spent in SampleAndWrite
+        ("window_share", sum(window_ms) / 1e3 / sum(run) if sum(run) > 0 else 0.0),
+    ])
+
+
+def fmt(v):
+    if v is None:
+        return "-"
+    if isinstance(v, float):
+        return "%.3g" % v if abs(v) < 1000 else "%.0f" % v
+    return str(v)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("paths", nargs="+", help="manifest files or directories to search recursively")
+    ap.add_argument("--by", default=DEFAULT_BY, help="comma-separated scenario keys to group by (default: %(default)s)")
+    ap.add_argument("--csv", help="also write the table to this CSV file")
+    ap.add_argument("--project", type=int, default=0, help="estimate wall hours for this many runs at the sampled mix")
+    args = ap.parse_args()
+
+    manifests = load(args.paths)
+    if not manifests:
+        print("no *.manifest.json found", file=sys.stderr)
+        return 1
+
+    keys = [k for k in args.by.split(",") if k]
+    groups = OrderedDict()
+    for m in sorted(manifests, key=lambda m: [str(m["scenario"].get(k, "")) for k in keys]):
+        groups.setdefault(tuple(m["scenario"].get(k, "") for k in keys), []).append(m)
+
+    rows = []
+    for gkey, group in groups.items():
+        rows.append(list(gkey) + [fmt(v) for v in summarise(group).values()])
+    header = keys + COLUMNS
+    widths = [max(len(str(r[i])) for r in rows + [header]) for i in range(len(header))]
+    for r in [header] + rows:
+        print("  ".join(str(c).rjust(w) for c, w in zip(r, widths)))
+
+    total = summarise(manifests)
+    print("\n%d runs, %.1f wall-s total, mean %.2f s/run, %.3f wall-s per sim-s, peak RSS %.0f MB, %.1f MB written"
+          % (total["runs"], sum(m["wall_s"]["total"] for m in manifests), total["wall_s"], total["wall_per_sim_s"],
+             total["peak_rss_mb"], sum(m["bytes"] for m in manifests) / 1e6))
+    if args.project > 0:
+        print("projected for %d runs: %.1f wall-h, %.1f GB" % (args.project, args.project * total["wall_s"] / 3600.0,
+                                                               args.project * total["mb_written"] / 1e3))
+
+    if args.csv:
+        with open(args.csv, "w", newline="") as fh:
+            w = csv.writer(fh)
+            w.writerow(header)
+            w.writerows(rows)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+"""merge_shards.py - Merge the per-rank CSV shards of a --distributed run
+
+simple_ddos_dataset --distributed writes one shard per MPI rank:
+dataset_X.rank0.csv, dataset_X.rank1.csv, ... A rank samples only the nodes it simulates, so a
+flow between UEs on different ranks appears in two shards: tx counts in the sender's shard,
+rx counts and delay in the receiver's. This merges them into dataset_X.csv in the serial format:
+
+  - total_bytes/pkts fwd/bwd are summed, and rates and packet_size are recomputed.
+  - delay_ms and jitter_ms are averaged, weighted by the shards' rx_pkts column (then dropped).
+  - label_binary is 1 if any shard labelled the row or the merged flow_pkts_per_sec > 5000, the
+    generator's rule; label_intensity follows it.
+
+Shards are written window by window, so the merge streams one window at a time. Rows in each
+window come out sorted by 5-tuple, so merges of the same run on any rank count compare equal.
+The rank manifests are combined into dataset_X.manifest.json: executed events are summed,
+rows and bytes are the merged CSV's, wall times, peak RSS and window times are the maximum over
+ranks, and "ranks" lists each rank's numbers.
+Shards and rank manifests are deleted afterwards unless --keep is given.
+
+Usage:
+  python3 tools/merge_shards.py datasets/dataset_big_ue10000_udp_ddos.csv
+  python3 tools/merge_shards.py datasets/ --keep     # every shard set found in the folder
+"""
+
+import argparse
+import csv
+import glob
+import json
+import os
+import re
+import sys
+from collections import OrderedDict
+
+ADDITIVE = ["total_bytes_fwd", "total_bytes_bwd", "total_pkts_fwd", "total_pkts_bwd", "rx_pkts"]
+KEY = ["src_ip", "dst_ip", "src_port", "dst_port", "protocol"]
+ATTACK_PKTS_PER_SEC = 5000.0  # same heuristic as WriteRow
+
+SHARD_RE = re.compile(r"^(.*)\.rank(\d+)\.csv$")
+
+
+def fmt(v):
+    # Matches the default std::ostream formatting of a double (6 significant digits)
+    return "%g" % v
+
+
+def ip_key(ip):
+    return tuple(int(p) for p in ip.split("."))
+
+
+def find_sets(paths):
+    """Maps merged CSV path -> shard paths ordered by rank."""
+    sets = OrderedDict()
+    for p in paths:
+        if os.path.isdir(p):
+            candidates = glob.glob(os.path.join(p, "*.rank*.csv"))
+        elif p.endswith(".csv") and not SHARD_RE.match(p):
+            candidates = glob.glob(glob.escape(p[:-4]) + ".rank*.csv")
+        else:
+            candidates = [p]
+        for c in candidates:
+            m = SHARD_RE.match(c)
+            if m:
+                sets.setdefault(m.group(1) + ".csv", []).append((int(m.group(2)), c))
+    return OrderedDict((k, [c for _, c in sorted(v)]) for k, v in sorted(sets.items()))
+
+
+class ShardReader:
+    """Yields (time_start, rows) one window at a time."""
+
+    def __init__(self, path):
+        self.fh = open(path, newline="")
+        self.reader = csv.reader(self.fh)
+        self.header = next(self.reader)
+        self.pending = next(self.reader, None)
+
+    def next_window(self):
+        if self.pending is None:
+            return None, []
+        t = self.pending[0]
+        rows = []
+        while self.pending is not None and self.pending[0] == t:
+            rows.append(self.pending)
+            self.pending = next(self.reader, None)
+        return t, rows
+
+    def peek_time(self):
+        return float(self.pending[0]) if self.pending is not None else None
+
+    def close(self):
+        self.fh.close()
+
+
+def merge_rows(rows, col):
+    if len(rows) == 1:
+        return rows[0]
+    out = list(rows[0])
+    sums = {c: sum(int(r[col[c]]) for r in rows) for c in ADDITIVE}
+    for c, v in sums.items():
+        out[col[c]] = str(v)
+
+    duration = float(out[col["flow_duration"]])
+    pkts = sums["total_pkts_fwd"] + sums["total_pkts_bwd"]
+    nbytes = sums["total_bytes_fwd"] + sums["total_bytes_bwd"]
+    flow_pps = sums["total_pkts_fwd"] / duration
+    out[col["pkts_per_sec"]] = fmt(pkts / duration)
+    out[col["bytes_per_sec"]] = fmt(nbytes / duration)
+    out[col["flow_pkts_per_sec"]] = fmt(flow_pps)
+    out[col["flow_bytes_per_sec"]] = fmt(sums["total_bytes_fwd"] / duration)
+    out[col["packet_size"]] = fmt(nbytes / pkts if pkts else 0.0)
+
+    rx = sums["rx_pkts"]
+    for c in ("delay_ms", "jitter_ms"):
+        out[col[c]] = fmt(sum(float(r[col[c]]) * int(r[col["rx_pkts"]]) for r in rows) / rx if rx else 0.0)
+
+    attack = any(r[col["label_binary"]] == "1" for r in rows) or flow_pps > ATTACK_PKTS_PER_SEC
+    out[col["label_binary"]] = "1" if attack else "0"
+    out[col["label_intensity"]] = "3" if attack else "0"
+    return out
+
+
+def merge_csv(target, shards):
+    readers = [ShardReader(s) for s in shards]
+    header = readers[0].header
+    for r in readers[1:]:
+        if r.header != header:
+            raise ValueError("%s: header differs from %s" % (r.fh.name, shards[0]))
+    if "rx_pkts" not in header:
+        raise ValueError("%s: no rx_pkts column, not a --distributed shard" % shards[0])
+    col = {name: i for i, name in enumerate(header)}
+    keep = [i for i, name in enumerate(header) if name != "rx_pkts"]
+    key_idx = [col[k] for k in KEY]
+
+    rows_out = 0
+    with open(target, "w", newline="") as fh:
+        fh.write(",".join(header[i] for i in keep) + "\n")
+        while True:
+            times = [r.peek_time() for r in readers if r.peek_time() is not None]
+            if not times:
+                break
+            t = min(times)
+            window = OrderedDict()
+            for r in readers:
+                if r.peek_time() != t:
+                    continue
+                _, rows = r.next_window()
+                for row in rows:
+                    window.setdefault(tuple(row[i] for i in key_idx), []).append(row)
+            order = sorted(window, key=lambda k: (ip_key(k[0]), ip_key(k[1]), int(k[2]), int(k[3]), int(k[4])))
+            for k in order:
+                merged = merge_rows(window[k], col)
+                fh.write(",".join(merged[i] for i in keep) + "\n")
+                rows_out += 1
+        size = fh.tell()
+    for r in readers:
+        r.close()
+    return rows_out, size
+
+
+def merge_manifests(target, shards, rows, size):
+    paths = [s[:-4] + ".manifest.json" for s in shards]
+    manifests = []
+    for p in paths:
+        if os.path.exists(p):
+            with open(p) as fh:
+                manifests.append(json.load(fh, object_pairs_hook=OrderedDict))
+    if not manifests:
+        return None, []
+    ranks = manifests[0]["scenario"].get("ranks")
+    if ranks is not None and ranks != len(shards):
+        print("warning: %s has %d shards but the run used %d ranks" % (target, len(shards), ranks), file=sys.stderr)
+
+    per_rank = [OrderedDict([("rank", x["scenario"].get("rank", i)), ("run_s", x["wall_s"]["run"]),
+                             ("events_executed", x["events_executed"]), ("rows", x["rows"]),
+                             ("peak_rss_kb", x["peak_rss_kb"])]) for i, x in enumerate(manifests)]
+    m = manifests[0]
+    m["scenario"].pop("rank", None)
+    m["events_executed"] = sum(x["events_executed"] for x in manifests)
+    m["events_scheduled"] = -1
+    for k in m["wall_s"]:
+        m["wall_s"][k] = max(x["wall_s"][k] for x in manifests)
+    m["peak_rss_kb"] = max(x["peak_rss_kb"] for x in manifests)
+    m["rows"] = rows
+    m["bytes"] = size
+    for k in ("total_ms", "p50_us", "p99_us", "max_us"):
+        m["windows"][k] = max(x["windows"][k] for x in manifests)
+    m["ranks"] = per_rank
+    out = target[:-4] + ".manifest.json"
+    with open(out, "w") as fh:
+        json.dump(m, fh, indent=2)
+    return out, paths
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("paths", nargs="+", help="merged CSV names, shard files or folders to search")
+    ap.add_argument("--keep", action="store_true", help="keep the shards and rank manifests")
+    args = ap.parse_args()
+
+    sets = find_sets(args.paths)
+    if not sets:
+        print("no *.rank<N>.csv shards found", file=sys.stderr)
+        return 1
+    for target, shards in sets.items():
+        rows, size = merge_csv(target, shards)
+        manifest, rank_manifests = merge_manifests(target, shards, rows, size)
+        print("%s: %d shards -> %d rows, %.1f MB%s" % (target, len(shards), rows, size / 1e6,
+                                                      ", " + manifest if manifest else ""))
+        if not args.keep:
+            for p in shards + [p for p in rank_manifests if os.path.exists(p)]:
+                os.remove(p)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""mpi_scaling.py - Speedup of a --distributed simple_ddos_dataset run per added MPI rank
+
+Runs the same seeded scenario under `mpirun -np K` for each K in --ranks, merges each run's
+shards (merge_shards.py) and reports, against the first rank count:
+
+  wall_s      wall time of the mpirun command (setup, run and teardown; not the merge)
+  run_s       slowest rank's Simulator::Run time
+  events      events executed, summed over ranks
+  speedup     run_s of the first rank count / run_s
+  efficiency  speedup per rank, relative to the first rank count
+  step_gain   speedup gained per rank added since the previous row
+  output      whether the merged CSV matches the first rank count's
+
+The output check is informational: every rank count builds the same topology from the same
+seed, but applications only exist on their own rank, so random streams can be numbered
+differently. All ranks run on this machine; --ranks above the core count oversubscribe.
+
+Usage (ns-3 configured with --enable-mpi, generator built):
+  python3 tools/mpi_scaling.py --ns3-dir ~/ns-3-dev --ue 10000 --ranks 1,2,4,8
+  python3 tools/mpi_scaling.py --ns3-dir ~/ns-3-dev --ue 10000 --hub-fanout 250 -- --useTcp=1
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import shlex
+import subprocess
+import sys
+import time
+from collections import OrderedDict
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import merge_shards  # noqa: E402
+
+
+def sha256(path):
+    h = hashlib.sha256()
+    with open(path, "rb") as fh:
+        for chunk in iter(lambda: fh.read(1 << 20), b""):
+            h.update(chunk)
+    return h.hexdigest()
+
+
+def run(args, np):
+    # Same tag (it is the scenario_id column) in one folder per rank count
+    tag = "mpi"
+    out_dir = os.path.join(args.out, "np%d" % np)
+    os.makedirs(out_dir, exist_ok=True)
+    binary = os.path.join(args.ns3_dir, args.binary)
+    cmd = shlex.split(args.mpirun) + ["-np", str(np), binary, "--distributed=1", "--ueTotal=%d" % args.ue,
+                                       "--hubFanout=%d" % args.hub_fanout, "--simTime=%g" % args.sim_time,
+                                       "--seed=%d" % args.seed, "--outPath=%s" % out_dir, "--scenarioTag=%s" % tag,
+                                       "--manifest=1"] + args.extra
+    t0 = time.monotonic()
+    proc = subprocess.run(cmd, cwd=args.ns3_dir, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+    wall = time.monotonic() - t0
+    if proc.returncode != 0:
+        sys.stderr.write(proc.stderr.decode(errors="replace")[-2000:])
+        raise RuntimeError("mpirun -np %d failed with exit code %d" % (np, proc.returncode))
+
+    sets = list(merge_shards.find_sets([out_dir]).items())
+    if len(sets) != 1:
+        raise RuntimeError("expected one shard set in %s, found %d" % (out_dir, len(sets)))
+    target, shards = sets[0]
+    if len(shards) != np:
+        raise RuntimeError("%s: %d shards for %d ranks" % (target, len(shards), np))
+    rows, size = merge_shards.merge_csv(target, shards)
+    manifest, rank_manifests = merge_shards.merge_manifests(target, shards, rows, size)
+    for p in shards + rank_manifests:
+        if os.path.exists(p):
+            os.remove(p)
+    with open(manifest) as fh:
+        m = json.load(fh)
+    return OrderedDict([("ranks", np), ("wall_s", wall), ("run_s", m["wall_s"]["run"]),
+                        ("events", m["events_executed"]), ("rows", rows), ("sha256", sha256(target)),
+                        ("rank_run_s", [r["run_s"] for r in m["ranks"]])])
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--ns3-dir", default=".", help="ns-3 tree the binary is run from (default: .)")
+    ap.add_argument("--binary", default="build/scratch/ns3-dev-simple_ddos_dataset-default",
+                    help="binary path relative to --ns3-dir (default: %(default)s)")
+    ap.add_argument("--mpirun", default="mpirun", help="MPI launcher and its options (default: %(default)s)")
+    ap.add_argument("--ranks", default="1,2,4,8", help="rank counts, first is the reference (default: %(default)s)")
+    ap.add_argument("--ue", type=int, default=10000)
+    ap.add_argument("--hub-fanout", type=int, default=0, help="UEs per aggregation hub (default: single hub)")
+    ap.add_argument("--sim-time", type=float, default=5.0, help="simTime in seconds (default: %(default)s)")
+    ap.add_argument("--seed", type=int, default=1)
+    ap.add_argument("--out", default="mpi_out", help="dataset output folder (default: %(default)s)")
+    ap.add_argument("--results", help="also write the table to this JSON file")
+    ap.add_argument("extra", nargs="*", help="further generator options, after --")
+    args = ap.parse_args()
+
+    args.out = os.path.abspath(args.out)
+    counts = [int(r) for r in args.ranks.split(",") if r]
+    if max(counts) > (os.cpu_count() or 1):
+        print("note: %d ranks on %d cores oversubscribes this machine" % (max(counts), os.cpu_count()))
+
+    print("%6s %9s %9s %12s %9s %11s %10s %8s" % ("ranks", "wall_s", "run_s", "events", "speedup", "efficiency",
+                                                  "step_gain", "output"))
+    results = []
+    for np in counts:
+        r = run(args, np)
+        base = results[0] if results else r
+        prev = results[-1] if results else None
+        r["speedup"] = base["run_s"] / r["run_s"] if r["run_s"] > 0 else 0.0
+        r["efficiency"] = r["speedup"] * base["ranks"] / np
+        r["step_gain"] = ((r["speedup"] - prev["speedup"]) / (np - prev["ranks"])
+                          if prev and np != prev["ranks"] else None)
+        r["same_output"] = r["sha256"] == base["sha256"]
+        results.append(r)
+        print("%6d %9.2f %9.2f %12d %9.2f %11.2f %10s %8s" % (
+            np, r["wall_s"], r["run_s"], r["events"], r["speedup"], r["efficiency"],
+            "-" if r["step_gain"] is None else "%+.2f" % r["step_gain"], "same" if r["same_output"] else "differs"))
+        sys.stdout.flush()
+
+    if args.results:
+        with open(args.results, "w") as fh:
+            json.dump(OrderedDict([("ue", args.ue), ("hub_fanout", args.hub_fanout), ("sim_time", args.sim_time),
+                                   ("seed", args.seed), ("extra", args.extra), ("runs", results)]), fh, indent=2)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,271 @@
+// sampler_bench.cc - Microbenchmark of the window sampler and CSV row encoder
+// Feeds synthetic FlowMonitor snapshots through the real FlowWindowSampler (Poll, per-flow
+// delta, Commit) and the generators' labelling and row encoding, without ns-3. The ns-3
+// types the sampler needs come from tools/bench_shim. Every known flow gets a row each
+// window, as in the generators, so --active only changes how many counters move.
+//
+// For each flow count, active fraction and sink it reports:
+//   cold_ms       first window (flow registration and key sort)
+//   ns/flow       steady-state window time divided by known flows
+//   allocs/win    heap allocations per steady-state window
+//   MB/s          CSV bytes encoded per second of sampling time
+//
+// Build: g++ -O2 -std=c++17 -Itools/bench_shim -o sampler_bench tools/sampler_bench.cc
+// Usage: ./sampler_bench --flows=1000,10000,100000,1000000 --active=0.01,0.1,1 --windows=10
+
+#include "../flow_window_sampler.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <set>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+// Every heap allocation in the process goes through here
+static uint64_t g_allocs = 0;
+
+void *operator new(size_t n)
+{
+    g_allocs++;
+    void *p = std::malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+// Discards output but counts it, so the null sink still pays for formatting
+class CountingBuf : public std::streambuf
+{
+  public:
+    uint64_t bytes = 0;
+
+  protected:
+    int overflow(int c) override
+    {
+        bytes++;
+        return c;
+    }
+
+    std::streamsize xsputn(const char *, std::streamsize n) override
+    {
+        bytes += n;
+        return n;
+    }
+};
+
+struct Options
+{
+    std::vector<uint32_t> flows = {1000, 10000, 100000, 1000000};
+    std::vector<double> active = {0.01, 0.1, 1.0};
+    std::vector<std::string> sinks = {"null", "file"};
+    uint32_t windows = 10;
+    std::string out = "sampler_bench.csv";
+};
+
+// Same context as the generators' globals
+struct RowContext
+{
+    double windowStart;
+    double timeEnd;
+    std::string scenarioId;
+    uint32_t ueTotal;
+    std::set<uint32_t> attackers; // source addresses of the attacking UEs
+};
+
+// Base columns of simple_ddos_dataset's WriteRow, with the same labelling and formatting
+static void WriteRow(std::ostream &out, const WindowRow &r, const RowContext &c)
+{
+    bool isAttacker = c.attackers.count(r.key.src.Get()) > 0;
+    bool attackBinary = isAttacker || (r.flowPktsPerSec > 5000.0);
+    int attackIntensity = attackBinary ? 3 : 0;
+
+    out << c.windowStart << "," << c.timeEnd << "," << c.scenarioId << "," << c.ueTotal << "," << c.attackers.size()
+        << ",";
+    out << r.key.src << "," << r.key.dst << "," << r.key.srcPort << "," << r.key.dstPort << ","
+        << unsigned(r.key.protocol) << "," << r.avgPktSize << ",";
+    out << r.duration << "," << r.totalBytesFwd << "," << r.totalBytesBwd << "," << r.totalPktsFwd << ","
+        << r.totalPktsBwd << ",";
+    out << r.pktsPerSec << "," << r.bytesPerSec << "," << r.flowPktsPerSec << "," << r.flowBytesPerSec << ",";
+    out << r.avgJitterMs << "," << r.avgDelayMs << "," << (attackBinary ? 1 : 0) << "," << attackIntensity;
+    out << "\n";
+}
+
+template <typename T>
+static std::vector<T> ParseList(const std::string &v)
+{
+    std::vector<T> out;
+    std::stringstream ss(v);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        std::stringstream is(item);
+        T x;
+        is >> x;
+        out.push_back(x);
+    }
+    return out;
+}
+
+static bool ParseArg(const char *arg, const char *name, std::string &value)
+{
+    size_t n = std::strlen(name);
+    if (std::strncmp(arg, "--", 2) != 0 || std::strncmp(arg + 2, name, n) != 0 || arg[2 + n] != '=') return false;
+    value = arg + 3 + n;
+    return true;
+}
+
+static Options ParseOptions(int argc, char *argv[])
+{
+    Options o;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string v;
+        if (ParseArg(argv[i], "flows", v)) o.flows = ParseList<uint32_t>(v);
+        else if (ParseArg(argv[i], "active", v)) o.active = ParseList<double>(v);
+        else if (ParseArg(argv[i], "sink", v)) o.sinks = ParseList<std::string>(v);
+        else if (ParseArg(argv[i], "windows", v)) o.windows = std::stoul(v);
+        else if (ParseArg(argv[i], "out", v)) o.out = v;
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << "\n"
+                      << "Options: --flows=1000,... --active=0.01,... --sink=null,file --windows --out\n";
+            std::exit(1);
+        }
+    }
+    if (o.windows < 2)
+    {
+        std::cerr << "windows must be at least 2 (the first one is reported separately)\n";
+        std::exit(1);
+    }
+    return o;
+}
+
+static const uint32_t kUeBase = (10u << 24) | (1u << 16); // 10.1.0.0
+
+// N flows between UEs and five servers; every fifth forward flow also has its reverse
+static void BuildFlows(uint32_t n, FlowMonitor &monitor, Ipv4FlowClassifier &classifier)
+{
+    const uint32_t base = kUeBase;
+    FlowMonitor::FlowStatsContainer &stats = monitor.GetMutableFlowStats();
+    uint32_t i = 0;
+    while (stats.size() < n)
+    {
+        Ipv4FlowClassifier::FiveTuple t;
+        t.sourceAddress = Ipv4Address(base + 256 + i);
+        t.destinationAddress = Ipv4Address(base + 1 + i % 5);
+        t.protocol = 17;
+        t.sourcePort = static_cast<uint16_t>(49153 + i % 16384);
+        t.destinationPort = static_cast<uint16_t>(1000 + i % 5);
+        stats[classifier.Add(t)];
+        if (i % 5 == 0 && stats.size() < n)
+        {
+            Ipv4FlowClassifier::FiveTuple r{t.destinationAddress, t.sourceAddress, t.protocol, t.destinationPort,
+                                            t.sourcePort};
+            stats[classifier.Add(r)];
+        }
+        i++;
+    }
+}
+
+// Advance the counters of the active flows as one window of traffic would
+static void Traffic(FlowMonitor &monitor, double active, uint32_t window)
+{
+    uint32_t threshold = static_cast<uint32_t>(active * 1000.0);
+    for (auto &kv : monitor.GetMutableFlowStats())
+    {
+        if ((kv.first * 2654435761u) % 1000 >= threshold) continue;
+        uint32_t pkts = 1 + (kv.first + window) % 200;
+        FlowMonitor::FlowStats &st = kv.second;
+        st.txPackets += pkts;
+        st.rxPackets += pkts - (pkts > 20 ? 1 : 0);
+        st.lostPackets += pkts > 20 ? 1 : 0;
+        st.txBytes += pkts * 512ull;
+        st.rxBytes += (pkts - (pkts > 20 ? 1 : 0)) * 512ull;
+        st.delaySum += Time(pkts * 0.004);
+        st.jitterSum += Time(pkts * 0.0003);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Options o = ParseOptions(argc, argv);
+
+    std::printf("%9s %7s %5s %9s %9s %11s %9s\n", "flows", "active", "sink", "cold_ms", "ns/flow", "allocs/win",
+                "MB/s");
+    for (uint32_t n : o.flows)
+    {
+        for (double active : o.active)
+        {
+            for (const std::string &sink : o.sinks)
+            {
+                FlowMonitor monitor;
+                Ipv4FlowClassifier classifier;
+                BuildFlows(n, monitor, classifier);
+
+                FlowWindowSampler sampler;
+                sampler.Setup(&monitor, &classifier);
+                RowContext ctx{0.0, 0.0, "bench", 50, {}};
+                for (uint32_t i = 250; i < 255; ++i) ctx.attackers.insert(kUeBase + 256 + i); // BuildFlows' UE i
+
+                CountingBuf nullBuf;
+                std::ostream nullOut(&nullBuf);
+                std::ofstream file;
+                if (sink == "file") file.open(o.out, std::ios::out | std::ios::trunc);
+                std::ostream &out = sink == "file" ? static_cast<std::ostream &>(file) : nullOut;
+
+                double coldMs = 0.0;
+                double steadyNs = 0.0;
+                uint64_t steadyAllocs = 0;
+                uint64_t steadyBytes = 0;
+                for (uint32_t w = 0; w < o.windows; ++w)
+                {
+                    Traffic(monitor, active, w);
+                    ctx.windowStart = w;
+                    ctx.timeEnd = w + 1;
+
+                    uint64_t bytesBefore = sink == "file" ? static_cast<uint64_t>(file.tellp()) : nullBuf.bytes;
+                    uint64_t allocsBefore = g_allocs;
+                    auto t0 = std::chrono::steady_clock::now();
+                    sampler.Sample(1.0, [&out, &ctx](const WindowRow &r) { WriteRow(out, r, ctx); });
+                    out.flush();
+                    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+                    uint64_t bytes = (sink == "file" ? static_cast<uint64_t>(file.tellp()) : nullBuf.bytes) - bytesBefore;
+
+                    if (w == 0)
+                    {
+                        coldMs = ns / 1e6;
+                        continue;
+                    }
+                    steadyNs += ns;
+                    steadyAllocs += g_allocs - allocsBefore;
+                    steadyBytes += bytes;
+                }
+
+                uint32_t steady = o.windows - 1;
+                std::printf("%9u %7.3g %5s %9.2f %9.1f %11.1f %9.1f\n", n, active, sink.c_str(), coldMs,
+                            steadyNs / steady / sampler.GetFlowCount(), double(steadyAllocs) / steady,
+                            steadyBytes / (steadyNs / 1e9) / 1e6);
+                std::fflush(stdout);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""sweep_bench.py - End-to-end throughput benchmark over one pass of the scenario grid
+
+Runs every ueTotal x mobile x useTcp x intensity cell once (attack on, fixed --seed) for each
+generator. It reads each run's manifest (run_manifest.h) and the CPU time of the child
+process, and reports per generator:
+
+  scenarios_per_hour    completed runs per wall-clock hour
+  sim_s_per_wall_s      simulated seconds per wall second
+  mb_per_cpu_hour       CSV output per CPU hour
+
+--baseline compares against a stored result and fails (exit 1) if any metric drops by more
+than --tolerance. --update-baseline writes the current result as the new baseline. Baselines
+only compare runs with the same grid, simTime, seed and machine label.
+
+Usage (generators built in the ns-3 tree):
+  python3 tools/sweep_bench.py --ns3-dir ~/ns-3-dev --baseline bench_baseline.json --update-baseline
+  python3 tools/sweep_bench.py --ns3-dir ~/ns-3-dev --baseline bench_baseline.json --tolerance 0.10
+"""
+
+import argparse
+import json
+import os
+import platform
+import resource
+import subprocess
+import sys
+import time
+from collections import OrderedDict
+
+UE_COUNTS = [10, 15, 25, 50]
+MOBILITY = [("mobile", 1), ("static", 0)]
+TRANSPORTS = [("udp", 0), ("tcp", 1)]
+INTENSITY = [("low", "0.0008"), ("med", "0.0004"), ("high", "0.00015")]
+
+METRICS = ["scenarios_per_hour", "sim_s_per_wall_s", "mb_per_cpu_hour"]
+
+
+def grid(ue_counts):
+    for ue in ue_counts:
+        for mode, mobile in MOBILITY:
+            for tp, use_tcp in TRANSPORTS:
+                for name, interval in INTENSITY:
+                    yield ue, mode, mobile, tp, use_tcp, name, interval
+
+
+def children_cpu_s():
+    ru = resource.getrusage(resource.RUSAGE_CHILDREN)
+    return ru.ru_utime + ru.ru_stime
+
+
+def run_one(args, generator, cell):
+    ue, mode, mobile, tp, use_tcp, name, interval = cell
+    tag = "bench_%s_%d_%s_%s_%s" % (generator, ue, mode, tp, name)
+    binary = os.path.join(args.ns3_dir, args.binary.format(generator=generator))
+    cmd = [binary, "--ueTotal=%d" % ue, "--mobile=%d" % mobile, "--useTcp=%d" % use_tcp, "--enableAttack=1",
+           "--attackInterval=%s" % interval, "--simTime=%g" % args.sim_time, "--window=1",
+           "--seed=%d" % args.seed, "--outPath=%s" % args.out, "--scenarioTag=%s" % tag, "--manifest=1"]
+    if args.dry_run:
+        print(" ".join(cmd))
+        return None
+
+    cpu0 = children_cpu_s()
+    t0 = time.monotonic()
+    proc = subprocess.run(cmd, cwd=args.ns3_dir, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+    wall = time.monotonic() - t0
+    cpu = children_cpu_s() - cpu0
+    if proc.returncode != 0:
+        sys.stderr.write(proc.stderr.decode(errors="replace")[-2000:])
+        raise RuntimeError("%s failed with exit code %d" % (tag, proc.returncode))
+
+    csv_path = os.path.join(args.out, "dataset_%s_ue%d_%s_ddos.csv" % (tag, ue, tp))
+    manifest_path = csv_path[:-4] + ".manifest.json"
+    size = os.path.getsize(csv_path) if os.path.exists(csv_path) else 0
+    events = None
+    if os.path.exists(manifest_path):
+        with open(manifest_path) as fh:
+            m = json.load(fh)
+        size = m["bytes"]
+        events = m["events_executed"]
+    return {"generator": generator, "tag": tag, "wall_s": wall, "cpu_s": cpu, "sim_s": args.sim_time,
+            "bytes": size, "events": events}
+
+
+def summarise(runs):
+    wall = sum(r["wall_s"] for r in runs)
+    cpu = sum(r["cpu_s"] for r in runs)
+    return OrderedDict([
+        ("runs", len(runs)),
+        ("wall_s", wall),
+        ("cpu_s", cpu),
+        ("scenarios_per_hour", len(runs) / (wall / 3600.0) if wall > 0 else 0.0),
+        ("sim_s_per_wall_s", sum(r["sim_s"] for r in runs) / wall if wall > 0 else 0.0),
+        ("mb_per_cpu_hour", sum(r["bytes"] for r in runs) / 1e6 / (cpu / 3600.0) if cpu > 0 else 0.0),
+    ])
+
+
+def compare(result, baseline, tolerance):
+    """Returns a list of failure messages; every metric is higher-is-better."""
+    if baseline.get("config") != result["config"]:
+        return ["baseline config differs: %s vs %s" % (json.dumps(baseline.get("config")), json.dumps(result["config"]))]
+    failures = []
+    for gen, metrics in result["generators"].items():
+        base = baseline.get("generators", {}).get(gen)
+        if base is None:
+            print("  %s: not in baseline, skipped" % gen)
+            continue
+        for k in METRICS:
+            ratio = metrics[k] / base[k] if base[k] > 0 else 1.0
+            status = "ok" if ratio >= 1.0 - tolerance else "FAIL"
+            print("  %-22s %-20s %12.2f vs %12.2f  %+6.1f%%  %s" % (gen, k, metrics[k], base[k], (ratio - 1) * 100,
+                                                                     status))
+            if status == "FAIL":
+                failures.append("%s %s dropped %.1f%%" % (gen, k, (1 - ratio) * 100))
+    return failures
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--ns3-dir", default=".", help="ns-3 tree the binaries are run from (default: .)")
+    ap.add_argument("--binary", default="build/scratch/ns3-dev-{generator}-default",
+                    help="binary path relative to --ns3-dir (default: %(default)s)")
+    ap.add_argument("--generators", default="simple_ddos_dataset,nr_ddos_dataset")
+    ap.add_argument("--ue", default=",".join(str(u) for u in UE_COUNTS), help="ueTotal values (default: %(default)s)")
+    ap.add_argument("--sim-time", type=float, default=5.0, help="simTime per run in seconds (default: %(default)s)")
+    ap.add_argument("--seed", type=int, default=1)
+    ap.add_argument("--out", default="bench_out", help="dataset output folder (default: %(default)s)")
+    ap.add_argument("--machine", default=platform.node(), help="label stored with the baseline (default: hostname)")
+    ap.add_argument("--baseline", help="baseline JSON to compare against")
+    ap.add_argument("--update-baseline", action="store_true", help="write this result to --baseline")
+    ap.add_argument("--tolerance", type=float, default=0.10, help="allowed relative drop (default: %(default)s)")
+    ap.add_argument("--results", help="also write this run's result JSON here")
+    ap.add_argument("--dry-run", action="store_true", help="print the commands only")
+    args = ap.parse_args()
+
+    args.out = os.path.abspath(args.out)
+    os.makedirs(args.out, exist_ok=True)
+    ue_counts = [int(u) for u in args.ue.split(",")]
+    generators = [g for g in args.generators.split(",") if g]
+
+    runs = []
+    for gen in generators:
+        for cell in grid(ue_counts):
+            r = run_one(args, gen, cell)
+            if r is None:
+                continue
+            runs.append(r)
+            print("%-48s %7.2f s wall %7.2f s cpu %8.2f MB" % (r["tag"], r["wall_s"], r["cpu_s"], r["bytes"] / 1e6))
+            sys.stdout.flush()
+    if args.dry_run:
+        return 0
+
+    result = OrderedDict([
+        ("config", OrderedDict([("ue", ue_counts), ("sim_time", args.sim_time), ("seed", args.seed),
+                                ("machine", args.machine)])),
+        ("generators", OrderedDict((g, summarise([r for r in runs if r["generator"] == g])) for g in generators)),
+        ("runs", runs),
+    ])
+
+    print("\n%-22s %6s %10s %20s %18s %17s" % ("generator", "runs", "wall_s", "scenarios_per_hour", "sim_s_per_wall_s",
+                                               "mb_per_cpu_hour"))
+    for gen, s in result["generators"].items():
+        print("%-22s %6d %10.1f %20.1f %18.3f %17.1f" % (gen, s["runs"], s["wall_s"], s["scenarios_per_hour"],
+                                                         s["sim_s_per_wall_s"], s["mb_per_cpu_hour"]))
+
+    if args.results:
+        with open(args.results, "w") as fh:
+            json.dump(result, fh, indent=2)
+
+    rc = 0
+    if args.baseline and args.update_baseline:
+        stored = OrderedDict((k, result[k]) for k in ("config", "generators"))
+        with open(args.baseline, "w") as fh:
+            json.dump(stored, fh, indent=2)
+        print("\nbaseline written to %s" % args.baseline)
+    elif args.baseline:
+        with open(args.baseline) as fh:
+            baseline = json.load(fh)
+        print("\ncomparison against %s (tolerance %.0f%%):" % (args.baseline, args.tolerance * 100))
+        failures = compare(result, baseline, args.tolerance)
+        if failures:
+            print("REGRESSION: " + "; ".join(failures))
+            rc = 1
+        else:
+            print("PASS")
+    return rc
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,175 @@
+// trajectory_gen.cc - Precompute random-walk UE trajectories into a .trj file
+// Reproduces the generators' RandomWalk2dMobilityModel setup (uniform start in the bounds,
+// speed U[speedMin, speedMax], a new direction every --distance metres, reflection at the
+// bounds) once, so repetitions and detectors can replay identical movement through
+// TrajectoryMobilityModel without per-UE course-change events.
+//
+// Build: g++ -O2 -std=c++17 -o trajectory_gen tools/trajectory_gen.cc
+// Usage: ./trajectory_gen --ues=50 --duration=20 --seed=1 --out=walk_50.trj
+
+#include "../trajectory_format.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Options
+{
+    uint32_t ues = 25;
+    double duration = 20.0;
+    uint64_t seed = 1;
+    double minX = 0.0;
+    double maxX = 100.0;
+    double minY = 0.0;
+    double maxY = 100.0;
+    double speedMin = 1.0;
+    double speedMax = 3.0;
+    double distance = 3.0;
+    std::string out = "trajectories.trj";
+};
+
+static bool ParseArg(const char *arg, const char *name, std::string &value)
+{
+    size_t n = std::strlen(name);
+    if (std::strncmp(arg, "--", 2) != 0 || std::strncmp(arg + 2, name, n) != 0 || arg[2 + n] != '=') return false;
+    value = arg + 3 + n;
+    return true;
+}
+
+static Options ParseOptions(int argc, char *argv[])
+{
+    Options o;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string v;
+        if (ParseArg(argv[i], "ues", v)) o.ues = std::stoul(v);
+        else if (ParseArg(argv[i], "duration", v)) o.duration = std::stod(v);
+        else if (ParseArg(argv[i], "seed", v)) o.seed = std::stoull(v);
+        else if (ParseArg(argv[i], "minX", v)) o.minX = std::stod(v);
+        else if (ParseArg(argv[i], "maxX", v)) o.maxX = std::stod(v);
+        else if (ParseArg(argv[i], "minY", v)) o.minY = std::stod(v);
+        else if (ParseArg(argv[i], "maxY", v)) o.maxY = std::stod(v);
+        else if (ParseArg(argv[i], "speedMin", v)) o.speedMin = std::stod(v);
+        else if (ParseArg(argv[i], "speedMax", v)) o.speedMax = std::stod(v);
+        else if (ParseArg(argv[i], "distance", v)) o.distance = std::stod(v);
+        else if (ParseArg(argv[i], "out", v)) o.out = v;
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << "\n"
+                      << "Options: --ues --duration --seed --minX --maxX --minY --maxY --speedMin --speedMax"
+                      << " --distance --out\n";
+            std::exit(1);
+        }
+    }
+    if (o.duration <= 0.0 || o.duration * 1e6 > 4294967295.0)
+    {
+        std::cerr << "duration must be in (0, 4294] seconds\n";
+        std::exit(1);
+    }
+    return o;
+}
+
+// One UE's walk: legs of 'distance' metres, split into sub-legs where the walk reflects
+static void Walk(const Options &o, std::mt19937_64 &rng, std::vector<TrajectoryWaypoint> &out)
+{
+    std::uniform_real_distribution<double> ux(o.minX, o.maxX);
+    std::uniform_real_distribution<double> uy(o.minY, o.maxY);
+    std::uniform_real_distribution<double> speed(o.speedMin, o.speedMax);
+    std::uniform_real_distribution<double> dir(0.0, 2.0 * M_PI);
+
+    double t = 0.0;
+    double x = ux(rng);
+    double y = uy(rng);
+    out.push_back({0, static_cast<float>(x), static_cast<float>(y)});
+
+    while (t < o.duration)
+    {
+        double v = speed(rng);
+        double a = dir(rng);
+        double vx = v * std::cos(a);
+        double vy = v * std::sin(a);
+        double left = o.distance / v; // seconds left on this leg
+
+        while (left > 1e-9 && t < o.duration)
+        {
+            // Time until the leg hits a wall, if it does
+            double hit = left;
+            if (vx > 0) hit = std::min(hit, (o.maxX - x) / vx);
+            if (vx < 0) hit = std::min(hit, (o.minX - x) / vx);
+            if (vy > 0) hit = std::min(hit, (o.maxY - y) / vy);
+            if (vy < 0) hit = std::min(hit, (o.minY - y) / vy);
+            hit = std::max(hit, 0.0);
+            hit = std::min(hit, o.duration - t);
+
+            x += vx * hit;
+            y += vy * hit;
+            t += hit;
+            left -= hit;
+            out.push_back({static_cast<uint32_t>(std::llround(t * 1e6)), static_cast<float>(x), static_cast<float>(y)});
+
+            // Reflect off whichever wall was reached
+            if (left > 1e-9)
+            {
+                if (x >= o.maxX - 1e-9 || x <= o.minX + 1e-9) vx = -vx;
+                if (y >= o.maxY - 1e-9 || y <= o.minY + 1e-9) vy = -vy;
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Options o = ParseOptions(argc, argv);
+
+    std::vector<TrajectoryIndexEntry> index(o.ues);
+    std::vector<TrajectoryWaypoint> waypoints;
+    waypoints.reserve(static_cast<size_t>(o.ues) * (o.duration * o.speedMax / o.distance + 8));
+
+    for (uint32_t i = 0; i < o.ues; ++i)
+    {
+        // One stream per UE so UE i's walk does not depend on how many UEs are generated
+        std::mt19937_64 rng(o.seed * 1000003ULL + i);
+        index[i].first = waypoints.size();
+        Walk(o, rng, waypoints);
+        index[i].count = static_cast<uint32_t>(waypoints.size() - index[i].first);
+        index[i].reserved = 0;
+    }
+
+    TrajectoryFileHeader h{};
+    std::memcpy(h.magic, kTrajectoryMagic, 4);
+    h.version = kTrajectoryVersion;
+    h.ueCount = o.ues;
+    h.seed = o.seed;
+    h.totalWaypoints = waypoints.size();
+    h.duration = o.duration;
+    h.minX = o.minX;
+    h.maxX = o.maxX;
+    h.minY = o.minY;
+    h.maxY = o.maxY;
+
+    FILE *f = std::fopen(o.out.c_str(), "wb");
+    if (!f)
+    {
+        std::perror(o.out.c_str());
+        return 1;
+    }
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1 &&
+              std::fwrite(index.data(), sizeof(TrajectoryIndexEntry), index.size(), f) == index.size() &&
+              std::fwrite(waypoints.data(), sizeof(TrajectoryWaypoint), waypoints.size(), f) == waypoints.size();
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok)
+    {
+        std::cerr << "Failed writing " << o.out << "\n";
+        return 1;
+    }
+
+    size_t bytes = sizeof(h) + index.size() * sizeof(TrajectoryIndexEntry) + waypoints.size() * sizeof(TrajectoryWaypoint);
+    std::cout << "Wrote " << o.out << ": " << o.ues << " UEs, " << waypoints.size() << " waypoints, " << bytes
+              << " bytes\n";
+    return 0;
+}
@@ -0,0 +1,333 @@
+// window_stream_bench.cc - Size and throughput of the .dws window stream on the CSV corpus
+// Parses every datasets/*.csv once, then for each codec encodes each run into its own
+// in-memory stream (as a generator run with --output=dws would), decodes it back, and formats
+// the decoded rows as CSV. Reports stored size against the CSV and encode/decode throughput in
+// CSV-equivalent MB/s, and checks that every run converts back to its original CSV byte for byte.
+//
+// Build: g++ -O2 -std=c++17 -o window_stream_bench tools/window_stream_bench.cc
+//        (add -DDWS_WITH_ZSTD -DDWS_WITH_LZ4 ... -lzstd -llz4 to measure the compressed codecs)
+// Usage: ./window_stream_bench --data=datasets --codecs=raw,lz4,zstd --level=3 --blockRows=65536
+
+#include "../window_stream.h"
+#include "dataset_shard.h"
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct Options
+{
+    std::string data = "datasets";
+    std::string codecs; // empty = every codec compiled in
+    int level = 3;
+    uint32_t blockRows = 65536;
+    uint32_t repeat = 3; // timed passes per codec; the fastest is reported
+};
+
+static bool ParseArg(const char *arg, const char *name, std::string &value)
+{
+    size_t n = std::strlen(name);
+    if (std::strncmp(arg, "--", 2) != 0 || std::strncmp(arg + 2, name, n) != 0 || arg[2 + n] != '=') return false;
+    value = arg + 3 + n;
+    return true;
+}
+
+static Options ParseOptions(int argc, char *argv[])
+{
+    Options o;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string v;
+        if (ParseArg(argv[i], "data", v)) o.data = v;
+        else if (ParseArg(argv[i], "codecs", v)) o.codecs = v;
+        else if (ParseArg(argv[i], "level", v)) o.level = std::stoi(v);
+        else if (ParseArg(argv[i], "blockRows", v)) o.blockRows = std::max(1ul, std::stoul(v));
+        else if (ParseArg(argv[i], "repeat", v)) o.repeat = std::max(1ul, std::stoul(v));
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << "\n"
+                      << "Options: --data --codecs --level --blockRows --repeat\n";
+            std::exit(1);
+        }
+    }
+    return o;
+}
+
+// One generator CSV, parsed into what BeginRow()/Int()/Float() take
+struct Run
+{
+    std::string csv;
+    std::vector<WindowStreamColumn> columns;
+    std::vector<uint8_t> kinds; // value column kinds, in order
+    size_t rows = 0;
+    std::vector<double> times;     // rows x 2
+    std::vector<uint32_t> keys;    // rows x 5: src, dst, src port, dst port, protocol
+    std::vector<uint64_t> values;  // rows x kinds: int64 or double bits
+};
+
+static bool ParseRun(const std::string &path, Run &run, std::string &error)
+{
+    MappedFile f;
+    if (!f.Open(path))
+    {
+        error = "cannot open";
+        return false;
+    }
+    run.csv.assign(f.Data(), f.Size());
+    std::istringstream lines(run.csv);
+    std::string line;
+    std::getline(lines, line);
+    std::vector<std::string> names = SplitString(line, ',');
+
+    // scenario_id, ue_total and attackers are per-run constants; take them from the first row
+    std::vector<std::string> first;
+    std::streampos body = lines.tellg();
+    if (std::getline(lines, line)) first = SplitString(line, ',');
+    std::map<std::string, std::string> consts;
+    for (size_t i = 0; i < names.size() && i < first.size(); ++i)
+    {
+        if (names[i] == "scenario_id" || names[i] == "ue_total" || names[i] == "attackers") consts[names[i]] = first[i];
+    }
+    run.columns = WindowStreamColumns(names, consts);
+    for (const WindowStreamColumn &c : run.columns)
+    {
+        if (WindowStreamIsValue(c.kind)) run.kinds.push_back(c.kind);
+    }
+
+    lines.clear();
+    lines.seekg(body);
+    while (std::getline(lines, line))
+    {
+        std::vector<std::string> cells = SplitString(line, ',');
+        if (cells.size() != run.columns.size())
+        {
+            error = "row " + std::to_string(run.rows + 1) + " has " + std::to_string(cells.size()) + " columns";
+            return false;
+        }
+        uint32_t key[5] = {0, 0, 0, 0, 0};
+        double t[2] = {0.0, 0.0};
+        for (size_t i = 0; i < cells.size(); ++i)
+        {
+            const std::string &s = cells[i];
+            const WindowStreamColumn &c = run.columns[i];
+            char *end = nullptr;
+            switch (c.kind)
+            {
+            case kDwsTimeStart: t[0] = std::strtod(s.c_str(), &end); break;
+            case kDwsTimeEnd: t[1] = std::strtod(s.c_str(), &end); break;
+            case kDwsConst:
+                if (s != c.value)
+                {
+                    error = c.name + " changes within the run";
+                    return false;
+                }
+                end = const_cast<char *>(s.c_str() + s.size());
+                break;
+            case kDwsSrcIp:
+            case kDwsDstIp:
+                if (ParseIpv4(s.data(), s.data() + s.size(), key[c.kind - kDwsSrcIp]))
+                {
+                    end = const_cast<char *>(s.c_str() + s.size());
+                }
+                break;
+            case kDwsSrcPort:
+            case kDwsDstPort:
+            case kDwsProtocol: key[c.kind - kDwsSrcIp] = std::strtoul(s.c_str(), &end, 10); break;
+            case kDwsUint: run.values.push_back(std::strtoull(s.c_str(), &end, 10)); break;
+            case kDwsInt: run.values.push_back(static_cast<uint64_t>(std::strtoll(s.c_str(), &end, 10))); break;
+            default:
+            {
+                double v = std::strtod(s.c_str(), &end);
+                uint64_t bits;
+                std::memcpy(&bits, &v, 8);
+                run.values.push_back(bits);
+            }
+            }
+            if (s.empty() || end != s.c_str() + s.size())
+            {
+                error = "row " + std::to_string(run.rows + 1) + ": cannot parse " + c.name + "=" + s;
+                return false;
+            }
+        }
+        run.times.insert(run.times.end(), t, t + 2);
+        run.keys.insert(run.keys.end(), key, key + 5);
+        run.rows++;
+    }
+    return true;
+}
+
+static std::string Encode(const Run &run, uint8_t codec, const Options &o)
+{
+    std::ostringstream out;
+    WindowStreamWriter w;
+    w.Attach(&out, run.columns, codec, o.level, o.blockRows);
+    const size_t nv = run.kinds.size();
+    for (size_t r = 0; r < run.rows; ++r)
+    {
+        const uint32_t *k = &run.keys[r * 5];
+        w.BeginRow(run.times[r * 2], run.times[r * 2 + 1], k[0], k[1], static_cast<uint16_t>(k[2]),
+                   static_cast<uint16_t>(k[3]), static_cast<uint8_t>(k[4]));
+        const uint64_t *v = &run.values[r * nv];
+        for (size_t i = 0; i < nv; ++i)
+        {
+            if (run.kinds[i] != kDwsFloat)
+            {
+                w.Int(static_cast<int64_t>(v[i]));
+            }
+            else
+            {
+                double d;
+                std::memcpy(&d, &v[i], 8);
+                w.Float(d);
+            }
+        }
+        w.EndRow();
+    }
+    w.Close();
+    return out.str();
+}
+
+// Decodes a stream; with csv set, also formats it. Returns rows, or -1 on a decode error.
+static int64_t Decode(const std::string &stream, std::string *csv, uint64_t &checksum)
+{
+    std::istringstream in(stream);
+    WindowStreamReader reader;
+    if (!reader.Attach(&in)) return -1;
+    WindowStreamCsv format(reader.GetColumns());
+    if (csv) format.AppendHeader(*csv);
+    size_t nv = 0;
+    for (const WindowStreamColumn &c : reader.GetColumns()) nv += WindowStreamIsValue(c.kind);
+    WindowStreamRow row;
+    int64_t rows = 0;
+    while (reader.Next(row))
+    {
+        if (csv) format.AppendRow(row, *csv);
+        else
+        {
+            checksum += row.src ^ row.dstPort;
+            for (size_t i = 0; i < nv; ++i) checksum += row.values[i];
+        }
+        rows++;
+    }
+    return reader.Failed() ? -1 : rows;
+}
+
+static volatile uint64_t g_checksum; // keeps the decode-only pass from being optimised away
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+    Options o = ParseOptions(argc, argv);
+
+    std::vector<std::string> paths;
+    for (const auto &e : std::filesystem::directory_iterator(o.data))
+    {
+        ScenarioInfo info;
+        if (e.is_regular_file() && ParseScenario(e.path().string(), info)) paths.push_back(e.path().string());
+    }
+    std::sort(paths.begin(), paths.end());
+    if (paths.empty())
+    {
+        std::cerr << "No dataset_*.csv files in " << o.data << "\n";
+        return 1;
+    }
+
+    std::vector<uint8_t> codecs;
+    if (o.codecs.empty())
+    {
+        for (uint8_t c : {kDwsRaw, kDwsLz4, kDwsZstd})
+        {
+            if (WindowStreamCodecAvailable(c)) codecs.push_back(c);
+        }
+    }
+    else
+    {
+        for (const std::string &name : SplitString(o.codecs, ','))
+        {
+            uint8_t c;
+            if (!WindowStreamParseCodec(name, c))
+            {
+                std::cerr << "Codec " << name << " is unknown or not compiled in (-DDWS_WITH_ZSTD, -DDWS_WITH_LZ4)\n";
+                return 1;
+            }
+            codecs.push_back(c);
+        }
+    }
+
+    std::vector<Run> runs;
+    runs.reserve(paths.size());
+    uint64_t csvBytes = 0;
+    uint64_t rows = 0;
+    for (const std::string &path : paths)
+    {
+        Run run;
+        std::string error;
+        if (!ParseRun(path, run, error))
+        {
+            std::cerr << "Skipping " << path << ": " << error << "\n";
+            continue;
+        }
+        csvBytes += run.csv.size();
+        rows += run.rows;
+        runs.push_back(std::move(run));
+    }
+    std::cout << "Corpus: runs=" << runs.size() << " rows=" << rows << " csvMB=" << csvBytes / 1e6
+              << " blockRows=" << o.blockRows << "\n";
+
+    bool allExact = true;
+    uint64_t checksum = 0;
+    for (uint8_t codec : codecs)
+    {
+        std::vector<std::string> streams(runs.size());
+        double encodeS = 1e30;
+        double decodeS = 1e30;
+        double csvS = 1e30;
+        for (uint32_t pass = 0; pass < o.repeat; ++pass)
+        {
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < runs.size(); ++i) streams[i] = Encode(runs[i], codec, o);
+            encodeS = std::min(encodeS, Seconds(start));
+
+            start = std::chrono::steady_clock::now();
+            for (const std::string &s : streams) Decode(s, nullptr, checksum);
+            decodeS = std::min(decodeS, Seconds(start));
+
+            std::string csv;
+            start = std::chrono::steady_clock::now();
+            for (const std::string &s : streams)
+            {
+                csv.clear();
+                Decode(s, &csv, checksum);
+            }
+            csvS = std::min(csvS, Seconds(start));
+        }
+
+        // Round trip: decoded CSV must equal the input file
+        uint64_t bytes = 0;
+        uint64_t mismatched = 0;
+        for (size_t i = 0; i < runs.size(); ++i)
+        {
+            bytes += streams[i].size();
+            std::string csv;
+            if (Decode(streams[i], &csv, checksum) != int64_t(runs[i].rows) || csv != runs[i].csv)
+            {
+                if (mismatched++ == 0) std::cerr << "First round-trip mismatch: " << paths[i] << "\n";
+            }
+        }
+        allExact &= mismatched == 0;
+        std::cout << "Codec " << WindowStreamCodecName(codec) << ": MB=" << bytes / 1e6
+                  << " ratio=" << double(csvBytes) / bytes << " bytesPerRow=" << double(bytes) / rows
+                  << " encodeMBps=" << csvBytes / 1e6 / encodeS << " decodeMBps=" << csvBytes / 1e6 / decodeS
+                  << " toCsvMBps=" << csvBytes / 1e6 / csvS << " roundTrip="
+                  << (mismatched ? std::to_string(mismatched) + " runs differ" : std::string("exact")) << "\n";
+    }
+    g_checksum = checksum;
+    return allExact ? 0 : 2;
+}
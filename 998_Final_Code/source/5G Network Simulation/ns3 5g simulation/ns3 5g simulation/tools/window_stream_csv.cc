@@ -0,0 +1,122 @@
+// window_stream_csv.cc - Convert .dws window streams back to the generators' CSV
+// A run written with --output=dws becomes the same dataset_X.csv it would have written with
+// --output=csv, byte for byte, so every CSV tool and notebook keeps working. The stream is
+// decoded block by block; memory stays at one block however long the run was.
+//
+// Build: g++ -O2 -std=c++17 -o window_stream_csv tools/window_stream_csv.cc
+//        (add -DDWS_WITH_ZSTD -DDWS_WITH_LZ4 ... -lzstd -llz4 for compressed streams)
+// Usage: ./window_stream_csv datasets/dataset_X.dws [more.dws ...]   writes dataset_X.csv beside each
+//        ./window_stream_csv --out=- datasets/dataset_X.dws            one stream to stdout
+
+#include "../window_stream.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct Options
+{
+    std::string out; // empty = <input without .dws>.csv, "-" = stdout (one input only)
+    std::vector<std::string> inputs;
+};
+
+static bool ParseArg(const char *arg, const char *name, std::string &value)
+{
+    size_t n = std::strlen(name);
+    if (std::strncmp(arg, "--", 2) != 0 || std::strncmp(arg + 2, name, n) != 0 || arg[2 + n] != '=') return false;
+    value = arg + 3 + n;
+    return true;
+}
+
+static Options ParseOptions(int argc, char *argv[])
+{
+    Options o;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string v;
+        if (ParseArg(argv[i], "out", v)) o.out = v;
+        else if (std::strncmp(argv[i], "--", 2) != 0) o.inputs.push_back(argv[i]);
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << "\n"
+                      << "Options: --out, then one or more .dws files\n";
+            std::exit(1);
+        }
+    }
+    if (o.inputs.empty() || (!o.out.empty() && o.inputs.size() > 1))
+    {
+        std::cerr << "Usage: window_stream_csv [--out=file.csv|-] run.dws (--out takes a single input)\n";
+        std::exit(1);
+    }
+    return o;
+}
+
+static bool Convert(const std::string &in, const std::string &out, uint64_t &rows, uint64_t &bytes)
+{
+    WindowStreamReader reader;
+    if (!reader.Open(in))
+    {
+        std::cerr << in << ": " << reader.GetError() << "\n";
+        return false;
+    }
+    FILE *f = out == "-" ? stdout : std::fopen(out.c_str(), "wb");
+    if (!f)
+    {
+        std::cerr << "Could not write " << out << "\n";
+        return false;
+    }
+
+    WindowStreamCsv format(reader.GetColumns());
+    std::string buf;
+    format.AppendHeader(buf);
+    WindowStreamRow row;
+    bool ok = true;
+    while (reader.Next(row))
+    {
+        format.AppendRow(row, buf);
+        if (buf.size() >= (1 << 20))
+        {
+            ok &= std::fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+            bytes += buf.size();
+            buf.clear();
+        }
+    }
+    ok &= std::fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+    bytes += buf.size();
+    ok &= (f == stdout ? std::fflush(f) : std::fclose(f)) == 0;
+    rows += reader.GetRows();
+    if (reader.Failed())
+    {
+        std::cerr << in << ": " << reader.GetError() << " after " << reader.GetRows() << " rows\n";
+        return false;
+    }
+    if (!ok) std::cerr << "Could not write " << out << "\n";
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    Options o = ParseOptions(argc, argv);
+    auto start = std::chrono::steady_clock::now();
+    uint64_t rows = 0;
+    uint64_t bytes = 0;
+    int failed = 0;
+    for (const std::string &in : o.inputs)
+    {
+        std::string out = o.out;
+        if (out.empty())
+        {
+            bool dws = in.size() > 4 && in.compare(in.size() - 4, 4, ".dws") == 0;
+            out = (dws ? in.substr(0, in.size() - 4) : in) + ".csv";
+        }
+        failed += !Convert(in, out, rows, bytes);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    // Summary on stderr so --out=- leaves stdout as pure CSV
+    std::cerr << "Converted " << o.inputs.size() - failed << "/" << o.inputs.size() << " streams: rows=" << rows
+              << " csvMB=" << bytes / 1e6 << " seconds=" << seconds << " csvMBps=" << bytes / 1e6 / seconds << "\n";
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,58 @@
+// trajectory_format.h - On-disk layout of precomputed UE trajectory files (.trj)
+// Written by tools/trajectory_gen.cc and read (memory-mapped) by trajectory_mobility.h.
+// No ns-3 dependency, so the generator builds with a plain C++ compiler.
+//
+// Layout, little-endian, no padding between sections:
+//   TrajectoryFileHeader
+//   TrajectoryIndexEntry[ueCount]       first waypoint and waypoint count per UE
+//   TrajectoryWaypoint[totalWaypoints]  per-UE runs, each sorted by time
+// Between two waypoints a UE moves in a straight line at constant speed; before the first
+// it sits at the first, after the last it sits at the last (WaypointMobilityModel semantics).
+
+#ifndef TRAJECTORY_FORMAT_H
+#define TRAJECTORY_FORMAT_H
+
+#include <cstdint>
+
+#pragma pack(push, 1)
+
+struct TrajectoryFileHeader
+{
+    char magic[4];       // "TRJ1"
+    uint32_t version;    // 1
+    uint32_t ueCount;
+    uint32_t reserved;
+    uint64_t seed;       // generator seed, for provenance
+    uint64_t totalWaypoints;
+    double duration;     // seconds covered by every UE
+    double minX;         // bounds the walk was generated in (m)
+    double maxX;
+    double minY;
+    double maxY;
+};
+
+struct TrajectoryIndexEntry
+{
+    uint64_t first; // index into the waypoint array
+    uint32_t count;
+    uint32_t reserved;
+};
+
+// 12 bytes: time in microseconds (up to ~71 minutes), position in metres (z = 0)
+struct TrajectoryWaypoint
+{
+    uint32_t timeUs;
+    float x;
+    float y;
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(TrajectoryFileHeader) == 72, "TrajectoryFileHeader layout changed");
+static_assert(sizeof(TrajectoryIndexEntry) == 16, "TrajectoryIndexEntry layout changed");
+static_assert(sizeof(TrajectoryWaypoint) == 12, "TrajectoryWaypoint layout changed");
+
+static const char kTrajectoryMagic[4] = {'T', 'R', 'J', '1'};
+static const uint32_t kTrajectoryVersion = 1;
+
+#endif // TRAJECTORY_FORMAT_H
@@ -0,0 +1,206 @@
+// trajectory_mobility.h - Mobility model that replays a precomputed .trj trajectory file
+// The file (see trajectory_format.h, written by tools/trajectory_gen) is memory-mapped once
+// per path and shared by every UE. Positions are interpolated lazily when someone asks for
+// them, with the same straight-line-between-waypoints semantics as WaypointMobilityModel,
+// but no events are scheduled: the model only advances a per-UE cursor through its
+// waypoints, so a mobile run pays nothing for movement nobody observes.
+
+#ifndef TRAJECTORY_MOBILITY_H
+#define TRAJECTORY_MOBILITY_H
+
+#include "trajectory_format.h"
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace ns3
+{
+
+// Read-only mapping of a .trj file
+class TrajectoryFile
+{
+  public:
+    // One mapping per path for the whole process
+    static std::shared_ptr<TrajectoryFile> Open(const std::string &path)
+    {
+        static std::map<std::string, std::weak_ptr<TrajectoryFile>> mapped;
+        std::shared_ptr<TrajectoryFile> file = mapped[path].lock();
+        if (!file)
+        {
+            file = std::shared_ptr<TrajectoryFile>(new TrajectoryFile(path));
+            mapped[path] = file;
+        }
+        return file;
+    }
+
+    ~TrajectoryFile()
+    {
+        if (m_base) munmap(m_base, m_size);
+    }
+
+    const TrajectoryFileHeader &GetHeader() const { return *m_header; }
+
+    uint32_t GetUeCount() const { return m_header->ueCount; }
+
+    // Waypoints of one UE; count is never zero for files written by trajectory_gen
+    const TrajectoryWaypoint *GetWaypoints(uint32_t ue, uint32_t &count) const
+    {
+        NS_ABORT_MSG_IF(ue >= m_header->ueCount, "Trajectory file has no UE " << ue);
+        count = m_index[ue].count;
+        return m_waypoints + m_index[ue].first;
+    }
+
+  private:
+    explicit TrajectoryFile(const std::string &path)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        NS_ABORT_MSG_IF(fd < 0, "Cannot open trajectory file " << path);
+        struct stat st;
+        NS_ABORT_MSG_IF(fstat(fd, &st) != 0, "Cannot stat trajectory file " << path);
+        m_size = static_cast<size_t>(st.st_size);
+        NS_ABORT_MSG_IF(m_size < sizeof(TrajectoryFileHeader), "Trajectory file " << path << " is truncated");
+        m_base = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        NS_ABORT_MSG_IF(m_base == MAP_FAILED, "Cannot map trajectory file " << path);
+
+        const char *p = static_cast<const char *>(m_base);
+        m_header = reinterpret_cast<const TrajectoryFileHeader *>(p);
+        NS_ABORT_MSG_IF(std::memcmp(m_header->magic, kTrajectoryMagic, 4) != 0 || m_header->version != kTrajectoryVersion,
+                        path << " is not a version " << kTrajectoryVersion << " trajectory file");
+        size_t expected = sizeof(TrajectoryFileHeader) + m_header->ueCount * sizeof(TrajectoryIndexEntry) +
+                          m_header->totalWaypoints * sizeof(TrajectoryWaypoint);
+        NS_ABORT_MSG_IF(m_size < expected, "Trajectory file " << path << " is truncated");
+        m_index = reinterpret_cast<const TrajectoryIndexEntry *>(p + sizeof(TrajectoryFileHeader));
+        m_waypoints = reinterpret_cast<const TrajectoryWaypoint *>(p + sizeof(TrajectoryFileHeader) +
+                                                                   m_header->ueCount * sizeof(TrajectoryIndexEntry));
+    }
+
+    void *m_base = nullptr;
+    size_t m_size = 0;
+    const TrajectoryFileHeader *m_header = nullptr;
+    const TrajectoryIndexEntry *m_index = nullptr;
+    const TrajectoryWaypoint *m_waypoints = nullptr;
+};
+
+class TrajectoryMobilityModel : public MobilityModel
+{
+  public:
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::TrajectoryMobilityModel")
+                                .SetParent<MobilityModel>()
+                                .SetGroupName("Mobility")
+                                .AddConstructor<TrajectoryMobilityModel>();
+        return tid;
+    }
+
+    // Replay trajectory 'ue' of the file at 'path'
+    void SetTrajectory(const std::string &path, uint32_t ue)
+    {
+        m_file = TrajectoryFile::Open(path);
+        m_waypoints = m_file->GetWaypoints(ue, m_count);
+        NS_ABORT_MSG_IF(m_count == 0, "Trajectory " << ue << " in " << path << " is empty");
+        m_cursor = 0;
+    }
+
+  protected:
+    void DoDispose() override
+    {
+        m_file.reset();
+        m_waypoints = nullptr;
+        MobilityModel::DoDispose();
+    }
+
+  private:
+    // Move the cursor so waypoint m_cursor is the last one at or before now. Simulation time
+    // never goes backwards, so the cursor only moves forward: amortised O(1) per query.
+    void Advance() const
+    {
+        uint64_t nowUs = static_cast<uint64_t>(Simulator::Now().GetMicroSeconds());
+        uint32_t before = m_cursor;
+        while (m_cursor + 1 < m_count && m_waypoints[m_cursor + 1].timeUs <= nowUs) m_cursor++;
+        if (m_cursor != before)
+        {
+            NotifyCourseChange();
+        }
+    }
+
+    Vector DoGetPosition() const override
+    {
+        Advance();
+        const TrajectoryWaypoint &a = m_waypoints[m_cursor];
+        if (m_cursor + 1 >= m_count) return Vector(a.x, a.y, 0.0);
+        const TrajectoryWaypoint &b = m_waypoints[m_cursor + 1];
+        double nowUs = Simulator::Now().GetMicroSeconds();
+        double f = (nowUs - a.timeUs) / static_cast<double>(b.timeUs - a.timeUs);
+        f = std::min(std::max(f, 0.0), 1.0);
+        return Vector(a.x + f * (b.x - a.x), a.y + f * (b.y - a.y), 0.0);
+    }
+
+    Vector DoGetVelocity() const override
+    {
+        Advance();
+        if (m_cursor + 1 >= m_count) return Vector(0.0, 0.0, 0.0);
+        const TrajectoryWaypoint &a = m_waypoints[m_cursor];
+        const TrajectoryWaypoint &b = m_waypoints[m_cursor + 1];
+        if (Simulator::Now().GetMicroSeconds() < a.timeUs || b.timeUs == a.timeUs) return Vector(0.0, 0.0, 0.0);
+        double dt = (b.timeUs - a.timeUs) * 1e-6;
+        return Vector((b.x - a.x) / dt, (b.y - a.y) / dt, 0.0);
+    }
+
+    // Positions come from the file; an explicit SetPosition is not meaningful here
+    void DoSetPosition(const Vector &) override
+    {
+        NS_ABORT_MSG("TrajectoryMobilityModel positions are fixed by the trajectory file");
+    }
+
+    std::shared_ptr<TrajectoryFile> m_file;
+    const TrajectoryWaypoint *m_waypoints = nullptr;
+    uint32_t m_count = 0;
+    mutable uint32_t m_cursor = 0;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(TrajectoryMobilityModel);
+
+// Give UE i of 'nodes' trajectory i of the file. The file must cover the whole run (a UE
+// would otherwise freeze at its last waypoint) and must have been generated for the same
+// area the generator's own random walk uses.
+inline void InstallTrajectories(NodeContainer nodes, const std::string &path, Time simTime, const Rectangle &area)
+{
+    std::shared_ptr<TrajectoryFile> file = TrajectoryFile::Open(path);
+    const TrajectoryFileHeader &h = file->GetHeader();
+    NS_ABORT_MSG_IF(file->GetUeCount() < nodes.GetN(),
+                    path << " has " << file->GetUeCount() << " trajectories, " << nodes.GetN() << " needed");
+    NS_ABORT_MSG_IF(h.duration + 1e-6 < simTime.GetSeconds(),
+                    path << " covers " << h.duration << " s, the run is " << simTime.GetSeconds()
+                         << " s (trajectory_gen --duration)");
+    const double eps = 1e-6;
+    NS_ABORT_MSG_IF(std::abs(h.minX - area.xMin) > eps || std::abs(h.maxX - area.xMax) > eps ||
+                        std::abs(h.minY - area.yMin) > eps || std::abs(h.maxY - area.yMax) > eps,
+                    path << " was generated for x [" << h.minX << ", " << h.maxX << "] y [" << h.minY << ", "
+                         << h.maxY << "], this run uses x [" << area.xMin << ", " << area.xMax << "] y ["
+                         << area.yMin << ", " << area.yMax << "] (trajectory_gen --minX/--maxX/--minY/--maxY)");
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+        Ptr<TrajectoryMobilityModel> model = CreateObject<TrajectoryMobilityModel>();
+        model->SetTrajectory(path, i);
+        nodes.Get(i)->AggregateObject(model);
+    }
+}
+
+} // namespace ns3
+
+#endif // TRAJECTORY_MOBILITY_H
@@ -0,0 +1,330 @@
+// window_socket_sink.h - Streams each window's rows to a local scorer over a Unix socket
+// Live counterpart of the CSV: SampleAndWrite() hands every row to AddRow() and closes the
+// window with EndWindow(), which sends it as one length-prefixed binary record. The scorer
+// (5G_IDS_ML_Cap/service/stream_scorer.py) listens on the socket before the run starts.
+//
+// Record: u32 length of what follows, u8 type, payload. Little-endian, packed.
+//   1 HELLO         u16 version, u32 ue_total, u32 attackers, f64 window_s, u16 n, n bytes scenario_id
+//   2 ATTACK_START  f64 sim_s, i64 wall_ns
+//   3 WINDOW        f64 time_start, f64 time_end, i64 wall_ns, u32 weight, u32 rows, rows x ROW
+//   4 END           f64 sim_s, u64 windows, u64 dropped_windows, u64 sampled_out_rows
+//   ROW (112 bytes) u32 src, u32 dst, u16 src_port, u16 dst_port, u8 protocol, u8 label_binary,
+//                   u8 label_intensity, u8 pad, u64 bytes fwd/bwd, u64 pkts fwd/bwd,
+//                   f64 packet_size, duration, pkts/s, bytes/s, flow pkts/s, flow bytes/s,
+//                   jitter_ms, delay_ms
+// wall_ns is steady_clock (CLOCK_MONOTONIC), comparable with time.monotonic_ns() in the scorer.
+//
+// Backpressure when the scorer falls behind:
+//   block   send blocks, so the simulation waits for the scorer
+//   drop    windows that do not fit in the send buffer (BufferBytes) are dropped whole
+//   sample  such windows are thinned to every k-th row (k a power of two); weight = k
+// Control records are never dropped.
+
+#ifndef WINDOW_SOCKET_SINK_H
+#define WINDOW_SOCKET_SINK_H
+
+#include "flow_window_sampler.h"
+
+#include "ns3/core-module.h"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class WindowSocketSink
+{
+  public:
+    enum Mode
+    {
+        BLOCK,
+        DROP,
+        SAMPLE
+    };
+
+    struct Stats
+    {
+        uint64_t windows = 0;
+        uint64_t droppedWindows = 0;
+        uint64_t sampledWindows = 0;
+        uint64_t rows = 0;
+        uint64_t sampledOutRows = 0;
+        uint64_t bytes = 0;
+        double blockedNs = 0.0; // time spent waiting in send (block mode, final flush)
+    };
+
+    static const uint16_t kVersion = 1;
+    static const size_t kRowBytes = 112;
+
+    ~WindowSocketSink()
+    {
+        if (m_fd >= 0) ::close(m_fd);
+    }
+
+    // Connects to the scorer. Returns false for an unknown mode or if nothing listens on path.
+    bool Open(const std::string &path, const std::string &mode, size_t bufferBytes)
+    {
+        if (mode == "block") m_mode = BLOCK;
+        else if (mode == "drop") m_mode = DROP;
+        else if (mode == "sample") m_mode = SAMPLE;
+        else return false;
+        m_bufferBytes = bufferBytes;
+
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path)) return false;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        m_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (m_fd < 0) return false;
+        if (::connect(m_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+        {
+            ::close(m_fd);
+            m_fd = -1;
+            return false;
+        }
+        if (m_mode != BLOCK) ::fcntl(m_fd, F_SETFL, ::fcntl(m_fd, F_GETFL) | O_NONBLOCK);
+        return true;
+    }
+
+    bool IsOpen() const { return m_fd >= 0; }
+    const Stats &GetStats() const { return m_stats; }
+
+    void Hello(const std::string &scenarioId, uint32_t ueTotal, uint32_t attackers, double windowSize)
+    {
+        std::vector<char> rec = Begin(1);
+        Put(rec, kVersion);
+        Put(rec, ueTotal);
+        Put(rec, attackers);
+        Put(rec, windowSize);
+        Put(rec, static_cast<uint16_t>(scenarioId.size()));
+        rec.insert(rec.end(), scenarioId.begin(), scenarioId.end());
+        Send(Finish(rec));
+    }
+
+    // Scheduled at appStart, when the attackers begin sending
+    void MarkAttackStart()
+    {
+        std::vector<char> rec = Begin(2);
+        Put(rec, Simulator::Now().GetSeconds());
+        Put(rec, WallNs());
+        Send(Finish(rec));
+    }
+
+    void AddRow(const WindowRow &r, bool attackBinary, int attackIntensity)
+    {
+        Put(m_rows, r.key.src.Get());
+        Put(m_rows, r.key.dst.Get());
+        Put(m_rows, r.key.srcPort);
+        Put(m_rows, r.key.dstPort);
+        Put(m_rows, r.key.protocol);
+        Put(m_rows, static_cast<uint8_t>(attackBinary ? 1 : 0));
+        Put(m_rows, static_cast<uint8_t>(attackIntensity));
+        Put(m_rows, static_cast<uint8_t>(0));
+        Put(m_rows, r.totalBytesFwd);
+        Put(m_rows, r.totalBytesBwd);
+        Put(m_rows, r.totalPktsFwd);
+        Put(m_rows, r.totalPktsBwd);
+        Put(m_rows, r.avgPktSize);
+        Put(m_rows, r.duration);
+        Put(m_rows, r.pktsPerSec);
+        Put(m_rows, r.bytesPerSec);
+        Put(m_rows, r.flowPktsPerSec);
+        Put(m_rows, r.flowBytesPerSec);
+        Put(m_rows, r.avgJitterMs);
+        Put(m_rows, r.avgDelayMs);
+    }
+
+    // Sends the rows added since the last call as one WINDOW record, subject to backpressure
+    void EndWindow(double timeStart, double timeEnd)
+    {
+        uint32_t n = static_cast<uint32_t>(m_rows.size() / kRowBytes);
+        m_stats.windows++;
+        m_stats.rows += n;
+        const size_t header = 4 + 1 + 8 + 8 + 8 + 4 + 4;
+
+        uint32_t stride = 1;
+        if (m_mode != BLOCK)
+        {
+            Flush(false);
+            size_t used = m_pending.size() - m_pendingOff;
+            size_t room = m_bufferBytes > used ? m_bufferBytes - used : 0;
+            if (m_mode == SAMPLE)
+            {
+                while (stride < n && header + Kept(n, stride) * kRowBytes > room) stride *= 2;
+            }
+            if (header + Kept(n, stride) * kRowBytes > room)
+            {
+                m_stats.droppedWindows++;
+                m_rows.clear();
+                return;
+            }
+        }
+
+        uint32_t kept = Kept(n, stride);
+        std::vector<char> rec = Begin(3);
+        rec.reserve(header + kept * kRowBytes);
+        Put(rec, timeStart);
+        Put(rec, timeEnd);
+        Put(rec, WallNs());
+        Put(rec, stride);
+        Put(rec, kept);
+        for (uint32_t i = 0; i < n; i += stride)
+        {
+            rec.insert(rec.end(), m_rows.begin() + i * kRowBytes, m_rows.begin() + (i + 1) * kRowBytes);
+        }
+        if (stride > 1)
+        {
+            m_stats.sampledWindows++;
+            m_stats.sampledOutRows += n - kept;
+        }
+        m_rows.clear();
+        Send(Finish(rec));
+    }
+
+    // Flushes everything still buffered (blocking), sends END and closes the socket
+    void Close(double simEnd)
+    {
+        if (m_fd < 0) return;
+        std::vector<char> rec = Begin(4);
+        Put(rec, simEnd);
+        Put(rec, m_stats.windows);
+        Put(rec, m_stats.droppedWindows);
+        Put(rec, m_stats.sampledOutRows);
+        Send(Finish(rec));
+        Flush(true);
+        if (m_fd >= 0) ::close(m_fd);
+        m_fd = -1;
+    }
+
+  private:
+    template <typename T>
+    static void Put(std::vector<char> &buf, T v)
+    {
+        char b[sizeof(T)];
+        std::memcpy(b, &v, sizeof(T)); // host order; Linux targets here are little-endian
+        buf.insert(buf.end(), b, b + sizeof(T));
+    }
+
+    static std::vector<char> Begin(uint8_t type)
+    {
+        std::vector<char> rec(4, 0); // length, patched by Finish
+        rec.push_back(static_cast<char>(type));
+        return rec;
+    }
+
+    static std::vector<char> &Finish(std::vector<char> &rec)
+    {
+        uint32_t len = static_cast<uint32_t>(rec.size() - 4);
+        std::memcpy(rec.data(), &len, 4);
+        return rec;
+    }
+
+    static uint32_t Kept(uint32_t n, uint32_t stride) { return (n + stride - 1) / stride; }
+
+    static int64_t WallNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    void Send(const std::vector<char> &rec)
+    {
+        if (m_fd < 0) return;
+        m_stats.bytes += rec.size();
+        if (m_mode == BLOCK)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            WriteAll(rec.data(), rec.size());
+            m_stats.blockedNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+            return;
+        }
+        m_pending.insert(m_pending.end(), rec.begin(), rec.end());
+        Flush(false);
+    }
+
+    // Non-blocking: writes what the socket takes. Blocking: writes everything.
+    void Flush(bool wait)
+    {
+        if (m_fd < 0) return;
+        if (wait)
+        {
+            ::fcntl(m_fd, F_SETFL, ::fcntl(m_fd, F_GETFL) & ~O_NONBLOCK);
+            auto t0 = std::chrono::steady_clock::now();
+            WriteAll(m_pending.data() + m_pendingOff, m_pending.size() - m_pendingOff);
+            m_stats.blockedNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+            m_pending.clear();
+            m_pendingOff = 0;
+            return;
+        }
+        while (m_pendingOff < m_pending.size())
+        {
+            ssize_t w = ::send(m_fd, m_pending.data() + m_pendingOff, m_pending.size() - m_pendingOff, MSG_NOSIGNAL);
+            if (w < 0 && errno == EINTR) continue;
+            if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            if (w < 0)
+            {
+                Fail();
+                return;
+            }
+            m_pendingOff += static_cast<size_t>(w);
+        }
+        if (m_pendingOff == m_pending.size())
+        {
+            m_pending.clear();
+            m_pendingOff = 0;
+        }
+        else if (m_pendingOff > (1 << 20))
+        {
+            m_pending.erase(m_pending.begin(), m_pending.begin() + m_pendingOff);
+            m_pendingOff = 0;
+        }
+    }
+
+    void WriteAll(const char *p, size_t n)
+    {
+        while (n > 0 && m_fd >= 0)
+        {
+            ssize_t w = ::send(m_fd, p, n, MSG_NOSIGNAL);
+            if (w < 0 && errno == EINTR) continue;
+            if (w < 0)
+            {
+                Fail();
+                return;
+            }
+            p += w;
+            n -= static_cast<size_t>(w);
+        }
+    }
+
+    // The scorer went away: stop streaming, keep simulating (the CSV is still written)
+    void Fail()
+    {
+        std::cerr << "WindowSocketSink: send failed (" << std::strerror(errno) << "), streaming stopped" << std::endl;
+        ::close(m_fd);
+        m_fd = -1;
+        m_pending.clear();
+        m_pendingOff = 0;
+    }
+
+    int m_fd = -1;
+    Mode m_mode = BLOCK;
+    size_t m_bufferBytes = 4 << 20;
+    std::vector<char> m_rows; // this window's rows, kRowBytes each
+    std::vector<char> m_pending; // drop/sample: bytes the socket has not taken yet
+    size_t m_pendingOff = 0;
+    Stats m_stats;
+};
+
+} // namespace ns3
+
+#endif // WINDOW_SOCKET_SINK_H
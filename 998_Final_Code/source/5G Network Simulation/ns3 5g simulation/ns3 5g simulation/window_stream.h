@@ -0,0 +1,828 @@
+// window_stream.h - Delta-encoded, block-compressed window stream (.dws)
+// On long runs (--simTime in the thousands of seconds) most flows appear in every window and
+// their counters move little from one window to the next, yet the CSV spells out every value
+// again as text. With --output=dws the generators write each row as a delta against the same
+// flow's previous row: integer columns as zigzag varints, double columns as the XOR of their
+// bit patterns (Gorilla-style, byte aligned, so an unchanged value costs one byte). Rows are
+// cut into blocks that decode without any earlier block, and each block is compressed on its
+// own. WindowStreamReader decodes a stream row by row; tools/window_stream_csv.cc turns it back
+// into the CSV the run would have written, byte for byte. No ns-3 dependency.
+//
+// File, little-endian:
+//   HEADER  char magic[4] "DWS1", u32 version, u32 columns, u32 reserved, then per column
+//           u8 kind, u8 name length, name, u16 value length, value (text of a CONST column)
+//   BLOCK*  u32 raw bytes, u32 stored bytes, u32 rows, u8 codec, u8 pad[3], stored payload
+// A block's raw payload is a sequence of records:
+//   0x01 window    f64 time_start, f64 time_end of the rows that follow
+//   0x02 new flow  u32 src_ip, u32 dst_ip, varint src_port, varint dst_port, u8 protocol, row;
+//                  the flow gets the next block-local id
+//   0x03 row       varint zigzag(id - previous row's id - 1), row
+// A row holds the UINT, INT and FLOAT columns in column order, each against the flow's previous
+// row in the block (0 for a new flow):
+//   UINT, INT  varint zigzag(value - previous), wrapping; the kind only decides how it prints
+//   FLOAT      x = bits ^ previous bits: a 0 byte if x == 0, else a byte (t << 4 | n) followed
+//              by the n low bytes of x >> 8t, t being x's trailing zero bytes
+//
+// Block compression is compiled in with -DDWS_WITH_ZSTD (link -lzstd) and/or -DDWS_WITH_LZ4
+// (link -llz4). Without either, blocks are stored raw; a reader needs the codecs its files use.
+
+#ifndef WINDOW_STREAM_H
+#define WINDOW_STREAM_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef DWS_WITH_ZSTD
+#include <zstd.h>
+#endif
+#ifdef DWS_WITH_LZ4
+#include <lz4.h>
+#endif
+
+static const char kDwsMagic[4] = {'D', 'W', 'S', '1'};
+static const uint32_t kDwsVersion = 1;
+
+enum WindowStreamKind : uint8_t
+{
+    kDwsTimeStart = 1,
+    kDwsTimeEnd = 2,
+    kDwsConst = 3, // same text on every row, stored once in the header
+    kDwsSrcIp = 4,
+    kDwsDstIp = 5,
+    kDwsSrcPort = 6,
+    kDwsDstPort = 7,
+    kDwsProtocol = 8,
+    kDwsInt = 9, // signed
+    kDwsFloat = 10,
+    kDwsUint = 11,
+};
+
+inline bool WindowStreamIsValue(uint8_t kind) { return kind == kDwsUint || kind == kDwsInt || kind == kDwsFloat; }
+
+enum WindowStreamCodec : uint8_t
+{
+    kDwsRaw = 0,
+    kDwsLz4 = 1,
+    kDwsZstd = 2,
+};
+
+struct WindowStreamColumn
+{
+    std::string name;
+    uint8_t kind;
+    std::string value; // CONST columns only
+};
+
+// Kind of a generator CSV column. Integer columns not listed here would be stored as FLOAT,
+// which is still exact, only larger. RLC backlogs are the only signed counters.
+inline uint8_t WindowStreamKindForColumn(const std::string &name)
+{
+    if (name == "time_start") return kDwsTimeStart;
+    if (name == "time_end") return kDwsTimeEnd;
+    if (name == "src_ip") return kDwsSrcIp;
+    if (name == "dst_ip") return kDwsDstIp;
+    if (name == "src_port") return kDwsSrcPort;
+    if (name == "dst_port") return kDwsDstPort;
+    if (name == "protocol") return kDwsProtocol;
+    if (name == "src_rlc_backlog_bytes" || name == "dst_rlc_backlog_bytes") return kDwsInt;
+    static const char *uints[] = {"total_bytes_fwd",    "total_bytes_bwd",    "total_pkts_fwd",
+                                  "total_pkts_bwd",     "label_binary",       "label_intensity",
+                                  "cell_id",            "rx_pkts",            "lost_pkts",
+                                  "dst_queue_max_pkts", "dst_queue_enq_pkts", "dst_queue_drop_pkts",
+                                  "src_ul_prbs",        "src_ul_harq_retx",   "src_rlc_drops",
+                                  "dst_dl_prbs",        "dst_dl_harq_retx"};
+    for (const char *n : uints)
+    {
+        if (name == n) return kDwsUint;
+    }
+    return kDwsFloat;
+}
+
+// Schema for a CSV header; columns named in consts are stored once with that text
+inline std::vector<WindowStreamColumn> WindowStreamColumns(const std::vector<std::string> &names,
+                                                           const std::map<std::string, std::string> &consts)
+{
+    std::vector<WindowStreamColumn> columns;
+    for (const std::string &name : names)
+    {
+        auto it = consts.find(name);
+        if (it != consts.end()) columns.push_back({name, kDwsConst, it->second});
+        else columns.push_back({name, WindowStreamKindForColumn(name), std::string()});
+    }
+    return columns;
+}
+
+inline bool WindowStreamCodecAvailable(uint8_t codec)
+{
+    switch (codec)
+    {
+    case kDwsRaw: return true;
+#ifdef DWS_WITH_LZ4
+    case kDwsLz4: return true;
+#endif
+#ifdef DWS_WITH_ZSTD
+    case kDwsZstd: return true;
+#endif
+    default: return false;
+    }
+}
+
+inline const char *WindowStreamCodecName(uint8_t codec)
+{
+    switch (codec)
+    {
+    case kDwsRaw: return "raw";
+    case kDwsLz4: return "lz4";
+    case kDwsZstd: return "zstd";
+    default: return "unknown";
+    }
+}
+
+// raw|lz4|zstd, or auto for the strongest one compiled in. False if unknown or not compiled in.
+inline bool WindowStreamParseCodec(const std::string &name, uint8_t &codec)
+{
+    if (name == "auto") codec = WindowStreamCodecAvailable(kDwsZstd) ? kDwsZstd
+                                : WindowStreamCodecAvailable(kDwsLz4) ? kDwsLz4 : kDwsRaw;
+    else if (name == "raw") codec = kDwsRaw;
+    else if (name == "lz4") codec = kDwsLz4;
+    else if (name == "zstd") codec = kDwsZstd;
+    else return false;
+    return WindowStreamCodecAvailable(codec);
+}
+
+class WindowStreamWriter
+{
+  public:
+    WindowStreamWriter() = default;
+    WindowStreamWriter(const WindowStreamWriter &) = delete;
+    WindowStreamWriter &operator=(const WindowStreamWriter &) = delete;
+
+    ~WindowStreamWriter()
+    {
+        Close();
+#ifdef DWS_WITH_ZSTD
+        ZSTD_freeCCtx(m_zstd);
+#endif
+    }
+
+    bool Open(const std::string &path, const std::vector<WindowStreamColumn> &columns, uint8_t codec,
+              int level = 3, uint32_t blockRows = 65536)
+    {
+        m_file.open(path, std::ios::binary | std::ios::trunc);
+        return m_file && Attach(&m_file, columns, codec, level, blockRows);
+    }
+
+    // Encodes into a stream the caller owns (the benchmark writes to memory)
+    bool Attach(std::ostream *out, const std::vector<WindowStreamColumn> &columns, uint8_t codec, int level = 3,
+                uint32_t blockRows = 65536)
+    {
+        if (!WindowStreamCodecAvailable(codec) || blockRows == 0) return false;
+        m_out = out;
+        m_codec = codec;
+        m_level = level;
+        m_blockRows = blockRows;
+        m_kinds.clear();
+        for (const WindowStreamColumn &c : columns)
+        {
+            if (WindowStreamIsValue(c.kind)) m_kinds.push_back(c.kind == kDwsFloat ? kDwsFloat : kDwsInt);
+        }
+        m_rows = m_blocks = m_rawBytes = m_bytes = 0;
+        m_failed = false;
+        ResetBlock();
+
+        std::string h(kDwsMagic, 4);
+        PutU32(h, kDwsVersion);
+        PutU32(h, static_cast<uint32_t>(columns.size()));
+        PutU32(h, 0);
+        for (const WindowStreamColumn &c : columns)
+        {
+            h.push_back(static_cast<char>(c.kind));
+            h.push_back(static_cast<char>(std::min<size_t>(c.name.size(), 255)));
+            h.append(c.name, 0, 255);
+            size_t n = std::min<size_t>(c.value.size(), 65535);
+            h.push_back(static_cast<char>(n & 0xff));
+            h.push_back(static_cast<char>(n >> 8));
+            h.append(c.value, 0, n);
+        }
+        Emit(h.data(), h.size());
+        return !m_failed;
+    }
+
+    bool IsOpen() const { return m_out != nullptr; }
+    uint64_t GetRows() const { return m_rows; }
+    uint64_t GetBlocks() const { return m_blocks; }
+    uint64_t GetRawBytes() const { return m_rawBytes; } // payload before compression
+    uint64_t GetBytes() const { return m_bytes; }       // file size
+    const char *GetCodecName() const { return WindowStreamCodecName(m_codec); }
+
+    // A row is BeginRow(), then Int() for each UINT/INT column and Float() for each FLOAT column,
+    // in column order, then EndRow()
+    void BeginRow(double timeStart, double timeEnd, uint32_t src, uint32_t dst, uint16_t srcPort, uint16_t dstPort,
+                  uint8_t protocol)
+    {
+        Reserve(64 + m_kinds.size() * 10);
+        uint8_t *p = &m_raw[m_len];
+        if (!m_haveWindow || !SameBits(timeStart, m_timeStart) || !SameBits(timeEnd, m_timeEnd))
+        {
+            *p++ = 0x01;
+            std::memcpy(p, &timeStart, 8);
+            std::memcpy(p + 8, &timeEnd, 8);
+            p += 16;
+            m_timeStart = timeStart;
+            m_timeEnd = timeEnd;
+            m_haveWindow = true;
+        }
+
+        Key key{(uint64_t(src) << 32) | dst, (uint64_t(srcPort) << 24) | (uint64_t(dstPort) << 8) | protocol};
+        // Windows list flows in the same order, so the next id is almost always the right one
+        uint32_t id = m_lastId + 1;
+        if (id >= m_keys.size() || !(m_keys[id] == key))
+        {
+            auto it = m_ids.find(key);
+            if (it == m_ids.end())
+            {
+                id = static_cast<uint32_t>(m_keys.size());
+                m_ids.emplace(key, id);
+                m_keys.push_back(key);
+                m_prev.resize(m_prev.size() + m_kinds.size(), 0);
+                *p++ = 0x02;
+                std::memcpy(p, &src, 4);
+                std::memcpy(p + 4, &dst, 4);
+                p = PutVarint(p + 8, srcPort);
+                p = PutVarint(p, dstPort);
+                *p++ = protocol;
+                m_len = p - m_raw.data();
+                StartValues(id);
+                return;
+            }
+            id = it->second;
+        }
+        *p++ = 0x03;
+        p = PutVarint(p, Zigzag(int64_t(id) - int64_t(m_lastId) - 1));
+        m_len = p - m_raw.data();
+        StartValues(id);
+    }
+
+    void Int(int64_t v)
+    {
+        if (!Expect(kDwsInt)) return;
+        uint64_t &prev = m_cur[m_col++];
+        uint8_t *p = PutVarint(&m_raw[m_len], Zigzag(static_cast<int64_t>(static_cast<uint64_t>(v) - prev)));
+        prev = static_cast<uint64_t>(v);
+        m_len = p - m_raw.data();
+    }
+
+    void Float(double v)
+    {
+        if (!Expect(kDwsFloat)) return;
+        uint64_t bits;
+        std::memcpy(&bits, &v, 8);
+        uint64_t &prev = m_cur[m_col++];
+        uint64_t x = bits ^ prev;
+        prev = bits;
+        uint8_t *p = &m_raw[m_len];
+        if (x == 0)
+        {
+            *p++ = 0;
+        }
+        else
+        {
+            int t = __builtin_ctzll(x) >> 3;
+            int n = 8 - t - (__builtin_clzll(x) >> 3);
+            *p++ = static_cast<uint8_t>(t << 4 | n);
+            uint64_t m = x >> (8 * t);
+            std::memcpy(p, &m, 8); // Reserve() left room for all 8
+            p += n;
+        }
+        m_len = p - m_raw.data();
+    }
+
+    void EndRow()
+    {
+        if (m_col != m_kinds.size()) m_failed = true;
+        m_col = m_kinds.size(); // further Int()/Float() calls before BeginRow() are errors
+        m_rows++;
+        if (++m_blockRowCount >= m_blockRows) FlushBlock();
+    }
+
+    // Writes the last block. False if a row did not match the schema or a write failed.
+    bool Close()
+    {
+        if (!m_out) return !m_failed;
+        FlushBlock();
+        m_out->flush();
+        if (!*m_out) m_failed = true;
+        if (m_file.is_open()) m_file.close();
+        m_out = nullptr;
+        return !m_failed;
+    }
+
+  private:
+    struct Key
+    {
+        uint64_t ips;
+        uint64_t rest; // ports and protocol
+
+        bool operator==(const Key &o) const { return ips == o.ips && rest == o.rest; }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key &k) const { return (k.ips * 0x9e3779b97f4a7c15ull) ^ (k.rest * 0xc2b2ae3d27d4eb4full); }
+    };
+
+    static bool SameBits(double a, double b) { return std::memcmp(&a, &b, 8) == 0; }
+    static uint64_t Zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+
+    static uint8_t *PutVarint(uint8_t *p, uint64_t v)
+    {
+        while (v >= 0x80)
+        {
+            *p++ = static_cast<uint8_t>(v | 0x80);
+            v >>= 7;
+        }
+        *p++ = static_cast<uint8_t>(v);
+        return p;
+    }
+
+    static void PutU32(std::string &s, uint32_t v) { s.append(reinterpret_cast<const char *>(&v), 4); }
+
+    void Reserve(size_t n)
+    {
+        if (m_len + n > m_raw.size()) m_raw.resize(std::max(m_raw.size() * 2, m_len + n));
+    }
+
+    void StartValues(uint32_t id)
+    {
+        m_lastId = id;
+        m_cur = &m_prev[size_t(id) * m_kinds.size()];
+        m_col = 0;
+    }
+
+    bool Expect(uint8_t kind)
+    {
+        if (m_col < m_kinds.size() && m_kinds[m_col] == kind) return true;
+        m_failed = true;
+        return false;
+    }
+
+    void ResetBlock()
+    {
+        m_len = 0;
+        m_blockRowCount = 0;
+        m_haveWindow = false;
+        m_lastId = uint32_t(-1);
+        m_ids.clear();
+        m_keys.clear();
+        m_prev.clear();
+    }
+
+    void FlushBlock()
+    {
+        if (m_blockRowCount == 0) return;
+        const char *payload = reinterpret_cast<const char *>(m_raw.data());
+        size_t stored = m_len;
+        uint8_t codec = kDwsRaw;
+#ifdef DWS_WITH_ZSTD
+        if (m_codec == kDwsZstd)
+        {
+            if (!m_zstd) m_zstd = ZSTD_createCCtx();
+            m_packed.resize(ZSTD_compressBound(m_len));
+            size_t n = ZSTD_compressCCtx(m_zstd, m_packed.data(), m_packed.size(), payload, m_len, m_level);
+            if (!ZSTD_isError(n) && n < m_len)
+            {
+                payload = m_packed.data();
+                stored = n;
+                codec = kDwsZstd;
+            }
+        }
+#endif
+#ifdef DWS_WITH_LZ4
+        if (m_codec == kDwsLz4)
+        {
+            m_packed.resize(LZ4_compressBound(static_cast<int>(m_len)));
+            int n = LZ4_compress_default(payload, m_packed.data(), static_cast<int>(m_len),
+                                         static_cast<int>(m_packed.size()));
+            if (n > 0 && size_t(n) < m_len)
+            {
+                payload = m_packed.data();
+                stored = n;
+                codec = kDwsLz4;
+            }
+        }
+#endif
+        uint32_t h[4] = {static_cast<uint32_t>(m_len), static_cast<uint32_t>(stored), m_blockRowCount, codec};
+        Emit(reinterpret_cast<const char *>(h), sizeof(h));
+        Emit(payload, stored);
+        m_rawBytes += m_len;
+        m_blocks++;
+        ResetBlock();
+    }
+
+    void Emit(const char *data, size_t n)
+    {
+        m_out->write(data, n);
+        m_bytes += n;
+        if (!*m_out) m_failed = true;
+    }
+
+    std::ofstream m_file;
+    std::ostream *m_out = nullptr;
+    uint8_t m_codec = kDwsRaw;
+    int m_level = 3;
+    uint32_t m_blockRows = 65536;
+    std::vector<uint8_t> m_kinds; // per value column: kDwsInt (UINT or INT) or kDwsFloat
+    bool m_failed = false;
+    uint64_t m_rows = 0;
+    uint64_t m_blocks = 0;
+    uint64_t m_rawBytes = 0;
+    uint64_t m_bytes = 0;
+
+    // Current block
+    std::vector<uint8_t> m_raw;
+    size_t m_len = 0;
+    uint32_t m_blockRowCount = 0;
+    bool m_haveWindow = false;
+    double m_timeStart = 0.0;
+    double m_timeEnd = 0.0;
+    std::unordered_map<Key, uint32_t, KeyHash> m_ids;
+    std::vector<Key> m_keys;     // by block-local id
+    std::vector<uint64_t> m_prev; // id x value columns: previous value (INT) or bits (FLOAT)
+    uint32_t m_lastId = uint32_t(-1);
+    uint64_t *m_cur = nullptr;
+    size_t m_col = 0;
+    std::vector<char> m_packed;
+#ifdef DWS_WITH_ZSTD
+    ZSTD_CCtx *m_zstd = nullptr;
+#endif
+};
+
+// One decoded row; valid until the next WindowStreamReader::Next()
+struct WindowStreamRow
+{
+    double timeStart;
+    double timeEnd;
+    uint32_t src;
+    uint32_t dst;
+    uint16_t srcPort;
+    uint16_t dstPort;
+    uint8_t protocol;
+    const uint64_t *values; // per value column in order: the integer (two's complement) or double bits
+
+    uint64_t Uint(size_t i) const { return values[i]; }
+    int64_t Int(size_t i) const { return static_cast<int64_t>(values[i]); }
+    double Float(size_t i) const
+    {
+        double v;
+        std::memcpy(&v, &values[i], 8);
+        return v;
+    }
+};
+
+class WindowStreamReader
+{
+  public:
+    WindowStreamReader() = default;
+    WindowStreamReader(const WindowStreamReader &) = delete;
+    WindowStreamReader &operator=(const WindowStreamReader &) = delete;
+
+#ifdef DWS_WITH_ZSTD
+    ~WindowStreamReader() { ZSTD_freeDCtx(m_zstd); }
+#endif
+
+    bool Open(const std::string &path)
+    {
+        m_file.open(path, std::ios::binary);
+        if (!m_file) return Fail("cannot open " + path);
+        return Attach(&m_file);
+    }
+
+    bool Attach(std::istream *in)
+    {
+        m_in = in;
+        char h[16];
+        if (!m_in->read(h, 16) || std::memcmp(h, kDwsMagic, 4) != 0) return Fail("not a window stream");
+        uint32_t version, columns;
+        std::memcpy(&version, h + 4, 4);
+        std::memcpy(&columns, h + 8, 4);
+        if (version != kDwsVersion) return Fail("unsupported version " + std::to_string(version));
+        m_columns.clear();
+        m_kinds.clear();
+        for (uint32_t i = 0; i < columns; ++i)
+        {
+            unsigned char b[2];
+            WindowStreamColumn c;
+            if (!m_in->read(reinterpret_cast<char *>(b), 2)) return Fail("truncated header");
+            c.kind = b[0];
+            c.name.resize(b[1]);
+            if (!m_in->read(&c.name[0], b[1]) || !m_in->read(reinterpret_cast<char *>(b), 2))
+            {
+                return Fail("truncated header");
+            }
+            c.value.resize(b[0] | (b[1] << 8));
+            if (!m_in->read(&c.value[0], c.value.size())) return Fail("truncated header");
+            if (c.kind < kDwsTimeStart || c.kind > kDwsUint) return Fail("unknown column kind");
+            if (WindowStreamIsValue(c.kind)) m_kinds.push_back(c.kind == kDwsFloat ? kDwsFloat : kDwsInt);
+            m_columns.push_back(c);
+        }
+        m_pos = m_end = nullptr;
+        m_blockRowsLeft = 0;
+        return true;
+    }
+
+    const std::vector<WindowStreamColumn> &GetColumns() const { return m_columns; }
+    uint64_t GetBlocks() const { return m_blocks; }
+    uint64_t GetRows() const { return m_rows; }
+    bool Failed() const { return !m_error.empty(); }
+    const std::string &GetError() const { return m_error; }
+
+    // False at the end of the stream or on a corrupt one (Failed() tells them apart)
+    bool Next(WindowStreamRow &row)
+    {
+        while (m_blockRowsLeft == 0)
+        {
+            if (m_pos != m_end) return Fail("block has trailing bytes");
+            if (!ReadBlock()) return false;
+        }
+        const uint8_t *p = m_pos;
+        if (*p == 0x01)
+        {
+            std::memcpy(&m_timeStart, p + 1, 8);
+            std::memcpy(&m_timeEnd, p + 9, 8);
+            p += 17;
+            m_haveWindow = true;
+        }
+        if (!m_haveWindow) return Fail("row before its window");
+        uint32_t id;
+        if (*p == 0x02)
+        {
+            Flow f;
+            std::memcpy(&f.src, p + 1, 4);
+            std::memcpy(&f.dst, p + 5, 4);
+            p += 9;
+            f.srcPort = static_cast<uint16_t>(GetVarint(p));
+            f.dstPort = static_cast<uint16_t>(GetVarint(p));
+            f.protocol = *p++;
+            id = static_cast<uint32_t>(m_flows.size());
+            m_flows.push_back(f);
+            m_prev.resize(m_prev.size() + m_kinds.size(), 0);
+        }
+        else if (*p == 0x03)
+        {
+            ++p;
+            int64_t d = Unzigzag(GetVarint(p));
+            id = static_cast<uint32_t>(int64_t(m_lastId) + 1 + d);
+            if (id >= m_flows.size()) return Fail("row refers to an unknown flow");
+        }
+        else
+        {
+            return Fail("unknown record");
+        }
+
+        uint64_t *prev = &m_prev[size_t(id) * m_kinds.size()];
+        for (size_t i = 0; i < m_kinds.size(); ++i)
+        {
+            if (m_kinds[i] == kDwsInt)
+            {
+                prev[i] += static_cast<uint64_t>(Unzigzag(GetVarint(p)));
+            }
+            else
+            {
+                uint8_t c = *p++;
+                if (c != 0)
+                {
+                    unsigned t = c >> 4;
+                    unsigned n = c & 15;
+                    if (n == 0 || n + t > 8) return Fail("bad float");
+                    uint64_t m = 0;
+                    std::memcpy(&m, p, n);
+                    p += n;
+                    prev[i] ^= m << (8 * t);
+                }
+            }
+        }
+        // The block is zero-padded, so a truncated row lands in the padding instead of past it
+        if (p > m_end) return Fail("row runs past its block");
+        m_pos = p;
+        m_lastId = id;
+        m_blockRowsLeft--;
+        m_rows++;
+
+        const Flow &f = m_flows[id];
+        row.timeStart = m_timeStart;
+        row.timeEnd = m_timeEnd;
+        row.src = f.src;
+        row.dst = f.dst;
+        row.srcPort = f.srcPort;
+        row.dstPort = f.dstPort;
+        row.protocol = f.protocol;
+        row.values = prev;
+        return true;
+    }
+
+  private:
+    struct Flow
+    {
+        uint32_t src;
+        uint32_t dst;
+        uint16_t srcPort;
+        uint16_t dstPort;
+        uint8_t protocol;
+    };
+
+    static int64_t Unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+    static uint64_t GetVarint(const uint8_t *&p)
+    {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            uint8_t b = *p++;
+            v |= uint64_t(b & 0x7f) << shift;
+            if (b < 0x80) break;
+        }
+        return v;
+    }
+
+    bool Fail(const std::string &what)
+    {
+        if (m_error.empty()) m_error = what;
+        m_blockRowsLeft = 0;
+        m_pos = m_end = nullptr;
+        return false;
+    }
+
+    bool ReadBlock()
+    {
+        uint32_t h[4];
+        if (!m_in->read(reinterpret_cast<char *>(h), sizeof(h)))
+        {
+            if (m_in->gcount() != 0) return Fail("truncated block header");
+            return false; // clean end of stream
+        }
+        uint32_t rawBytes = h[0], stored = h[1], rows = h[2];
+        uint8_t codec = static_cast<uint8_t>(h[3]);
+        if (rows == 0 || rawBytes > (1u << 30)) return Fail("bad block header");
+        if (!WindowStreamCodecAvailable(codec))
+        {
+            return Fail(std::string("block uses ") + WindowStreamCodecName(codec) + ", which this build lacks");
+        }
+        // Padding: one byte per value column past the end, plus the widest record head
+        size_t pad = 64 + m_kinds.size() * 10;
+        m_raw.resize(rawBytes + pad);
+        if (codec == kDwsRaw)
+        {
+            if (stored != rawBytes || !m_in->read(reinterpret_cast<char *>(m_raw.data()), stored))
+            {
+                return Fail("truncated block");
+            }
+        }
+        else
+        {
+            m_packed.resize(stored);
+            if (!m_in->read(m_packed.data(), stored)) return Fail("truncated block");
+            if (!Decompress(codec, rawBytes)) return Fail(std::string("corrupt ") + WindowStreamCodecName(codec) + " block");
+        }
+        std::memset(m_raw.data() + rawBytes, 0, pad);
+        m_pos = m_raw.data();
+        m_end = m_pos + rawBytes;
+        m_blockRowsLeft = rows;
+        m_blocks++;
+        m_haveWindow = false;
+        m_lastId = uint32_t(-1);
+        m_flows.clear();
+        m_prev.clear();
+        return true;
+    }
+
+    bool Decompress(uint8_t codec, uint32_t rawBytes)
+    {
+#ifdef DWS_WITH_ZSTD
+        if (codec == kDwsZstd)
+        {
+            if (!m_zstd) m_zstd = ZSTD_createDCtx();
+            size_t n = ZSTD_decompressDCtx(m_zstd, m_raw.data(), rawBytes, m_packed.data(), m_packed.size());
+            return !ZSTD_isError(n) && n == rawBytes;
+        }
+#endif
+#ifdef DWS_WITH_LZ4
+        if (codec == kDwsLz4)
+        {
+            int n = LZ4_decompress_safe(m_packed.data(), reinterpret_cast<char *>(m_raw.data()),
+                                        static_cast<int>(m_packed.size()), static_cast<int>(rawBytes));
+            return n >= 0 && uint32_t(n) == rawBytes;
+        }
+#endif
+        (void)codec;
+        (void)rawBytes;
+        return false;
+    }
+
+    std::ifstream m_file;
+    std::istream *m_in = nullptr;
+    std::vector<WindowStreamColumn> m_columns;
+    std::vector<uint8_t> m_kinds;
+    std::string m_error;
+    uint64_t m_blocks = 0;
+    uint64_t m_rows = 0;
+
+    // Current block
+    std::vector<uint8_t> m_raw;
+    std::vector<char> m_packed;
+    const uint8_t *m_pos = nullptr;
+    const uint8_t *m_end = nullptr;
+    uint32_t m_blockRowsLeft = 0;
+    bool m_haveWindow = false;
+    double m_timeStart = 0.0;
+    double m_timeEnd = 0.0;
+    std::vector<Flow> m_flows;
+    std::vector<uint64_t> m_prev;
+    uint32_t m_lastId = uint32_t(-1);
+#ifdef DWS_WITH_ZSTD
+    ZSTD_DCtx *m_zstd = nullptr;
+#endif
+};
+
+// CSV text exactly as the generators' std::ostream writes it (doubles at default precision 6)
+class WindowStreamCsv
+{
+  public:
+    explicit WindowStreamCsv(const std::vector<WindowStreamColumn> &columns) : m_columns(columns) {}
+
+    void AppendHeader(std::string &out) const
+    {
+        for (size_t i = 0; i < m_columns.size(); ++i)
+        {
+            if (i) out.push_back(',');
+            out += m_columns[i].name;
+        }
+        out.push_back('\n');
+    }
+
+    void AppendRow(const WindowStreamRow &r, std::string &out) const
+    {
+        size_t value = 0;
+        for (size_t i = 0; i < m_columns.size(); ++i)
+        {
+            if (i) out.push_back(',');
+            switch (m_columns[i].kind)
+            {
+            case kDwsTimeStart: AppendDouble(r.timeStart, out); break;
+            case kDwsTimeEnd: AppendDouble(r.timeEnd, out); break;
+            case kDwsConst: out += m_columns[i].value; break;
+            case kDwsSrcIp: AppendIpv4(r.src, out); break;
+            case kDwsDstIp: AppendIpv4(r.dst, out); break;
+            case kDwsSrcPort: AppendInt(r.srcPort, out); break;
+            case kDwsDstPort: AppendInt(r.dstPort, out); break;
+            case kDwsProtocol: AppendInt(r.protocol, out); break;
+            case kDwsUint: AppendUint(r.Uint(value++), out); break;
+            case kDwsInt: AppendInt(r.Int(value++), out); break;
+            default: AppendDouble(r.Float(value++), out); break;
+            }
+        }
+        out.push_back('\n');
+    }
+
+    static void AppendDouble(double v, std::string &out)
+    {
+        char buf[32];
+        // Same text as printf("%g") and std::ostream's default formatting
+        auto res = std::to_chars(buf, buf + sizeof(buf), v, std::chars_format::general, 6);
+        out.append(buf, res.ptr);
+    }
+
+    static void AppendInt(int64_t v, std::string &out)
+    {
+        char buf[24];
+        auto res = std::to_chars(buf, buf + sizeof(buf), v);
+        out.append(buf, res.ptr);
+    }
+
+    static void AppendUint(uint64_t v, std::string &out)
+    {
+        char buf[24];
+        auto res = std::to_chars(buf, buf + sizeof(buf), v);
+        out.append(buf, res.ptr);
+    }
+
+    static void AppendIpv4(uint32_t ip, std::string &out)
+    {
+        for (int shift = 24; shift >= 0; shift -= 8)
+        {
+            AppendInt((ip >> shift) & 0xff, out);
+            if (shift) out.push_back('.');
+        }
+    }
+
+  private:
+    std::vector<WindowStreamColumn> m_columns;
+};
+
+#endif // WINDOW_STREAM_H
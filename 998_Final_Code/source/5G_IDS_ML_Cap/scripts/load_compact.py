@@ -0,0 +1,101 @@
+"""Load selected partitions of a compacted dataset (tools/dataset_compact) as a DataFrame.
+
+Only the shards of matching partitions are opened, and each column is memory-mapped
+straight from the offsets in manifest.json.
+
+    from scripts.load_compact import load_partitions, load_split
+    df = load_partitions("datasets_compact", ue_total=[10, 15], transport="udp", intensity="high")
+    train = load_split("datasets_compact", "splits/split.json", "train")   # tools/dataset_split
+
+    python scripts/load_compact.py datasets_compact --ue-total 10 --attack ddos   # prints a summary
+"""
+import argparse
+import json
+import os
+
+import numpy as np
+import pandas as pd
+
+DIMENSIONS = ["ue_total", "mobility", "transport", "attack", "intensity"]
+
+
+def _matches(part, filters):
+    for dim, want in filters.items():
+        if want is None:
+            continue
+        want = want if isinstance(want, (list, tuple, set)) else [want]
+        if part[dim] not in want:
+            return False
+    return True
+
+
+def select_partitions(compact_dir, **filters):
+    with open(os.path.join(compact_dir, "manifest.json")) as f:
+        manifest = json.load(f)
+    unknown = set(filters) - set(DIMENSIONS)
+    if unknown:
+        raise ValueError(f"Unknown partition dimension(s): {sorted(unknown)}")
+    return manifest, [p for p in manifest["partitions"] if _matches(p, filters)]
+
+
+def load_shard(compact_dir, shard, columns=None):
+    path = os.path.join(compact_dir, shard["file"])
+    data = {}
+    for c in shard["columns"]:
+        if columns is not None and c["name"] not in columns and c["name"] != "run":
+            continue
+        dtype = np.dtype(c["dtype"])
+        data[c["name"]] = np.memmap(path, dtype=dtype, mode="r", offset=c["offset"],
+                                    shape=(c["bytes"] // dtype.itemsize,))
+    return data
+
+
+def load_partitions(compact_dir, columns=None, runs=None, **filters):
+    """DataFrame of every row in the matching partitions, with scenario_id restored.
+
+    runs: optional scenario_ids to keep; shards holding none of them are not opened.
+    """
+    manifest, parts = select_partitions(compact_dir, **filters)
+    wanted = None
+    if runs is not None:
+        runs = set(runs)
+        wanted = {r["run"] for r in manifest["runs"] if r["scenario_id"] in runs}
+        shards = {(r["partition"], r["shard"]) for r in manifest["runs"] if r["run"] in wanted}
+    frames = []
+    for p in parts:
+        for i, shard in enumerate(p["shards"]):
+            if wanted is not None and (p["key"], i) not in shards:
+                continue
+            cols = load_shard(compact_dir, shard, columns)
+            keep = slice(None) if wanted is None else np.isin(cols["run"], list(wanted))
+            frames.append(pd.DataFrame({k: np.asarray(v)[keep] for k, v in cols.items()}))
+    if not frames:
+        return pd.DataFrame()
+    df = pd.concat(frames, ignore_index=True)
+    scenario = np.array([r["scenario_id"] for r in manifest["runs"]], dtype=object)
+    df.insert(0, "scenario_id", scenario[df["run"].to_numpy()])
+    return df
+
+
+def load_split(compact_dir, split_json, name, columns=None, **filters):
+    """Rows of one split ("train", "val" or "test") written by tools/dataset_split."""
+    with open(split_json) as f:
+        split = json.load(f)
+    ids = [r["scenario_id"] for r in split["runs"] if r["split"] == name]
+    return load_partitions(compact_dir, columns=columns, runs=ids, **filters)
+
+
+if __name__ == "__main__":
+    ap = argparse.ArgumentParser()
+    ap.add_argument("compact_dir")
+    ap.add_argument("--ue-total", type=int, nargs="*")
+    ap.add_argument("--mobility", nargs="*")
+    ap.add_argument("--transport", nargs="*")
+    ap.add_argument("--attack", nargs="*")
+    ap.add_argument("--intensity", nargs="*")
+    args = ap.parse_args()
+    df = load_partitions(args.compact_dir, ue_total=args.ue_total, mobility=args.mobility,
+                         transport=args.transport, attack=args.attack, intensity=args.intensity)
+    print(f"{len(df)} rows, {df['scenario_id'].nunique() if len(df) else 0} runs")
+    if len(df):
+        print(df["label_binary"].value_counts().to_string())
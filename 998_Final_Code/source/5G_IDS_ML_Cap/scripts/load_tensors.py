@@ -0,0 +1,79 @@
+"""Memory-map the per-flow tensors a generator writes with --tensors (<csv>.ftns).
+
+Each flow's windows are one contiguous [windows x features] float32 matrix, so a sequence
+model reads them without parsing or a groupby. Layout: flow_tensor_writer.h in the simulator.
+
+    from scripts.load_tensors import FlowTensors
+    t = FlowTensors("dataset_10_mobile_udp_ddos_high_r1_ue10_udp_ddos.ftns")
+    x, windows, labels = t.flow(0)         # x: (windows, 12) float32
+    batch, lengths = t.padded(range(32))   # (32, max_windows, 12), zero-padded
+
+    python scripts/load_tensors.py run.ftns   # prints a summary
+"""
+import argparse
+
+import numpy as np
+
+HEADER = np.dtype([("magic", "S4"), ("version", "<u4"), ("features", "<u4"), ("reserved", "<u4"),
+                   ("flows", "<u8"), ("rows", "<u8"), ("window_s", "<f8"), ("names_offset", "<u8"),
+                   ("index_offset", "<u8"), ("data_offset", "<u8"), ("window_offset", "<u8"),
+                   ("label_offset", "<u8"), ("scenario_id", "S48")])
+INDEX = np.dtype([("first_row", "<u8"), ("src", "<u4"), ("dst", "<u4"), ("src_port", "<u2"),
+                  ("dst_port", "<u2"), ("windows", "<u4"), ("first_window", "<u4"), ("protocol", "u1"),
+                  ("any_attack", "u1"), ("pad", "<u2")])
+
+
+class FlowTensors:
+    def __init__(self, path):
+        h = np.fromfile(path, dtype=HEADER, count=1)[0]
+        if h["magic"] != b"FTNS" or h["version"] != 1:
+            raise ValueError(f"{path} is not a version 1 flow tensor file")
+        self.scenario_id = h["scenario_id"].decode()
+        self.window_s = float(h["window_s"])
+        nf, flows, rows = int(h["features"]), int(h["flows"]), int(h["rows"])
+        names = np.memmap(path, dtype="S32", mode="r", offset=int(h["names_offset"]), shape=(nf,))
+        self.feature_names = [n.decode() for n in names]
+        # np.memmap rejects a zero-length map; a run without flows gets empty arrays
+        self.index = self._map(path, INDEX, h["index_offset"], (flows,))
+        self.data = self._map(path, "<f4", h["data_offset"], (rows, nf))
+        self.windows = self._map(path, "<u4", h["window_offset"], (rows,))
+        self.labels = self._map(path, "u1", h["label_offset"], (rows, 2))
+
+    @staticmethod
+    def _map(path, dtype, offset, shape):
+        if np.prod(shape) == 0:
+            return np.zeros(shape, dtype=dtype)
+        return np.memmap(path, dtype=dtype, mode="r", offset=int(offset), shape=shape)
+
+    def __len__(self):
+        return len(self.index)
+
+    def flow(self, i):
+        """(features [windows x F], window indices, labels [windows x 2]) of flow i, as views."""
+        e = self.index[i]
+        s = slice(int(e["first_row"]), int(e["first_row"]) + int(e["windows"]))
+        return self.data[s], self.windows[s], self.labels[s]
+
+    def padded(self, flows, max_windows=None):
+        """Zero-padded batch (len(flows), T, F) and the true lengths, T = longest flow or max_windows."""
+        flows = list(flows)
+        lengths = np.array([int(self.index[i]["windows"]) for i in flows], dtype=np.int64)
+        t = int(max_windows or (lengths.max() if len(flows) else 0))
+        batch = np.zeros((len(flows), t, self.data.shape[1]), dtype=np.float32)
+        for b, i in enumerate(flows):
+            x = self.flow(i)[0][:t]
+            batch[b, :len(x)] = x
+        return batch, np.minimum(lengths, t)
+
+
+if __name__ == "__main__":
+    ap = argparse.ArgumentParser()
+    ap.add_argument("path")
+    args = ap.parse_args()
+    t = FlowTensors(args.path)
+    lengths = t.index["windows"]
+    print(f"{t.scenario_id}: {len(t)} flows, {len(t.data)} rows, {len(t.feature_names)} features, "
+          f"window {t.window_s}s")
+    if len(t):
+        print(f"windows per flow: min {lengths.min()}, median {int(np.median(lengths))}, max {lengths.max()}; "
+              f"attack flows {int(t.index['any_attack'].sum())}")
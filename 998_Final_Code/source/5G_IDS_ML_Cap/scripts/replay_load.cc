@@ -0,0 +1,558 @@
+// replay_load.cc - Replay dataset rows against the scoring service at a target rate
+// Reads the generators' datasets/*.csv, turns every row into the 28-feature Flow body that
+// service/api.py expects (derived features as in the training notebook) and posts them to
+// /score, or --batch rows at a time to /score_batch, over --connections keep-alive
+// connections.
+//
+// With --qps the arrivals are open loop: request i is due at i/qps (or at Poisson arrival
+// times with --arrival=poisson) whether or not earlier requests have returned. Latency is
+// measured from that due time, so time spent queued behind a slow response counts
+// (coordinated-omission corrected). The time from the actual send is reported as service time.
+// --qps=0 runs closed loop: every connection sends its next request as soon as the last returns.
+//
+// Build: g++ -O2 -std=c++17 -pthread -o replay_load scripts/replay_load.cc
+// Usage: ./replay_load --data=../datasets --qps=2000 --connections=32 --duration=20
+//        ./replay_load --data=../datasets --qps=200 --batch=64 --results=runs/load.json
+//        python scripts/stand_in_server.py --port 8000    # local stand-in for the service
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct Options
+{
+    std::string host = "127.0.0.1";
+    uint16_t port = 8000;
+    std::string data = "datasets";
+    uint32_t batch = 0; // 0 = one flow per request to /score
+    std::string path = "/score";
+    std::string batchPath = "/score_batch";
+    double qps = 1000.0; // 0 = closed loop
+    std::string arrival = "uniform"; // uniform|poisson
+    uint32_t connections = 16;
+    double duration = 10.0;
+    double warmup = 2.0; // seconds excluded from the statistics
+    double drain = 5.0; // give up on requests still due this long after the run ends
+    uint64_t maxRows = 50000;
+    bool shuffle = false;
+    uint64_t seed = 1;
+    std::string results;
+};
+
+static bool ParseArg(const char *arg, const char *name, std::string &value)
+{
+    size_t n = std::strlen(name);
+    if (std::strncmp(arg, "--", 2) != 0 || std::strncmp(arg + 2, name, n) != 0 || arg[2 + n] != '=') return false;
+    value = arg + 3 + n;
+    return true;
+}
+
+static Options ParseOptions(int argc, char *argv[])
+{
+    Options o;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string v;
+        if (ParseArg(argv[i], "host", v)) o.host = v;
+        else if (ParseArg(argv[i], "port", v)) o.port = static_cast<uint16_t>(std::stoul(v));
+        else if (ParseArg(argv[i], "data", v)) o.data = v;
+        else if (ParseArg(argv[i], "batch", v)) o.batch = std::stoul(v);
+        else if (ParseArg(argv[i], "path", v)) o.path = v;
+        else if (ParseArg(argv[i], "batchPath", v)) o.batchPath = v;
+        else if (ParseArg(argv[i], "qps", v)) o.qps = std::stod(v);
+        else if (ParseArg(argv[i], "arrival", v)) o.arrival = v;
+        else if (ParseArg(argv[i], "connections", v)) o.connections = std::stoul(v);
+        else if (ParseArg(argv[i], "duration", v)) o.duration = std::stod(v);
+        else if (ParseArg(argv[i], "warmup", v)) o.warmup = std::stod(v);
+        else if (ParseArg(argv[i], "drain", v)) o.drain = std::stod(v);
+        else if (ParseArg(argv[i], "maxRows", v)) o.maxRows = std::stoull(v);
+        else if (ParseArg(argv[i], "shuffle", v)) o.shuffle = v == "1" || v == "true";
+        else if (ParseArg(argv[i], "seed", v)) o.seed = std::stoull(v);
+        else if (ParseArg(argv[i], "results", v)) o.results = v;
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << "\n"
+                      << "Options: --host --port --data --batch --path --batchPath --qps --arrival --connections"
+                      << " --duration --warmup --drain --maxRows --shuffle --seed --results\n";
+            std::exit(1);
+        }
+    }
+    if (o.arrival != "uniform" && o.arrival != "poisson")
+    {
+        std::cerr << "arrival must be uniform or poisson\n";
+        std::exit(1);
+    }
+    if (o.connections == 0 || o.duration <= 0.0 || o.qps < 0.0)
+    {
+        std::cerr << "connections and duration must be positive, qps not negative\n";
+        std::exit(1);
+    }
+    return o;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Dataset rows -> Flow JSON bodies
+
+static const char *kDirectColumns[] = {
+    "time_start", "time_end", "ue_total", "src_port", "dst_port", "protocol", "packet_size", "flow_duration",
+    "total_bytes_fwd", "total_bytes_bwd", "total_pkts_fwd", "total_pkts_bwd", "pkts_per_sec", "bytes_per_sec",
+    "flow_pkts_per_sec", "flow_bytes_per_sec", "jitter_ms", "delay_ms"};
+
+struct CsvRow
+{
+    std::vector<std::string> direct; // kDirectColumns, text as written by the generator
+    std::string srcIp;
+    std::string dstIp;
+    double pktsFwd, pktsBwd, bytesFwd, bytesBwd, duration;
+    uint32_t srcPort, dstPort;
+};
+
+static std::vector<std::string> Split(const std::string &line)
+{
+    std::vector<std::string> out;
+    size_t start = 0;
+    for (size_t i = 0; i <= line.size(); ++i)
+    {
+        if (i == line.size() || line[i] == ',')
+        {
+            out.emplace_back(line, start, i - start);
+            start = i + 1;
+        }
+    }
+    return out;
+}
+
+static uint32_t IpToNumeric(const std::string &ip)
+{
+    in_addr a{};
+    if (inet_pton(AF_INET, ip.c_str(), &a) != 1) return 0;
+    return ntohl(a.s_addr);
+}
+
+static std::vector<std::string> ListCsvFiles(const std::string &spec)
+{
+    std::vector<std::string> files;
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        if (std::filesystem::is_directory(item))
+        {
+            for (const auto &e : std::filesystem::directory_iterator(item))
+            {
+                if (e.path().extension() == ".csv") files.push_back(e.path().string());
+            }
+        }
+        else if (!item.empty())
+        {
+            files.push_back(item);
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+static std::vector<CsvRow> LoadRows(const Options &o, size_t &fileCount)
+{
+    std::vector<CsvRow> rows;
+    std::vector<std::string> files = ListCsvFiles(o.data);
+    fileCount = 0;
+    for (const std::string &file : files)
+    {
+        std::ifstream in(file);
+        std::string line;
+        if (!std::getline(in, line)) continue;
+        std::vector<std::string> header = Split(line);
+        auto col = [&header](const char *name) {
+            auto it = std::find(header.begin(), header.end(), name);
+            return it == header.end() ? -1 : static_cast<int>(it - header.begin());
+        };
+        std::vector<int> direct;
+        for (const char *c : kDirectColumns) direct.push_back(col(c));
+        int srcIp = col("src_ip");
+        int dstIp = col("dst_ip");
+        if (srcIp < 0 || dstIp < 0 || std::find(direct.begin(), direct.end(), -1) != direct.end())
+        {
+            std::cerr << "Skipping " << file << ": not a dataset CSV\n";
+            continue;
+        }
+        fileCount++;
+        while (rows.size() < o.maxRows && std::getline(in, line))
+        {
+            std::vector<std::string> f = Split(line);
+            if (f.size() < header.size()) continue;
+            CsvRow r;
+            for (int c : direct) r.direct.push_back(f[c]);
+            r.srcIp = f[srcIp];
+            r.dstIp = f[dstIp];
+            r.bytesFwd = std::stod(f[direct[8]]);
+            r.bytesBwd = std::stod(f[direct[9]]);
+            r.pktsFwd = std::stod(f[direct[10]]);
+            r.pktsBwd = std::stod(f[direct[11]]);
+            r.duration = std::stod(f[direct[7]]);
+            r.srcPort = std::stoul(f[direct[3]]);
+            r.dstPort = std::stoul(f[direct[4]]);
+            rows.push_back(std::move(r));
+        }
+        if (rows.size() >= o.maxRows) break;
+    }
+    return rows;
+}
+
+static std::string FlowJson(const CsvRow &r, double srcFreq, double dstFreq)
+{
+    static const uint32_t commonPorts[] = {80, 443, 22, 21, 25, 53, 110, 143};
+    bool common = std::find(std::begin(commonPorts), std::end(commonPorts), r.dstPort) != std::end(commonPorts);
+    // pd.cut(src_port, [0, 1024, 49152, 65535]); 0 falls outside the bins
+    int portRange = r.srcPort > 49152 ? 2 : r.srcPort > 1024 ? 1 : 0;
+
+    std::ostringstream js;
+    js.precision(10);
+    js << "{";
+    for (size_t i = 0; i < r.direct.size(); ++i)
+    {
+        js << "\"" << kDirectColumns[i] << "\":" << r.direct[i] << ",";
+    }
+    js << "\"src_ip_numeric\":" << IpToNumeric(r.srcIp) << ",\"src_ip_freq\":" << srcFreq
+       << ",\"dst_ip_numeric\":" << IpToNumeric(r.dstIp) << ",\"dst_ip_freq\":" << dstFreq
+       << ",\"fwd_bwd_packets_ratio\":" << r.pktsFwd / (r.pktsBwd + 1)
+       << ",\"fwd_bwd_bytes_ratio\":" << r.bytesFwd / (r.bytesBwd + 1)
+       << ",\"avg_packet_size\":" << (r.bytesFwd + r.bytesBwd) / (r.pktsFwd + r.pktsBwd + 1)
+       << ",\"flow_duration_log\":" << std::log1p(r.duration) << ",\"is_common_port\":" << (common ? 1 : 0)
+       << ",\"port_range\":" << portRange << ",\"src_ip\":\"" << r.srcIp << "\",\"dst_ip\":\"" << r.dstIp << "\"}";
+    return js.str();
+}
+
+static std::string HttpPost(const Options &o, const std::string &path, const std::string &body)
+{
+    std::ostringstream req;
+    req << "POST " << path << " HTTP/1.1\r\nHost: " << o.host << ":" << o.port
+        << "\r\nContent-Type: application/json\r\nContent-Length: " << body.size() << "\r\n\r\n"
+        << body;
+    return req.str();
+}
+
+// Prebuilt requests, so JSON encoding is not part of the measured path
+static std::vector<std::string> BuildRequests(const Options &o, const std::vector<CsvRow> &rows)
+{
+    // ip_freq is a dataset-wide count in the notebook; here, over the replayed rows
+    std::unordered_map<std::string, uint32_t> srcCount;
+    std::unordered_map<std::string, uint32_t> dstCount;
+    for (const CsvRow &r : rows)
+    {
+        srcCount[r.srcIp]++;
+        dstCount[r.dstIp]++;
+    }
+    std::vector<std::string> flows;
+    flows.reserve(rows.size());
+    for (const CsvRow &r : rows) flows.push_back(FlowJson(r, srcCount[r.srcIp], dstCount[r.dstIp]));
+
+    std::vector<std::string> requests;
+    if (o.batch == 0)
+    {
+        for (const std::string &f : flows) requests.push_back(HttpPost(o, o.path, f));
+        return requests;
+    }
+    for (size_t start = 0; start < flows.size(); start += o.batch)
+    {
+        std::string body = "{\"flows\":[";
+        for (size_t i = 0; i < o.batch; ++i)
+        {
+            if (i) body += ",";
+            body += flows[(start + i) % flows.size()]; // the last batch wraps to stay full
+        }
+        body += "]}";
+        requests.push_back(HttpPost(o, o.batchPath, body));
+    }
+    return requests;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Keep-alive HTTP/1.1 connection
+
+class Connection
+{
+  public:
+    explicit Connection(const Options &o) : m_o(o) {}
+    ~Connection() { Close(); }
+
+    // Sends one request and reads the response; returns the HTTP status, or -1 on I/O failure
+    int RoundTrip(const std::string &request)
+    {
+        if (m_fd < 0 && !Connect()) return -1;
+        size_t off = 0;
+        while (off < request.size())
+        {
+            ssize_t w = ::send(m_fd, request.data() + off, request.size() - off, MSG_NOSIGNAL);
+            if (w <= 0)
+            {
+                Close();
+                return -1;
+            }
+            off += static_cast<size_t>(w);
+        }
+        return ReadResponse();
+    }
+
+  private:
+    bool Connect()
+    {
+        addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo *res = nullptr;
+        if (getaddrinfo(m_o.host.c_str(), std::to_string(m_o.port).c_str(), &hints, &res) != 0) return false;
+        m_fd = ::socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+        bool ok = m_fd >= 0 && ::connect(m_fd, res->ai_addr, res->ai_addrlen) == 0;
+        freeaddrinfo(res);
+        if (!ok)
+        {
+            Close();
+            return false;
+        }
+        int one = 1;
+        ::setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        m_buf.clear();
+        return true;
+    }
+
+    void Close()
+    {
+        if (m_fd >= 0) ::close(m_fd);
+        m_fd = -1;
+    }
+
+    bool Fill()
+    {
+        char tmp[16384];
+        ssize_t n = ::recv(m_fd, tmp, sizeof(tmp), 0);
+        if (n <= 0) return false;
+        m_buf.append(tmp, static_cast<size_t>(n));
+        return true;
+    }
+
+    int ReadResponse()
+    {
+        size_t end;
+        while ((end = m_buf.find("\r\n\r\n")) == std::string::npos)
+        {
+            if (!Fill())
+            {
+                Close();
+                return -1;
+            }
+        }
+        std::string head = m_buf.substr(0, end);
+        for (char &c : head) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        int status = std::atoi(head.c_str() + head.find(' ') + 1);
+        size_t cl = head.find("content-length:");
+        size_t length = cl == std::string::npos ? 0 : std::strtoul(head.c_str() + cl + 15, nullptr, 10);
+        bool close = head.find("connection: close") != std::string::npos;
+
+        while (m_buf.size() < end + 4 + length)
+        {
+            if (!Fill())
+            {
+                Close();
+                return -1;
+            }
+        }
+        m_buf.erase(0, end + 4 + length);
+        if (close) Close();
+        return status;
+    }
+
+    const Options &m_o;
+    int m_fd = -1;
+    std::string m_buf;
+};
+
+// ---------------------------------------------------------------------------------------------
+// Load loop
+
+struct WorkerResult
+{
+    std::vector<int64_t> latencyNs; // from the due time (coordinated-omission corrected)
+    std::vector<int64_t> serviceNs; // from the actual send
+    uint64_t ok = 0;
+    uint64_t errors = 0;
+    uint64_t late = 0; // due before the end but abandoned after --drain
+};
+
+static double Percentile(const std::vector<int64_t> &sorted, double q)
+{
+    if (sorted.empty()) return 0.0;
+    size_t i = static_cast<size_t>(std::ceil(q / 100.0 * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, i ? i - 1 : 0)] / 1e6;
+}
+
+int main(int argc, char *argv[])
+{
+    Options o = ParseOptions(argc, argv);
+
+    size_t fileCount = 0;
+    std::vector<CsvRow> rows = LoadRows(o, fileCount);
+    if (rows.empty())
+    {
+        std::cerr << "No dataset rows found in " << o.data << "\n";
+        return 1;
+    }
+    if (o.shuffle)
+    {
+        std::mt19937_64 rng(o.seed);
+        std::shuffle(rows.begin(), rows.end(), rng);
+    }
+    std::vector<std::string> requests = BuildRequests(o, rows);
+    std::cout << "Loaded " << rows.size() << " rows from " << fileCount << " files, " << requests.size()
+              << " distinct requests (" << (o.batch ? o.batch : 1) << " flows each)\n";
+
+    // Due times in seconds from the start, open loop only
+    double total = o.warmup + o.duration;
+    std::vector<double> due;
+    if (o.qps > 0.0)
+    {
+        std::mt19937_64 rng(o.seed);
+        std::exponential_distribution<double> gap(o.qps);
+        double t = 0.0;
+        for (uint64_t i = 0; t < total; ++i)
+        {
+            due.push_back(t);
+            t = o.arrival == "poisson" ? t + gap(rng) : (i + 1) / o.qps;
+        }
+    }
+
+    std::atomic<uint64_t> next{0};
+    std::vector<WorkerResult> results(o.connections);
+    std::vector<std::thread> workers;
+    Clock::time_point start = Clock::now() + std::chrono::milliseconds(100);
+    auto at = [start](double s) {
+        return start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(s));
+    };
+    Clock::time_point measureFrom = at(o.warmup);
+    Clock::time_point end = at(total);
+    Clock::time_point giveUp = at(total + o.drain);
+
+    for (uint32_t w = 0; w < o.connections; ++w)
+    {
+        workers.emplace_back([&, w]() {
+            Connection conn(o);
+            WorkerResult &res = results[w];
+            std::this_thread::sleep_until(start);
+            while (true)
+            {
+                uint64_t i = next.fetch_add(1, std::memory_order_relaxed);
+                Clock::time_point intended;
+                if (o.qps > 0.0)
+                {
+                    if (i >= due.size()) break;
+                    intended = at(due[i]);
+                    if (Clock::now() > giveUp)
+                    {
+                        res.late++;
+                        continue;
+                    }
+                    std::this_thread::sleep_until(intended);
+                }
+                else
+                {
+                    intended = Clock::now();
+                    if (intended >= end) break;
+                }
+
+                Clock::time_point sent = Clock::now();
+                int status = conn.RoundTrip(requests[i % requests.size()]);
+                Clock::time_point done = Clock::now();
+                if (intended < measureFrom) continue;
+                if (status != 200)
+                {
+                    res.errors++;
+                    continue;
+                }
+                res.ok++;
+                res.latencyNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(done - intended).count());
+                res.serviceNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(done - sent).count());
+            }
+        });
+    }
+    for (std::thread &t : workers) t.join();
+    double wall = std::chrono::duration<double>(Clock::now() - measureFrom).count();
+
+    WorkerResult all;
+    for (WorkerResult &r : results)
+    {
+        all.ok += r.ok;
+        all.errors += r.errors;
+        all.late += r.late;
+        all.latencyNs.insert(all.latencyNs.end(), r.latencyNs.begin(), r.latencyNs.end());
+        all.serviceNs.insert(all.serviceNs.end(), r.serviceNs.begin(), r.serviceNs.end());
+    }
+    std::sort(all.latencyNs.begin(), all.latencyNs.end());
+    std::sort(all.serviceNs.begin(), all.serviceNs.end());
+
+    // Requests finish after the measured window when the server falls behind; rate over the
+    // time it actually took so an overloaded run does not report the offered rate
+    double span = std::max(o.duration, wall);
+    double rps = all.ok / span;
+    uint32_t flowsPerRequest = o.batch ? o.batch : 1;
+    const double qs[] = {50.0, 90.0, 99.0, 99.9, 100.0};
+
+    std::printf("target      %s, %u connections, %.0f s (+%.0f s warmup)\n",
+                o.qps > 0.0 ? (std::to_string(static_cast<uint64_t>(o.qps)) + " req/s " + o.arrival).c_str()
+                            : "closed loop",
+                o.connections, o.duration, o.warmup);
+    std::printf("completed   %llu ok, %llu errors, %llu abandoned\n", static_cast<unsigned long long>(all.ok),
+                static_cast<unsigned long long>(all.errors), static_cast<unsigned long long>(all.late));
+    std::printf("throughput  %.1f req/s, %.1f flows/s\n", rps, rps * flowsPerRequest);
+    std::printf("%-12s %10s %10s %10s %10s %10s\n", "ms", "p50", "p90", "p99", "p99.9", "max");
+    std::printf("%-12s", "latency");
+    for (double q : qs) std::printf(" %10.3f", Percentile(all.latencyNs, q));
+    std::printf("\n%-12s", "service");
+    for (double q : qs) std::printf(" %10.3f", Percentile(all.serviceNs, q));
+    std::printf("\n");
+
+    if (!o.results.empty())
+    {
+        std::ofstream js(o.results);
+        js << "{\n  \"host\": \"" << o.host << ":" << o.port << "\",\n  \"endpoint\": \""
+           << (o.batch ? o.batchPath : o.path) << "\",\n  \"batch\": " << o.batch
+           << ",\n  \"qps\": " << o.qps << ",\n  \"arrival\": \"" << (o.qps > 0.0 ? o.arrival : "closed")
+           << "\",\n  \"connections\": " << o.connections << ",\n  \"duration_s\": " << o.duration
+           << ",\n  \"warmup_s\": " << o.warmup << ",\n  \"rows\": " << rows.size() << ",\n  \"ok\": " << all.ok
+           << ",\n  \"errors\": " << all.errors << ",\n  \"abandoned\": " << all.late
+           << ",\n  \"req_per_s\": " << rps << ",\n  \"flows_per_s\": " << rps * flowsPerRequest;
+        const char *names[] = {"p50", "p90", "p99", "p999", "max"};
+        for (const char *kind : {"latency_ms", "service_ms"})
+        {
+            const std::vector<int64_t> &v = std::strcmp(kind, "latency_ms") == 0 ? all.latencyNs : all.serviceNs;
+            js << ",\n  \"" << kind << "\": {";
+            for (size_t k = 0; k < 5; ++k) js << (k ? ", " : "") << "\"" << names[k] << "\": " << Percentile(v, qs[k]);
+            js << "}";
+        }
+        js << "\n}\n";
+        if (!js) std::cerr << "Could not write " << o.results << "\n";
+    }
+    return all.errors > 0 ? 2 : 0;
+}
@@ -0,0 +1,93 @@
+"""Stand-in for the scoring service, for load testing without models/ or FastAPI.
+
+Serves /health, /score and /score_batch with the same request and response shapes as
+service/api.py, but labels with the generators' rate rule (flow_pkts_per_sec > 5000).
+--delay-ms adds a fixed cost per request and --per-flow-ms a cost per flow, to emulate a model.
+
+    python scripts/stand_in_server.py --port 8000 --delay-ms 0.5
+"""
+import argparse
+import json
+import socket
+import sys
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+ATTACK_PKTS_PER_SEC = 5000.0
+
+
+def label(flow):
+    return "attack" if float(flow.get("flow_pkts_per_sec", 0.0)) > ATTACK_PKTS_PER_SEC else "benign"
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"  # keep-alive, like uvicorn
+    delay_s = 0.0
+    per_flow_s = 0.0
+
+    def setup(self):
+        super().setup()
+        # Headers and body go out in separate writes; without this Nagle holds the body
+        # until the client's delayed ACK (~40 ms per request)
+        self.connection.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+
+    def _send(self, code, obj):
+        body = json.dumps(obj).encode()
+        self.send_response(code)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def do_GET(self):
+        if self.path == "/health":
+            self._send(200, {"ok": True})
+        else:
+            self._send(404, {"detail": "Not Found"})
+
+    def do_POST(self):
+        t0 = time.perf_counter()
+        try:
+            req = json.loads(self.rfile.read(int(self.headers.get("Content-Length", 0))))
+        except ValueError:
+            self._send(422, {"detail": "invalid JSON"})
+            return
+
+        if self.path == "/score":
+            flows = [req]
+        elif self.path == "/score_batch":
+            flows = req.get("flows", [])
+        else:
+            self._send(404, {"detail": "Not Found"})
+            return
+        labels = [label(f) for f in flows]
+        time.sleep(self.delay_s + self.per_flow_s * len(flows))
+        dt_ms = (time.perf_counter() - t0) * 1000.0
+
+        if self.path == "/score":
+            self._send(200, {"label": labels[0], "confidence": 0.9 if labels[0] == "attack" else 0.1,
+                             "rule": "stand_in:rate", "latency_ms": round(dt_ms, 2)})
+        else:
+            self._send(200, {"labels": labels, "confidences": [0.9 if x == "attack" else 0.1 for x in labels],
+                             "rule": "stand_in:rate", "latency_ms": round(dt_ms, 2)})
+
+    def log_message(self, fmt, *args):
+        pass  # one line per request would dominate the cost being measured
+
+
+if __name__ == "__main__":
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--host", type=str, default="127.0.0.1")
+    ap.add_argument("--port", type=int, default=8000)
+    ap.add_argument("--delay-ms", type=float, default=0.0)
+    ap.add_argument("--per-flow-ms", type=float, default=0.0)
+    args = ap.parse_args()
+    Handler.delay_s = args.delay_ms / 1000.0
+    Handler.per_flow_s = args.per_flow_ms / 1000.0
+    srv = ThreadingHTTPServer((args.host, args.port), Handler)
+    srv.daemon_threads = True
+    print(f"[INFO] Stand-in scorer on http://{args.host}:{args.port}", file=sys.stderr)
+    try:
+        srv.serve_forever()
+    except KeyboardInterrupt:
+        pass
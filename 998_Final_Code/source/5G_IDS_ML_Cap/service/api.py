@@ -1,6 +1,7 @@
 from fastapi import FastAPI, HTTPException
 from pydantic import BaseModel, Field
 import ipaddress
+import numpy as np
 import time
 import logging
 from collections import Counter
@@ -130,3 +131,59 @@ def score(flow: Flow):
         "rule": rule,
         "latency_ms": round(dt_ms, 2)
     }
+
+
+# Batch request/response models
+class FlowBatch(BaseModel):
+    flows: list[Flow]
+
+
+class BatchScoreResponse(BaseModel):
+    labels: list[str]
+    confidences: list[float]
+    rule: str
+    latency_ms: float
+
+
+#Batch POST scoring endpoint: one model call for many flows
+@app.post("/score_batch", response_model=BatchScoreResponse)
+def score_batch(batch: FlowBatch):
+    t0 = time.perf_counter()
+    rows = [f.model_dump() for f in batch.flows]
+
+    if isinstance(scorer, MLScorer):
+        missing = [k for k in scorer.features if rows and k not in rows[0]]
+        if missing:
+            raise HTTPException(status_code=422, detail=f"Flows lack model features: {', '.join(missing)}")
+        X = np.array([[d[k] for k in scorer.features] for d in rows], dtype=float)
+        X = X.reshape(len(rows), len(scorer.features))
+        confs = scorer.predict_batch(X).tolist()
+        labels = ["attack" if c > 0.5 else "benign" for c in confs]
+        rule = "ml:lightgbm_92.6"
+    else:
+        labels, confs = [], []
+        for d in rows:
+            label, rule = scorer.predict(d)
+            labels.append(label)
+            confs.append(0.9 if label == "attack" else 0.1)
+        rule = "rules"
+
+    # ---- Metrics ----
+    dt_ms = (time.perf_counter() - t0) * 1000.0
+    stats["requests"] += 1
+    stats["flows"] += len(labels)
+    for label in labels:
+        stats[f"label_{label}"] += 1
+
+    logging.info("Batch scored -> flows=%d attack=%d latency_ms=%.2f",
+                 len(labels), labels.count("attack"), dt_ms)
+
+    # Save to CSV like /score, one row per flow; latency_ms is the whole batch's
+    csv_logger.log_many(rows, labels, confs, rule, dt_ms)
+
+    return {
+        "labels": labels,
+        "confidences": [round(c, 3) for c in confs],
+        "rule": rule,
+        "latency_ms": round(dt_ms, 2)
+    }
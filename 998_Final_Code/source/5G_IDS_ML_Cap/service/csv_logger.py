@@ -28,7 +28,7 @@ class CSVLogger:
             # fallback: empty if file not found
             return []
 
-    def log(self, flow_dict, label, confidence, rule, latency_ms):
+    def _row(self, flow_dict, label, confidence, rule, latency_ms, timestamp):
         # Start with all features, then append metadata
         row = {}
 
@@ -45,13 +45,25 @@ class CSVLogger:
             elif f == "latency_ms":
                 row[f] = round(latency_ms, 2)
             elif f == "timestamp":
-                row[f] = datetime.now().strftime("%Y-%m-%d %H:%M:%S")
+                row[f] = timestamp
             else:
                 row[f] = ""  # blank if missing
+        return row
 
+    def _write(self, rows):
         try:
             with open(self.path, "a", newline="") as f:
                 writer = csv.DictWriter(f, fieldnames=self.fields)
-                writer.writerow(row)
+                writer.writerows(rows)
         except Exception as e:
-            print(f"⚠️ CSVLogger error: {e}")
\ No newline at end of file
+            print(f"⚠️ CSVLogger error: {e}")
+
+    def log(self, flow_dict, label, confidence, rule, latency_ms):
+        timestamp = datetime.now().strftime("%Y-%m-%d %H:%M:%S")
+        self._write([self._row(flow_dict, label, confidence, rule, latency_ms, timestamp)])
+
+    def log_many(self, flow_dicts, labels, confidences, rule, latency_ms):
+        # One row per flow, same layout as log(); the file is opened once for the whole batch
+        timestamp = datetime.now().strftime("%Y-%m-%d %H:%M:%S")
+        self._write([self._row(d, label, conf, rule, latency_ms, timestamp)
+                     for d, label, conf in zip(flow_dicts, labels, confidences)])
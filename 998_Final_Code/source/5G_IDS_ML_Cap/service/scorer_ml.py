@@ -58,3 +58,9 @@ class MLScorer:
         label = "attack" if conf > 0.5 else "benign"
 
         return label, conf
+
+    def predict_batch(self, X: np.ndarray) -> np.ndarray:
+        """Attack probability per row of X (columns in self.features order), one model call."""
+        if X.shape[0] == 0:
+            return np.zeros(0)
+        return self.model.predict(self._apply_scaler(X))
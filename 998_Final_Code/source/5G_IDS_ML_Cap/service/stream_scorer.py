@@ -0,0 +1,287 @@
+# service/stream_scorer.py
+"""Live scorer for the ns-3 generators' --sinkSocket stream.
+
+Listens on a Unix socket, decodes the length-prefixed window records written by
+window_socket_sink.h, builds the same 28 features as the /score endpoint for every row
+and scores each window in one model call. At the end of a run it reports the detection
+latency: from the ATTACK_START marker (the attackers' appStart) to the first window with
+an attack verdict, in simulated seconds and in wall seconds.
+
+Run it before the generator:
+    python -m service.stream_scorer --socket /tmp/ids.sock
+    ./ns3 run "scratch/simple_ddos_dataset --sinkSocket=/tmp/ids.sock --sinkBackpressure=drop"
+
+--scorer rule uses the generator's own rate rule (flow_pkts_per_sec > 5000) instead of
+the LightGBM model, to exercise the pipeline without models/.
+"""
+import argparse
+import json
+import logging
+import os
+import socket
+import struct
+import time
+
+import numpy as np
+
+logging.basicConfig(
+    level=logging.INFO,
+    format="%(asctime)s | %(levelname)s | %(message)s"
+)
+
+PROTOCOL_VERSION = 1
+REC_HELLO, REC_ATTACK_START, REC_WINDOW, REC_END = 1, 2, 3, 4
+
+# One row as packed by WindowSocketSink::AddRow (112 bytes, little-endian)
+ROW_DTYPE = np.dtype([
+    ("src", "<u4"), ("dst", "<u4"), ("src_port", "<u2"), ("dst_port", "<u2"),
+    ("protocol", "u1"), ("label_binary", "u1"), ("label_intensity", "u1"), ("pad", "u1"),
+    ("total_bytes_fwd", "<u8"), ("total_bytes_bwd", "<u8"),
+    ("total_pkts_fwd", "<u8"), ("total_pkts_bwd", "<u8"),
+    ("packet_size", "<f8"), ("flow_duration", "<f8"),
+    ("pkts_per_sec", "<f8"), ("bytes_per_sec", "<f8"),
+    ("flow_pkts_per_sec", "<f8"), ("flow_bytes_per_sec", "<f8"),
+    ("jitter_ms", "<f8"), ("delay_ms", "<f8"),
+])
+assert ROW_DTYPE.itemsize == 112
+
+WINDOW_HEADER = struct.Struct("<ddqII")
+COMMON_PORTS = [80, 443, 22, 21, 25, 53, 110, 143]
+PORT_BINS = [1024, 49152]  # pd.cut(src_port, [0, 1024, 49152, 65535]) -> 0, 1, 2
+ATTACK_PKTS_PER_SEC = 5000.0
+
+DEFAULT_FEATURES = [
+    "time_start", "time_end", "ue_total", "src_port", "dst_port", "protocol", "packet_size",
+    "flow_duration", "total_bytes_fwd", "total_bytes_bwd", "total_pkts_fwd", "total_pkts_bwd",
+    "pkts_per_sec", "bytes_per_sec", "flow_pkts_per_sec", "flow_bytes_per_sec", "jitter_ms",
+    "delay_ms", "src_ip_numeric", "src_ip_freq", "dst_ip_numeric", "dst_ip_freq",
+    "fwd_bwd_packets_ratio", "fwd_bwd_bytes_ratio", "avg_packet_size", "flow_duration_log",
+    "is_common_port", "port_range",
+]
+
+
+class RuleScorer:
+    """The generators' labelling rule, as a stand-in model."""
+
+    def __init__(self):
+        self.features = DEFAULT_FEATURES
+        self._col = self.features.index("flow_pkts_per_sec")
+
+    def predict_batch(self, X: np.ndarray) -> np.ndarray:
+        return (X[:, self._col] > ATTACK_PKTS_PER_SEC).astype(float)
+
+
+class IpCounter:
+    """Running per-address row count, the streaming stand-in for the notebook's
+    dataset-wide groupby count."""
+
+    def __init__(self):
+        self.counts = {}
+
+    def update(self, ips: np.ndarray) -> np.ndarray:
+        uniq, inverse, n = np.unique(ips, return_inverse=True, return_counts=True)
+        totals = np.empty(len(uniq))
+        for i, (ip, c) in enumerate(zip(uniq.tolist(), n.tolist())):
+            totals[i] = self.counts[ip] = self.counts.get(ip, 0) + c
+        return totals[inverse]
+
+
+def build_features(rows, t_start, t_end, ue_total, src_freq, dst_freq, names):
+    """Feature matrix in `names` order, derived as in the training notebook."""
+    f = {k: rows[k].astype(float) for k in (
+        "src_port", "dst_port", "protocol", "packet_size", "flow_duration", "total_bytes_fwd",
+        "total_bytes_bwd", "total_pkts_fwd", "total_pkts_bwd", "pkts_per_sec", "bytes_per_sec",
+        "flow_pkts_per_sec", "flow_bytes_per_sec", "jitter_ms", "delay_ms")}
+    n = len(rows)
+    f["time_start"] = np.full(n, t_start)
+    f["time_end"] = np.full(n, t_end)
+    f["ue_total"] = np.full(n, float(ue_total))
+    f["src_ip_numeric"] = rows["src"].astype(float)
+    f["dst_ip_numeric"] = rows["dst"].astype(float)
+    f["src_ip_freq"] = src_freq.update(rows["src"])
+    f["dst_ip_freq"] = dst_freq.update(rows["dst"])
+    f["fwd_bwd_packets_ratio"] = f["total_pkts_fwd"] / (f["total_pkts_bwd"] + 1)
+    f["fwd_bwd_bytes_ratio"] = f["total_bytes_fwd"] / (f["total_bytes_bwd"] + 1)
+    f["avg_packet_size"] = (f["total_bytes_fwd"] + f["total_bytes_bwd"]) / (
+        f["total_pkts_fwd"] + f["total_pkts_bwd"] + 1)
+    f["flow_duration_log"] = np.log1p(f["flow_duration"])
+    f["is_common_port"] = np.isin(rows["dst_port"], COMMON_PORTS).astype(float)
+    sp = rows["src_port"]
+    f["port_range"] = np.where(sp == 0, 0, np.searchsorted(PORT_BINS, sp, side="left")).astype(float)
+    return np.column_stack([f[k] for k in names]) if n else np.zeros((0, len(names)))
+
+
+def percentile(values, q):
+    return float(np.percentile(values, q)) if values else None
+
+
+class RunState:
+    def __init__(self, threshold):
+        self.threshold = threshold
+        self.scenario_id = None
+        self.ue_total = 0
+        self.attackers = 0
+        self.window_s = None
+        self.attack_sim = None
+        self.attack_wall_ns = None
+        self.detect_sim = None
+        self.detect_wall_ns = None
+        self.windows = 0
+        self.rows = 0
+        self.weighted_rows = 0
+        self.lag_ms = []
+        self.score_ms = []
+        self.confusion = {"tp": 0, "fp": 0, "tn": 0, "fn": 0}
+        self.end = None
+        self.src_freq = IpCounter()
+        self.dst_freq = IpCounter()
+
+    def on_window(self, payload, scorer, recv_ns):
+        t_start, t_end, sent_ns, weight, n = WINDOW_HEADER.unpack_from(payload)
+        rows = np.frombuffer(payload, dtype=ROW_DTYPE, count=n, offset=WINDOW_HEADER.size)
+        self.lag_ms.append((recv_ns - sent_ns) / 1e6)
+
+        t0 = time.perf_counter()
+        X = build_features(rows, t_start, t_end, self.ue_total, self.src_freq, self.dst_freq, scorer.features)
+        verdict = scorer.predict_batch(X) > self.threshold
+        self.score_ms.append((time.perf_counter() - t0) * 1000.0)
+        done_ns = time.monotonic_ns()
+
+        self.windows += 1
+        self.rows += n
+        self.weighted_rows += n * weight
+        truth = rows["label_binary"] == 1
+        self.confusion["tp"] += int(np.sum(verdict & truth))
+        self.confusion["fp"] += int(np.sum(verdict & ~truth))
+        self.confusion["tn"] += int(np.sum(~verdict & ~truth))
+        self.confusion["fn"] += int(np.sum(~verdict & truth))
+
+        # Only verdicts on windows that end after the attack started count as detection
+        if (self.detect_sim is None and self.attack_sim is not None and t_end > self.attack_sim
+                and verdict.any()):
+            self.detect_sim = t_end
+            self.detect_wall_ns = done_ns
+            logging.info(f"🚨 First attack verdict in window [{t_start:g}, {t_end:g}] "
+                         f"({int(verdict.sum())} of {n} flows)")
+
+    def summary(self):
+        c = self.confusion
+        out = {
+            "scenario_id": self.scenario_id,
+            "ue_total": self.ue_total,
+            "attackers": self.attackers,
+            "window_s": self.window_s,
+            "windows_scored": self.windows,
+            "rows_scored": self.rows,
+            "rows_weighted": self.weighted_rows,
+            "attack_start_sim_s": self.attack_sim,
+            "first_attack_verdict_sim_s": self.detect_sim,
+            "detection_latency_sim_s": None,
+            "detection_latency_wall_s": None,
+            "transport_lag_ms_p50": percentile(self.lag_ms, 50),
+            "transport_lag_ms_p99": percentile(self.lag_ms, 99),
+            "score_ms_p50": percentile(self.score_ms, 50),
+            "score_ms_p99": percentile(self.score_ms, 99),
+            "confusion": c,
+            "recall": c["tp"] / (c["tp"] + c["fn"]) if c["tp"] + c["fn"] else None,
+            "precision": c["tp"] / (c["tp"] + c["fp"]) if c["tp"] + c["fp"] else None,
+        }
+        if self.detect_sim is not None:
+            out["detection_latency_sim_s"] = self.detect_sim - self.attack_sim
+            out["detection_latency_wall_s"] = (self.detect_wall_ns - self.attack_wall_ns) / 1e9
+        if self.end is not None:
+            out["sim_end_s"], out["windows_total"], out["windows_dropped"], out["rows_sampled_out"] = self.end
+        return out
+
+
+def read_exact(conn, n):
+    buf = bytearray()
+    while len(buf) < n:
+        chunk = conn.recv(n - len(buf))
+        if not chunk:
+            return None
+        buf += chunk
+    return bytes(buf)
+
+
+def serve_one(conn, scorer, threshold):
+    state = RunState(threshold)
+    while True:
+        head = read_exact(conn, 4)
+        if head is None:
+            logging.warning("⚠️ Generator disconnected before END")
+            break
+        (length,) = struct.unpack("<I", head)
+        body = read_exact(conn, length)
+        if body is None:
+            logging.warning("⚠️ Truncated record")
+            break
+        recv_ns = time.monotonic_ns()
+        kind, payload = body[0], body[1:]
+
+        if kind == REC_HELLO:
+            version, state.ue_total, state.attackers, state.window_s, n = struct.unpack_from("<HIIdH", payload)
+            if version != PROTOCOL_VERSION:
+                raise ValueError(f"Unsupported sink protocol version {version}")
+            state.scenario_id = payload[20:20 + n].decode()
+            logging.info(f"📡 Run {state.scenario_id}: {state.ue_total} UEs, {state.attackers} attackers, "
+                         f"{state.window_s:g} s windows")
+        elif kind == REC_ATTACK_START:
+            state.attack_sim, state.attack_wall_ns = struct.unpack_from("<dq", payload)
+            logging.info(f"⏱️ Attack starts at t={state.attack_sim:g} s")
+        elif kind == REC_WINDOW:
+            state.on_window(payload, scorer, recv_ns)
+        elif kind == REC_END:
+            state.end = struct.unpack_from("<dQQQ", payload)
+            break
+        else:
+            raise ValueError(f"Unknown record type {kind}")
+    return state.summary()
+
+
+def make_scorer(args):
+    if args.scorer == "rule":
+        return RuleScorer()
+    from .scorer_ml import MLScorer
+    return MLScorer(model_path=args.model, scaler_json_path=args.scaler, features_path=args.features)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--socket", default="/tmp/ids.sock")
+    ap.add_argument("--scorer", choices=["ml", "rule"], default="ml")
+    ap.add_argument("--model", default="models/lightgbm_92.6.txt")
+    ap.add_argument("--scaler", default="models/scaler_params.json")
+    ap.add_argument("--features", default="models/features.txt")
+    ap.add_argument("--threshold", type=float, default=0.5)
+    ap.add_argument("--summary", help="write each run's summary as JSON lines to this file")
+    ap.add_argument("--loop", action="store_true", help="keep serving runs until interrupted")
+    args = ap.parse_args()
+
+    scorer = make_scorer(args)
+    if os.path.exists(args.socket):
+        os.unlink(args.socket)
+    srv = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    srv.bind(args.socket)
+    srv.listen(1)
+    logging.info(f"✅ Listening on {args.socket} (scorer={args.scorer})")
+    try:
+        while True:
+            conn, _ = srv.accept()
+            with conn:
+                summary = serve_one(conn, scorer, args.threshold)
+            print(json.dumps(summary, indent=2))
+            if args.summary:
+                with open(args.summary, "a") as f:
+                    f.write(json.dumps(summary) + "\n")
+            if not args.loop:
+                break
+    except KeyboardInterrupt:
+        pass
+    finally:
+        srv.close()
+        os.unlink(args.socket)
+
+
+if __name__ == "__main__":
+    main()